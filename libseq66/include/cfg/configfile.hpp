@@ -36,7 +36,9 @@
  */
 
 #include <fstream>                      /* std::streampos                   */
+#include <map>                          /* std::map<> for the line index    */
 #include <string>                       /* std::string, the ubiquitous one  */
+#include <vector>                       /* std::vector<> for the line index */
 
 #include "util/basic_macros.hpp"        /* seq66::tokenization vector       */
 #include "util/strfunctions.hpp"        /* seq66::string_to_int()           */
@@ -159,6 +161,68 @@ private:
 
     std::string m_file_version;
 
+    /**
+     *  One line of the file as get_line() returns it (trimmed and stripped
+     *  of comments), plus the position of the line in the file.
+     */
+
+    struct indexline
+    {
+        std::streampos il_pos;
+        std::string il_text;
+    };
+
+    /**
+     *  The stream that the line index was built from.  The index is built
+     *  the first time get_variable(), line_after(), or find_tag() is called
+     *  on a stream, so that the dozens to hundreds of lookups made while
+     *  parsing a file do not each rescan the file from the beginning.  It is
+     *  dropped by set_up_ifstream(), write_seq66_header(), and name(), and
+     *  by index_clear() at the end of the parse() functions that do not call
+     *  set_up_ifstream(), since the next stream may reuse this address.
+     */
+
+    const std::ifstream * m_index_stream;
+
+    /**
+     *  The lines of the file, in order.  Only the lines that get_line() reads
+     *  successfully are included; m_index_tail is the position after them.
+     */
+
+    std::vector<indexline> m_index_lines;
+
+    /**
+     *  The position of the end of the last complete line.
+     */
+
+    std::streampos m_index_tail;
+
+    /**
+     *  Maps the text of each section line (starting with "[") to the indices
+     *  of the lines holding it, in file order.
+     */
+
+    std::map<std::string, std::vector<int>> m_index_tags;
+
+    /**
+     *  The data lines of one section: for each variable name, the indices of
+     *  the lines assigning it, and the index of the line ending the section
+     *  (the next section line, or the line count).
+     */
+
+    struct indexsection
+    {
+        int is_end;
+        std::map<std::string, std::vector<int>> is_vars;
+    };
+
+    /**
+     *  Maps the index of a section line to its data lines.  Filled in as
+     *  sections are queried.
+     */
+
+    std::map<int, indexsection> m_index_sections;
+
 protected:
 
     /**
@@ -222,6 +286,7 @@ public:
     void name (const std::string & n)
     {
         m_name = n;
+        index_clear();
     }
 
     const std::string & version () const
@@ -267,6 +332,7 @@ public:
 protected:
 
     bool set_up_ifstream (std::ifstream & instream);
+    void index_clear ();
 
     static void append_error_message (const std::string & msg);
     static bool make_error_message
@@ -446,6 +512,15 @@ protected:
         const std::string & commenttext
     );
 
+private:
+
+    bool index_stream (std::ifstream & file);
+    int index_find_line (std::streampos position) const;
+    int index_find_tag (const std::string & tag, int startline) const;
+    const indexsection & index_section (int header);
+    void index_seek (std::ifstream & file, int lineindex, int startline);
+    void index_seek_end (std::ifstream & file, int startline);
+
 };          // class configfile
 
 /*
@@ -273,6 +273,8 @@ private:
     bool m_jack_auto_connect;       /**< Connect JACK ports in normal mode. */
     bool m_jack_use_offset;         /**< Try to calculate output offset.    */
     int m_jack_buffer_size;         /**< The desired power-of-2 size, or 0. */
+    int m_jack_lookahead;           /**< JACK output lookahead, in periods. */
+    int m_alsa_lookahead;           /**< ALSA queue output lookahead, ms.   */
     sequence::playback m_song_start_mode; /**< Song mode versus Live mode.  */
     bool m_song_start_is_auto;      /**< True if "auto" read from 'rc'.     */
     bool m_filter_by_channel;       /**< Record only sequence channel data. */
@@ -797,6 +799,16 @@ public:
         return m_jack_buffer_size;
     }
 
+    int jack_lookahead () const
+    {
+        return m_jack_lookahead;
+    }
+
+    int alsa_lookahead () const
+    {
+        return m_alsa_lookahead;
+    }
+
     bool song_start_mode () const
     {
         return m_song_start_mode == sequence::playback::song;
@@ -864,6 +876,28 @@ public:
             m_jack_buffer_size = sz;
     }
 
+    /*
+     * Zero disables the lookahead.  More than a few periods simply adds
+     * latency to no purpose.
+     */
+
+    void jack_lookahead (int periods)
+    {
+        if (periods >= 0 && periods <= 4)
+            m_jack_lookahead = periods;
+    }
+
+    /*
+     * Zero sends ALSA output directly, as always.  Otherwise, events are
+     * scheduled on the ALSA queue this many milliseconds ahead.
+     */
+
+    void alsa_lookahead (int ms)
+    {
+        if (ms >= 0 && ms <= 100)
+            m_alsa_lookahead = ms;
+    }
+
     /**
      * \getter m_with_jack_transport m_with_jack_master, and
      * m_with_jack_master_cond, to save client code some trouble.  Do not
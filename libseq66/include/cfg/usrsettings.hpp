@@ -768,6 +768,15 @@ private:
 
     std::string m_user_option_logfile;
 
+    /**
+     *  If not empty, seq66cli renders the song offline to this MIDI file,
+     *  via performer::render_song(), and exits, instead of running.  This
+     *  file is specified only by the "-o render=filename" option, and is not
+     *  saved.
+     */
+
+    std::string m_user_option_render;
+
     /**
      *  The full path to PDF and browser executables, in case the system
      *  defaults are not present or are not suitable.
@@ -859,6 +868,23 @@ private:
 
     bool m_lock_main_window;
 
+    /**
+     *  If true, the live grid draws all of its slots on one canvas, from
+     *  cached pattern thumbnails, instead of using one push-button widget
+     *  per slot.  Cheaper for large grids of busy patterns.
+     */
+
+    bool m_grid_canvas;
+
+    /**
+     *  The approximate maximum memory, in megabytes, for the undo/redo
+     *  journal of each pattern's events and triggers, including the one copy
+     *  of them that the journal keeps.  When exceeded, the oldest undo steps
+     *  are dropped.  Zero means no limit.
+     */
+
+    int m_undo_limit;
+
     /**
      *  [user-session]
      *
@@ -1528,6 +1554,11 @@ public:
         return m_user_option_logfile;
     }
 
+    const std::string & option_render () const
+    {
+        return m_user_option_render;
+    }
+
     const std::string & user_pdf_viewer () const
     {
         return m_user_pdf_viewer;
@@ -1608,6 +1639,21 @@ public:
         return m_lock_main_window;
     }
 
+    int undo_limit () const
+    {
+        return m_undo_limit;
+    }
+
+    bool grid_canvas () const
+    {
+        return m_grid_canvas;
+    }
+
+    std::size_t undo_limit_bytes () const
+    {
+        return std::size_t(m_undo_limit) * 1024 * 1024;
+    }
+
     session session_manager () const
     {
         return m_session_manager;
@@ -1775,6 +1821,8 @@ public:         // used in main application module and the usrfile class
         m_lock_main_window = flag;
     }
 
+    void undo_limit (int megabytes);
+
     /*
      * Not yet part of Edit / Preferences.
      */
@@ -1804,6 +1852,11 @@ public:         // used in main application module and the usrfile class
     void option_use_logfile (bool flag);
     void option_logfile (const std::string & file);
 
+    void option_render (const std::string & file)
+    {
+        m_user_option_render = file;
+    }
+
     /*
      *  Since these a paths to executable, probably good to provide a full
      *  path, for now we will not enforce that.
@@ -1852,6 +1905,11 @@ public:         // used in main application module and the usrfile class
         m_progress_box_shown = flag;
     }
 
+    void grid_canvas (bool flag)
+    {
+        m_grid_canvas = flag;
+    }
+
     void in_nsm_session (bool f)
     {
         m_in_nsm_session = f;
@@ -39,6 +39,7 @@
 
 #include <map>                          /* std::map<> and multimap<>        */
 #include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<>                    */
 
 #include "cfg/comments.hpp"             /* seq66::comments class            */
 #include "ctrl/midicontrol.hpp"         /* seq66::midicontrol event item    */
@@ -52,6 +53,8 @@ namespace seq66
 {
 
 class keycontainer;
+class midioperation;
+class opcontainer;
 
 /**
  *  Provides an object specifying what a keystroke, GUI action, or a MIDI
@@ -75,6 +78,43 @@ public:
 
     using mccontainer = std::multimap<midicontrol::key, midicontrol>;
 
+    /**
+     *  Provides one compiled entry of the dispatch table.  It holds a copy of
+     *  the values of the midicontrol that are needed to make the call, plus a
+     *  direct pointer to the operation, so that an incoming event needs
+     *  neither the multimap search nor the opcontainer search.
+     */
+
+    class dispatch
+    {
+    public:
+
+        const midioperation * dp_operation;
+        automation::action dp_action;
+        int dp_d0;
+        int dp_d1;
+        int dp_index;
+        midibyte dp_min_d1;
+        midibyte dp_max_d1;
+        bool dp_inverse;
+
+        bool in_range (midibyte d1) const
+        {
+            return d1 >= dp_min_d1 && d1 <= dp_max_d1;
+        }
+    };
+
+private:
+
+    /**
+     *  The dispatch table is indexed by [status - 0x80][d0], and holds the
+     *  index of the entry in m_dispatch_list, or -1 if there is no control
+     *  for that status and d0.
+     */
+
+    using dispatchindex = std::vector<short>;
+    using dispatchlist = std::vector<dispatch>;
+
 private:
 
     /**
@@ -116,6 +156,20 @@ private:
 
     bool m_have_controls;
 
+    /**
+     *  The flat [status][d0] table built by compile() from the container and
+     *  the performer's operations.  It is empty until compile() is called,
+     *  and is emptied by any change to the container.
+     */
+
+    dispatchindex m_dispatch_index;
+
+    /**
+     *  The compiled controls referred to by m_dispatch_index.
+     */
+
+    dispatchlist m_dispatch_list;
+
 public:
 
     midicontrolin (const std::string & name);
@@ -139,6 +193,7 @@ public:
     void clear ()
     {
         m_container.clear();
+        decompile();
     }
 
     int count () const
@@ -159,6 +214,20 @@ public:
     bool add (const midicontrol & mc);
     void add_blank_controls (const keycontainer & kc);
     const midicontrol & control (const midicontrol::key & k) const;
+    void compile (const opcontainer & ops);
+    const dispatch * lookup (const event & ev) const;
+
+    bool compiled () const
+    {
+        return ! m_dispatch_index.empty();
+    }
+
+    void decompile ()
+    {
+        m_dispatch_index.clear();
+        m_dispatch_list.clear();
+    }
+
     std::string status_string () const;
 
     bool inactive_allowed () const
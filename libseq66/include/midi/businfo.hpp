@@ -327,6 +327,8 @@ public:
 
     void play (bussbyte bus, const event * e24, midibyte channel);
     void sysex (bussbyte bus, const event * ev);
+    int panic (int displaybuss);
+    int active_note_count () const;
     bool set_clock (bussbyte bus, e_clock clocktype);
 
     /**
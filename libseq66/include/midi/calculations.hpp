@@ -196,6 +196,10 @@ extern std::string pulses_to_time_string
 (
     midipulse pulses, midibpm bpm, int ppqn, bool showus = true
 );
+extern std::string microseconds_to_time_string
+(
+    double microseconds, bool showus = true
+);
 extern int pulses_to_hours (midipulse pulses, midibpm bpm, int ppqn);
 extern midipulse measurestring_to_pulses
 (
@@ -72,6 +72,9 @@ namespace seq66
  *  locally and twice when the note is sent back from the computer to your
  *  keyboard.
  *
+ *  All Sound Off 120: Mutes all sound at once, ignoring release times and
+ *  the sustain pedal.
+ *
  *  All Notes Off 123: Mutes all sounding notes. Release time will be
  *  maintained, and notes held by sustain will not turn off until sustain pedal
  *  is depressed.
@@ -152,6 +155,7 @@ enum class cc
      * 102 – 119 Undefined.
      */
 
+    all_sound_off     = 120, /**< Mutes all sound at once. See notes.        */
     reset_all         = 121, /**< Reset all controllers to their default.    */
     local_switch      = 122, /**< Switches internal connection of a device.  */
     all_notes_off     = 123, /**< Mutes all sounding notes. See notes.       */
@@ -47,6 +47,7 @@
  *      -   Meta messages. 0xFF is the flag, followed by type, length, and data.
  */
 
+#include <memory>                       /* std::shared_ptr<> for SysEx data */
 #include <string>                       /* used in to_string()              */
 #include <vector>                       /* SYSEX data stored in vector      */
 
@@ -367,6 +368,13 @@ private:
 
     midibyte m_data[SEQ66_MIDI_DATA_BYTE_COUNT];
 
+    /**
+     *  An empty buffer, returned by get_sysex() for events without SysEx or
+     *  Meta data.
+     */
+
+    static const sysex sm_no_sysex;
+
     /**
      *  The data buffer for SYSEX messages.  Adapted from Stazed's Seq32
      *  project on GitHub.
@@ -377,9 +385,14 @@ private:
      *  for Meta events.  Compare is_sysex() to is_meta() and is_ex_data()
      *  [which tests for both]. In addition, detect and handle the other
      *  Meta message that hold variable amounts of bytes.
+     *
+     *  The buffer is shared by the copies of the event, and is copied only
+     *  when one of them changes it (see sysex_data()).  Copying an event list
+     *  for undo, the clipboard, or a snapshot thus allocates nothing for
+     *  SysEx and Meta events.  Null if the event has no such data.
      */
 
-    sysex m_sysex;
+    std::shared_ptr<sysex> m_sysex;
 
     /**
      *  This event is used to link NoteOns and NoteOffs together.  The NoteOn
@@ -440,6 +453,8 @@ public:
     );
     event (const event & rhs);
     event & operator = (const event & rhs);
+    event (event && rhs) noexcept = default;
+    event & operator = (event && rhs) noexcept = default;
     virtual ~event ();
 
     /*
@@ -449,7 +464,12 @@ public:
 
     bool operator < (const event & rhsevent) const;
     bool match (const event & target) const;
+    bool same (const event & rhs) const;
     void prep_for_send (midipulse tick, const event & source);
+    void prep_for_send
+    (
+        midipulse tick, midibyte status, midibyte d0, midibyte d1
+    );
 
     void set_input_bus (bussbyte b)
     {
@@ -1032,27 +1052,40 @@ public:
 
     void reset_sysex ()
     {
-        m_sysex.clear();
+        m_sysex.reset();
     }
 
+    /**
+     *  Use this version only to modify the data; it unshares the buffer.
+     */
+
     sysex & get_sysex ()
     {
-        return m_sysex;
+        return sysex_data();
     }
 
     const sysex & get_sysex () const
     {
-        return m_sysex;
+        return m_sysex ? *m_sysex : sm_no_sysex ;
     }
 
     midibyte get_sysex (size_t i) const
     {
-        return m_sysex[i];
+        return get_sysex()[i];
     }
 
     int sysex_size () const
     {
-        return int(m_sysex.size());
+        return m_sysex ? int(m_sysex->size()) : 0 ;
+    }
+
+    /**
+     *  True if another copy of the event holds the same SysEx/Meta buffer.
+     */
+
+    bool sysex_shared () const
+    {
+        return m_sysex && m_sysex.use_count() > 1;
     }
 
     /**
@@ -1465,6 +1498,10 @@ public:
     int get_rank () const;
     void rescale (int newppqn, int oldppqn);
 
+private:
+
+    sysex & sysex_data ();
+
 };          // class event
 
 /*
@@ -1473,6 +1510,23 @@ public:
 
 extern event create_tempo_event (midipulse tick, midibpm tempo);
 
+/**
+ *  Lets the undo journal (undojournal<event>) count the SysEx and Meta
+ *  data of an event against its limit.  The buffer is shared by copies of
+ *  the event, so it is counted only when this copy is its sole holder;
+ *  a buffer shared by the live events and the journal costs the journal
+ *  nothing.  The flip side is that a buffer shared only by journal entries
+ *  is not counted at all, so this is a lower bound.  It lives beside event,
+ *  so that argument-dependent lookup finds it wherever undojournal<event>
+ *  is instantiated, not only where sequence.hpp is included.
+ */
+
+inline std::size_t
+undo_heap_bytes (const event & e)
+{
+    return e.sysex_shared() ? 0 : std::size_t(e.sysex_size()) ;
+}
+
 }           // namespace seq66
 
 #endif      // SEQ66_EVENT_HPP
@@ -264,8 +264,13 @@ public:
     bool is_playable () const;
     midipulse get_min_timestamp () const;
     midipulse get_max_timestamp () const;
+    static event::const_iterator lower_bound
+    (
+        const event::buffer & evs, midipulse tick
+    );
     bool add (const event & e);
     bool append (const event & e);
+    bool merge_sorted (event::buffer & evlist);
 
     bool empty () const
     {
@@ -365,6 +370,7 @@ private:                                /* internal quantization functions  */
 
     bool add (event::buffer & evlist, const event & e);
     void merge (const event::buffer & evlist);
+    void note_flags (const event & e);
 
 private:                                /* functions for friend sequence    */
 
@@ -373,12 +379,11 @@ private:                                /* functions for friend sequence    */
      * involved data from the caller.
      */
 
-    void link_new (bool wrap = false);
+    void link_new (bool wrap = false, std::size_t start = 0);
+    void relink_from (std::size_t first);
     void clear_links ();
     int note_count () const;
-#if defined SEQ66_USE_FILL_TIME_SIG_AND_TEMPO
     void scan_meta_events ();
-#endif
     void verify_and_link (midipulse slength = 0, bool wrap = false);
     bool edge_fix (midipulse snap, midipulse seqlength);
     bool remove_unlinked_notes ();
@@ -404,6 +409,18 @@ private:                                /* functions for friend sequence    */
     bool randomize_selected_notes (int jitter, int range);
     bool jitter_notes (int jitter);
     bool link_notes (event::iterator eon, event::iterator eoff);
+
+    /**
+     *  The index of the (channel, note) pair of a note event, used in
+     *  link_new().
+     */
+
+    static int link_key (const event & e)
+    {
+        return int(e.channel() & 0x0F) * c_midibyte_data_max +
+            int(e.get_note() & 0x7F);
+    }
+
     void link_tempos ();
     void clear_tempo_links ();
     bool mark_selected ();
@@ -465,6 +482,16 @@ private:                                /* functions for friend sequence    */
         return m_events;
     }
 
+    /**
+     *  Writable access for the undo journal, which replaces only the changed
+     *  range of events.  The caller must then relink and rescan the events.
+     */
+
+    event::buffer & events ()
+    {
+        return m_events;
+    }
+
     void set_length (midipulse len)
     {
         if (len > 0)
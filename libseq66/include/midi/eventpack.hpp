@@ -0,0 +1,250 @@
+#if ! defined SEQ66_EVENTPACK_HPP
+#define SEQ66_EVENTPACK_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          eventpack.hpp
+ *
+ *  This module declares a compact, read-only copy of the events of a
+ *  pattern, used for playback.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  The event class is built for editing:  it holds a SysEx vector, a link
+ *  iterator, the selection flags, and the input buss, so that it spans most
+ *  of a cache line.  Playback only needs the timestamp, the status, and the
+ *  data bytes, so sequence publishes its events in this packed form, and
+ *  play() scans 16 bytes per event instead.
+ */
+
+#include <cstdint>                      /* std::uint32_t                    */
+#include <memory>                       /* std::shared_ptr<>                */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midi/event.hpp"               /* seq66::event, event::buffer      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Holds the events of a pattern as a timestamp-sorted array of small
+ *  records, built from the editable event list each time it changes.  The
+ *  payloads of SysEx and Meta events are appended to one side buffer, and
+ *  the record holds the index of its payload.  Once built, an eventpack is
+ *  never modified, so the output thread can read it without locking.
+ */
+
+class eventpack
+{
+
+public:
+
+    using pointer = std::shared_ptr<const eventpack>;
+
+    /**
+     *  The playback form of an event.  The data bytes are 7-bit, so bit 7 of
+     *  r_d0 is free to mark a Note On that is linked to a Note Off.  For
+     *  SysEx and Meta events, r_channel holds the Meta type, as in the event
+     *  class, and r_payload is the index of the payload.
+     */
+
+    class record
+    {
+        friend class eventpack;
+
+    private:
+
+        midipulse r_tick;
+        midibyte r_status;
+        midibyte r_channel;
+        midibyte r_d0;
+        midibyte r_d1;
+        std::uint32_t r_payload;
+
+    public:
+
+        midipulse timestamp () const
+        {
+            return r_tick;
+        }
+
+        midibyte get_status () const
+        {
+            return r_status;
+        }
+
+        midibyte channel () const
+        {
+            return r_channel;
+        }
+
+        midibyte d0 () const
+        {
+            return r_d0 & EVENT_DATA_MASK;
+        }
+
+        midibyte d1 () const
+        {
+            return r_d1;
+        }
+
+        bool is_note () const
+        {
+            return event::is_note_msg(r_status);
+        }
+
+        bool is_note_on () const
+        {
+            return event::mask_status(r_status) == EVENT_NOTE_ON;
+        }
+
+        bool is_note_off () const
+        {
+            return event::mask_status(r_status) == EVENT_NOTE_OFF;
+        }
+
+        bool is_note_on_linked () const
+        {
+            return is_note_on() && (r_d0 & c_linked_bit) != 0;
+        }
+
+        bool is_ex_data () const
+        {
+            return event::is_ex_data_msg(r_status);
+        }
+
+        bool is_tempo () const
+        {
+            return event::is_meta_msg(r_status) &&
+                r_channel == EVENT_META_SET_TEMPO;
+        }
+    };
+
+    using records = std::vector<record>;
+    using const_iterator = records::const_iterator;
+
+private:
+
+    /**
+     *  Marks a linked Note On in the otherwise unused top bit of r_d0.
+     */
+
+    static const midibyte c_linked_bit = 0x80;
+
+    /**
+     *  Where a payload lives in m_payload_bytes.
+     */
+
+    class span
+    {
+    public:
+
+        std::uint32_t s_offset;
+        std::uint32_t s_size;
+    };
+
+    /**
+     *  The events, in the order of the event list, which is sorted by
+     *  timestamp.
+     */
+
+    records m_records;
+
+    /**
+     *  The SysEx and Meta payloads, indexed by record::r_payload, and the
+     *  bytes that they point into.
+     */
+
+    std::vector<span> m_payloads;
+    midibytes m_payload_bytes;
+
+public:
+
+    eventpack () = default;
+    explicit eventpack (const event::buffer & evs);
+    eventpack (const eventpack &) = default;
+    eventpack & operator = (const eventpack &) = default;
+    ~eventpack () = default;
+
+    bool empty () const
+    {
+        return m_records.empty();
+    }
+
+    std::size_t size () const
+    {
+        return m_records.size();
+    }
+
+    const_iterator cbegin () const
+    {
+        return m_records.cbegin();
+    }
+
+    const_iterator cend () const
+    {
+        return m_records.cend();
+    }
+
+    const_iterator begin () const
+    {
+        return m_records.cbegin();
+    }
+
+    const_iterator end () const
+    {
+        return m_records.cend();
+    }
+
+    const record & back () const
+    {
+        return m_records.back();
+    }
+
+    const_iterator lower_bound (midipulse tick) const;
+    const midibyte * payload (const record & r) const;
+    int payload_size (const record & r) const;
+    midibpm tempo (const record & r) const;
+    void unpack
+    (
+        const record & r, midipulse tick,
+        event & evout, int transpose = 0
+    ) const;
+
+};          // class eventpack
+
+}           // namespace seq66
+
+#endif      // SEQ66_EVENTPACK_HPP
+
+/*
+ * eventpack.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -60,6 +60,33 @@ namespace seq66
 class mastermidibase
 {
 
+public:
+
+    /**
+     *  An event captured instead of being sent to an output buss, along with
+     *  the buss and channel it was meant for.  Used by the performer's
+     *  offline render of the song.
+     */
+
+    class capture
+    {
+    public:
+
+        bussbyte cp_bus;
+        midibyte cp_channel;
+        event cp_event;
+
+        capture (bussbyte bus, midibyte channel, const event & ev) :
+            cp_bus      (bus),
+            cp_channel  (channel),
+            cp_event    (ev)
+        {
+            // no code
+        }
+    };
+
+    using capturelist = std::vector<capture>;
+
     friend class performer;
     friend class midi_alsa_info;
 
@@ -163,12 +190,20 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  If not null, play(), play_and_flush(), and sysex() append the events
+     *  to this list instead of sending them to the output busses.  Set only
+     *  while the performer renders the song offline.
+     */
+
+    capturelist * m_capture;
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
      *  lends exception-safety to the mutex locking.
      */
 
-    recmutex m_mutex;
+    mutable recmutex m_mutex;
 
 public:
 
@@ -252,13 +287,16 @@ public:
     void play (bussbyte bus, event * e24, midibyte channel);
     void play_and_flush (bussbyte bus, event * e24, midibyte channel);
     void sysex (bussbyte bus, const event * event);
+    void capture_output (capturelist * cl);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void emit_clock (midipulse tick);
     void print () const;
     void flush ();
     void panic (int displaybuss = c_bussbyte_max);          /* kepler34 func  */
+    int active_note_count () const;
     void dump_midi_input (event in);                        /* seq32 function */
+    void merge_recorded_input ();
     std::string get_midi_bus_name (bussbyte bus, midibase::io iotype) const;
 
     void set_midi_alias
@@ -282,6 +320,7 @@ public:
     int poll_for_midi ();
     bool set_sequence_input (bool state, sequence * seq);
     bool is_more_input ();
+    void wake_input ();
 
     /**
      *  Grab a MIDI event via the currently-selected MIDI API.
@@ -425,6 +464,16 @@ protected:
     virtual bool api_get_midi_event (event * inev) = 0;
     virtual int api_poll_for_midi ();
 
+    /**
+     *  Provides MIDI API-specific functionality for the wake_input()
+     *  function.
+     */
+
+    virtual void api_wake_input ()
+    {
+        // no code for base or portmidi; their poll does not block
+    }
+
 /*
  *  So far, there is no need for these API-specific functions.
  *
@@ -138,6 +138,16 @@ public:
         return result;
     }
 
+    /**
+     *  Provides direct access to the bytes, so that midifile can copy the
+     *  whole track at once instead of calling get() for each byte.
+     */
+
+    const midibyte * data () const
+    {
+        return m_char_vector.data();
+    }
+
     /**
      *  Provides a way to clear the container.
      */
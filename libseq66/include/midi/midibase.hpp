@@ -35,6 +35,9 @@
  *  base class for all such classes.
  */
 
+#include <array>                        /* std::array<>                     */
+#include <bitset>                       /* std::bitset<>                    */
+
 #include "midi/midibus_common.hpp"      /* values and e_clock enumeration   */
 #include "midi/midibytes.hpp"           /* seq66::midibyte alias            */
 #include "util/automutex.hpp"           /* seq66::recmutex recursive mutex  */
@@ -234,11 +237,21 @@ private:
 
     port m_port_type;
 
+    /**
+     *  The notes that have been sent to this (output) buss by play() and not
+     *  yet turned off, one bit per note and channel.  This lets panic()
+     *  send only the Note Offs that are needed, instead of 2048 of them.
+     *  Protected by m_mutex.
+     */
+
+    std::array<std::bitset<c_midibyte_data_max>, c_midichannel_max>
+        m_active_notes;
+
     /**
      *  Locking mutex. This one is based on std:::recursive_mutex.
      */
 
-    recmutex m_mutex;
+    mutable recmutex m_mutex;
 
 public:
 
@@ -500,6 +513,8 @@ public:
     void play (const event * e24, midibyte channel);
     void sysex (const event * e24);
     void flush ();
+    int panic ();
+    int active_note_count () const;
     void start ();
     void stop ();
     void clock (midipulse tick);
@@ -44,9 +44,9 @@
  */
 
 #include <string>
-#include <list>
 #include <vector>
 
+#include "midi/mastermidibase.hpp"      /* mastermidibase::capturelist      */
 #include "midi/midibytes.hpp"           /* midishort, midibyte, etc.        */
 #include "midi/midi_splitter.hpp"       /* seq66::midi_splitter             */
 #include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
@@ -61,6 +61,7 @@ namespace seq66
     class midi_splitter;
     class midi_vector;
     class performer;
+    class sequence;
 
 /**
  *  This class handles the parsing and writing of MIDI files.  In addition to
@@ -88,6 +89,47 @@ public:
 
     static const std::string sm_meta_text_labels[8];
 
+private:
+
+    /**
+     *  The outcome of parsing one track.  The stop value replaces the old
+     *  "return true" on junk data, which ended the parse of the tracks.
+     */
+
+    enum class trackstatus
+    {
+        ok,
+        stop,
+        fatal
+    };
+
+    /**
+     *  Holds the location of an MTrk chunk and the result of parsing it, so
+     *  that tracks can be parsed concurrently and installed in order.  The
+     *  tempo, time signature, and song information found in track 0 are
+     *  recorded here too, and given to the performer by apply_track(), on
+     *  the calling thread, after the parse.
+     */
+
+    struct trackinfo
+    {
+        int track               = 0;
+        std::size_t offset      = 0;        /* just past the chunk header   */
+        sequence * seq          = nullptr;  /* owned until installed        */
+        int seqnum              = 0;
+        midibyte channel        = 0;
+        trackstatus status      = trackstatus::ok;
+        std::string error;                  /* last error message, if any   */
+        midibpm bpm             = 0.0;      /* first tempo, 0 if none       */
+        int us_per_qn           = 0;
+        int beats_per_bar       = 0;        /* first time-sig, 0 if none    */
+        int beat_width          = 0;
+        int clocks_per_metronome = 0;
+        int thirtyseconds       = 0;
+        bool has_song_info      = false;
+        std::string song_info;              /* first text event             */
+    };
+
 private:
 
     /**
@@ -152,24 +194,34 @@ private:
     const std::string m_name;
 
     /**
-     *  This vector of characters holds our MIDI data.  We could also use
-     *  a string of characters, unsigned.  This member is resized to the
-     *  putative size of the MIDI file, in the parse() function.  Then the
-     *  whole file is read into it, as if it were an array.  This member is an
-     *  input buffer.
+     *  Points to the MIDI data, the whole file.  On UNIX-like systems the file
+     *  is memory-mapped (see m_map); otherwise it is read into m_data_buffer.
+     *  The track-parsing threads share this pointer read-only.
      */
 
-    std::vector<midibyte> m_data;
+    const midibyte * m_data;
 
     /**
-     *  Provides a list of characters.  The class pushes each MIDI byte into
-     *  this list using the write_byte() function.  Also note that the write()
-     *  function calls sequence::fill_list() to fill a temporary
-     *  std::list<char> (!) buffer, then writes that data <i> backwards </i> to
-     *  this member.  This member is an output buffer.
+     *  Holds the MIDI data when the file is not memory-mapped, or when the
+     *  data was read ahead of time and handed over via preload().
      */
 
-    std::list<midibyte> m_char_list;
+    std::vector<midibyte> m_data_buffer;
+
+    /**
+     *  The memory-mapped file, if any, unmapped in the destructor.
+     */
+
+    void * m_map;
+    std::size_t m_map_size;
+
+    /**
+     *  Provides the output buffer.  The whole file is built here, in one
+     *  contiguous block, using write_byte() and write_track(); then
+     *  write_file() writes it out in one call.
+     */
+
+    std::vector<midibyte> m_file_bytes;
 
     /**
      *  Indicates to store the new key, scale, and background
@@ -228,6 +280,12 @@ public:
     virtual bool write (performer & p, bool doseqspec = true);
 
     bool write_song (performer & p);
+    bool write_render
+    (
+        performer & p,
+        const mastermidibase::capturelist & cl
+    );
+    void preload (midibytes & data);
 
     const std::string & error_message () const
     {
@@ -331,6 +389,17 @@ protected:
     bool grab_input_stream (const std::string & tag);
     bool parse_smf_0 (performer & p, int screenset);
     bool parse_smf_1 (performer & p, int screenset, bool is_smf0 = false);
+    bool scan_tracks (midishort track_count, std::vector<trackinfo> & chunks);
+    void parse_tracks (performer & p, std::vector<trackinfo> & chunks);
+    void share_input (const midifile & source, std::size_t offset);
+    trackstatus parse_track (performer & p, trackinfo & info, bool is_smf0);
+    void apply_track (performer & p, const trackinfo & info);
+    void install_track
+    (
+        performer & p, trackinfo & info,
+        int screenset, bool is_smf0, midibyte buss_override
+    );
+    void release_input ();
 
     midilong parse_seqspec_header (int file_size);
     bool parse_seqspec_track (performer & p, int file_size);
@@ -382,8 +451,7 @@ protected:
     void write_short (midishort value);
 
     /**
-     *  Writes 1 byte.  The byte is written to the m_char_list member, using a
-     *  call to push_back().
+     *  Writes 1 byte.  The byte is appended to the m_file_bytes member.
      *
      * \param c
      *      The MIDI byte to be "written".
@@ -391,7 +459,7 @@ protected:
 
     void write_byte (midibyte c)
     {
-        m_char_list.push_back(c);
+        m_file_bytes.push_back(c);
     }
 
     void write_varinum (midilong);
@@ -403,6 +471,7 @@ protected:
     void write_seq_number (midishort seqnum);
     int read_seq_number ();
     bool write_header (int numtracks, int smfformat = 1);
+    bool write_file (const std::string & errmsg);
 #if defined SEQ66_USE_WRITE_START_TEMPO
     void write_start_tempo (midibpm start_tempo);
 #endif
@@ -463,8 +532,10 @@ extern bool read_midi_file
     const std::string & fn,
     int ppqn,
     std::string & errmsg,
-    bool addtorecent = true
+    bool addtorecent = true,
+    midibytes * preloaded = nullptr
 );
+extern bool read_midi_bytes (const std::string & fn, midibytes & data);
 extern bool write_midi_file
 (
     performer & p,
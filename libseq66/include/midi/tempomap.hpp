@@ -0,0 +1,192 @@
+#if ! defined SEQ66_TEMPOMAP_HPP
+#define SEQ66_TEMPOMAP_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempomap.hpp
+ *
+ *  This module declares a map of the tempo changes of a song, for converting
+ *  between pulses, microseconds, and JACK frames.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ */
+
+#include <memory>                       /* std::shared_ptr<>                */
+#include <vector>                       /* std::vector<>                    */
+
+#include "midi/midibytes.hpp"           /* seq66::midipulse, midibpm        */
+
+namespace seq66
+{
+
+/**
+ *  Holds the tempo changes of the song as a list of segments.  Each segment
+ *  starts at a tempo change, and records the elapsed time at its start, so
+ *  that converting a pulse to a time (or the reverse) is a binary search for
+ *  the segment, followed by one multiplication.  The first segment always
+ *  starts at pulse 0 with the base tempo of the song.
+ *
+ *  The tempo is in beats/minute, where the beat is the beat-width note, to
+ *  match the way output_func() and jack_assistant scale the BPM.
+ *
+ *  Once published by the performer, a tempomap is never modified; the
+ *  performer builds a new one and swaps it in, as sequence does with its
+ *  event snapshot.  This lets the output thread and the JACK process thread
+ *  read it without locking.
+ */
+
+class tempomap
+{
+
+public:
+
+    using pointer = std::shared_ptr<const tempomap>;
+
+    /**
+     *  A tempo change, as found in the tempo track, at its song position.
+     */
+
+    class change
+    {
+    public:
+
+        midipulse tc_tick;
+        midibpm tc_bpm;
+
+        change (midipulse tick, midibpm bpm) : tc_tick (tick), tc_bpm (bpm)
+        {
+            // no code
+        }
+
+        bool operator < (const change & rhs) const
+        {
+            return tc_tick < rhs.tc_tick;
+        }
+    };
+
+    using changes = std::vector<change>;
+
+private:
+
+    /**
+     *  A stretch of the song at one tempo, starting at ts_tick and lasting
+     *  until the start of the next segment.
+     */
+
+    class segment
+    {
+    public:
+
+        midipulse ts_tick;              /* the pulse where the tempo starts */
+        midibpm ts_bpm;                 /* the tempo of the segment         */
+        double ts_us;                   /* elapsed microseconds at ts_tick  */
+        double ts_us_per_tick;          /* the length of one pulse          */
+    };
+
+    using segments = std::vector<segment>;
+
+    /**
+     *  The segments, sorted by tick, and thus also by elapsed time.  Never
+     *  empty.
+     */
+
+    segments m_segments;
+
+    /**
+     *  The resolution and the beat width used in the conversions.
+     */
+
+    int m_ppqn;
+    int m_beat_width;
+
+public:
+
+    tempomap ();
+    tempomap (int ppqn, int beatwidth, midibpm basebpm);
+    tempomap (const tempomap &) = default;
+    tempomap & operator = (const tempomap &) = default;
+    ~tempomap () = default;
+
+    bool assign (const changes & tc);
+
+    /**
+     *  True if the map holds no tempo changes, only the base tempo.
+     */
+
+    bool empty () const
+    {
+        return m_segments.size() <= 1;
+    }
+
+    int count () const
+    {
+        return int(m_segments.size()) - 1;
+    }
+
+    int ppqn () const
+    {
+        return m_ppqn;
+    }
+
+    int beat_width () const
+    {
+        return m_beat_width;
+    }
+
+    midibpm base_bpm () const
+    {
+        return m_segments.front().ts_bpm;
+    }
+
+    midibpm bpm (midipulse tick) const
+    {
+        return find_tick(tick).ts_bpm;
+    }
+
+    changes get_changes () const;
+    midipulse next_change (midipulse tick) const;
+    double tick_to_us (midipulse tick) const;
+    midipulse us_to_tick (double us) const;
+    double tick_to_frame (midipulse tick, double framerate) const;
+    midipulse frame_to_tick (double frame, double framerate) const;
+
+private:
+
+    void append (midipulse tick, midibpm bpm);
+    double us_per_tick (midibpm bpm) const;
+    const segment & find_tick (midipulse tick) const;
+    const segment & find_us (double us) const;
+
+};          // class tempomap
+
+}           // namespace seq66
+
+#endif      // SEQ66_TEMPOMAP_HPP
+
+/*
+ * tempomap.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -50,6 +50,7 @@ namespace seq66
 
 extern int std_sleep_us ();
 extern bool microsleep (int us);
+extern bool microsleep_until (long us);
 extern bool millisleep (int ms);
 extern void thread_yield ();
 extern long microtime ();
@@ -44,7 +44,9 @@
  *      play/mutegroups.hpp
  */
 
+#include <atomic>                       /* std::atomic<> change generation  */
 #include <memory>                       /* std::shared_ptr<>, unique_ptr<>  */
+#include <unordered_map>                /* std::unordered_map<> coalescing  */
 #include <vector>                       /* std::vector<>                    */
 #include <thread>                       /* std::thread                      */
 
@@ -52,11 +54,13 @@
 #include "ctrl/opcontainer.hpp"         /* class seq66::opcontainer         */
 #include "midi/jack_assistant.hpp"      /* optional seq66::jack_assistant   */
 #include "midi/mastermidibus.hpp"       /* seq66::mastermidibus ALSA/JACK   */
+#include "midi/tempomap.hpp"            /* seq66::tempomap, tempo changes   */
 #include "play/metro.hpp"               /* seq66::metro metronome pattern   */
 #include "play/playlist.hpp"            /* seq66::playlist                  */
 #include "play/sequence.hpp"            /* seq66::sequence                  */
 #include "play/setmapper.hpp"           /* seq66::seqmanager and seqstatus  */
 #include "util/condition.hpp"           /* seq66::condition/synchronizer    */
+#include "util/mpsc_queue.hpp"          /* seq66::mpsc_queue notifications  */
 
 #if defined USE_SONG_BOX_SELECT
 #include <set>                          /* std::set, arbitary selection     */
@@ -388,6 +392,78 @@ private:
 
     static automation_pair sm_auto_func_list [];
 
+    /**
+     *  A notification waiting in m_notices for delivery to the callbacks.
+     *  The fields used depend on the kind:  n_number is the pattern, set,
+     *  mute-group, automation slot, or PPQN; n_flag is the learning or
+     *  signalling flag.  n_announce asks for a trigger change to be sent
+     *  to the control surface.  n_superseded is set by
+     *  deliver_notifications() when a later notice with the same key() was
+     *  raised.
+     */
+
+    class notice
+    {
+    public:
+
+        callbacks::index n_kind;
+        int n_number;
+        change n_mod;
+        midibpm n_bpm;
+        bool n_flag;
+        playlist::action n_action;
+        bool n_announce;
+        bool n_superseded;
+
+        notice
+        (
+            callbacks::index kind   = callbacks::index::ui_change,
+            int number              = 0,
+            change mod              = change::no
+        ) :
+            n_kind      (kind),
+            n_number    (number),
+            n_mod       (mod),
+            n_bpm       (0.0),
+            n_flag      (false),
+            n_action    (playlist::action::none),
+            n_announce  (false),
+            n_superseded(false)
+        {
+            // no code
+        }
+
+        /**
+         *  Song changes (playlist steps) and group-learn notices are
+         *  commands, not states, so each one must be delivered.
+         */
+
+        bool coalescable () const
+        {
+            return
+            (
+                n_kind != callbacks::index::song_change &&
+                n_kind != callbacks::index::group_learn &&
+                n_kind != callbacks::index::group_learn_complete
+            );
+        }
+
+        /**
+         *  Notices with the same kind, number, flag, and action are
+         *  coalesced.  The change value is not part of the key; see
+         *  deliver_notifications().
+         */
+
+        std::uint64_t key () const
+        {
+            return
+                (std::uint64_t(n_kind) << 48) |
+                (std::uint64_t(n_action) << 40) |
+                (std::uint64_t(n_flag ? 1 : 0) << 32) |
+                std::uint32_t(n_number);
+        }
+    };
+
     /**
      *  Holds the first Meta Text message, if any, in the first pattern.
      *  The string is encoded as "MIDI bytes", which means that characters
@@ -666,6 +742,17 @@ private:                            /* key, midi, and op container section  */
 
     mutable bool m_needs_update;
 
+    /**
+     *  Counts the changes that any view might need to show:  edits of
+     *  patterns (see sequence::redraw_needed()), mute and set changes, the
+     *  notifications, and set_needs_update().  Unlike m_needs_update, it is
+     *  not reset when read, so that any number of views can compare it to
+     *  the value they last drew, and skip the repaint when nothing changed.
+     *  The motion of the progress bars does not bump it.
+     */
+
+    mutable std::atomic<unsigned> m_change_generation;
+
     /**
      *  Indicates to belay updates during critical work.
      */
@@ -736,6 +823,40 @@ private:                            /* key, midi, and op container section  */
 
     std::atomic<bool> m_resolution_change;
 
+    /**
+     *  Holds the tempo changes of the tempo track at their song positions,
+     *  for converting pulses to time in Song mode.  The map is rebuilt when
+     *  the tempo track or its triggers change, and is swapped in with
+     *  std::atomic_store(), so that the output thread and the JACK callbacks
+     *  can read it without locking.  See update_tempo_map().
+     */
+
+    tempomap::pointer m_tempo_map;
+
+    /**
+     *  Serializes the rebuilding of m_tempo_map.  Readers do not lock.
+     */
+
+    mutable recmutex m_tempo_map_mutex;
+
+    /**
+     *  The maps replaced by update_tempo_map().  A reader such as the JACK
+     *  timebase callback may still hold a replaced map, and must not be the
+     *  one to free it, so the replaced maps are kept here until no reader
+     *  holds them, and are then freed by the next update.
+     */
+
+    std::vector<tempomap::pointer> m_retired_tempo_maps;
+
+    /**
+     *  Set when the tempo map needs rebuilding, but the request came from a
+     *  thread other than m_notify_thread.  The map is then rebuilt by
+     *  deliver_notifications(), with the requested base tempo, if any.
+     */
+
+    std::atomic<bool> m_tempo_map_stale;
+    std::atomic<midibpm> m_tempo_map_base;
+
     /**
      *  Indicates the number of beats considered in calculating the BPM via
      *  button tapping.  This value is displayed in the button.
@@ -1010,6 +1131,39 @@ private:                            /* key, midi, and op container section  */
 
     callbacks::clients m_notify;
 
+    /**
+     *  Notifications raised by threads other than m_notify_thread, such as
+     *  the output thread (song recording, tempo changes, auto-stop) and the
+     *  MIDI input thread (automation).  They wait here until the consumer
+     *  calls deliver_notifications(), so that the real-time threads never
+     *  run GUI or control-output code.
+     */
+
+    mpsc_queue<notice> m_notices;
+
+    /**
+     *  Used by deliver_notifications() to drain m_notices and drop the
+     *  duplicates.  Used only by the consumer thread; kept here to avoid
+     *  an allocation per delivery.
+     */
+
+    std::vector<notice> m_notice_batch;
+
+    /**
+     *  Used by deliver_notifications() to find the latest notice in the
+     *  batch for each notice::key().  Kept here for the same reason.
+     */
+
+    std::unordered_map<std::uint64_t, std::size_t> m_notice_index;
+
+    /**
+     *  The thread that delivers the notifications, the one that created the
+     *  performer (the main/GUI thread).  Notifications raised on this thread
+     *  are delivered right away, as before.
+     */
+
+    std::thread::id m_notify_thread;
+
     /**
      *  If true, indicate certain events, like song-changes, occur via a
      *  signal.  In a headless run, there's no conflict with Qt's threads, but
@@ -1074,6 +1228,7 @@ public:
 
     void enregister (callbacks * pfcb);             /* for notifications    */
     void unregister (callbacks * pfcb);
+    int deliver_notifications ();
     void notify_automation_change (automation::slot s);
     void notify_set_change (screenset::number setno, change mod = change::yes);
     void notify_mutes_change (screenset::number setno, change mod = change::yes);
@@ -1172,7 +1327,8 @@ public:
     (
         const std::string & fn,
         std::string & errmsg,
-        bool addtorecent = true
+        bool addtorecent = true,
+        midibytes * preloaded = nullptr
     );
 
     bool notemap_exists () const
@@ -1477,6 +1633,16 @@ public:
         return m_bpm;                   /* only a nominal value */
     }
 
+    tempomap::pointer tempo_map () const
+    {
+        return std::atomic_load(&m_tempo_map);
+    }
+
+    bool update_tempo_map (midibpm basebpm = 0.0);
+    void refresh_tempo_map (midibpm basebpm = 0.0);
+    bool tempo_map_active () const;
+    bool tempo_map_owns (seq::number seqno) const;
+
     int rows () const
     {
         return mapper().rows();
@@ -2161,6 +2327,7 @@ public:
     void auto_play ();
     void play_all_sets (midipulse tick);
     void play (midipulse tick);
+    bool render_song (const std::string & fn, std::string & errmsg);
     void all_notes_off ();
 
     void unqueue_sequences (int hotseq)
@@ -2169,6 +2336,7 @@ public:
     }
 
     bool panic ();                                      /* from kepler43    */
+    int hanging_notes () const;
     bool visibility (automation::action a);             /* for NSM/Live use */
     void set_tick (midipulse tick, bool dontreset = false);
     void set_left_tick (midipulse tick);
@@ -2876,6 +3044,18 @@ public:
     void set_needs_update (bool flag = true)
     {
         m_needs_update = flag;
+        if (flag)
+            redraw_needed();
+    }
+
+    unsigned change_generation () const
+    {
+        return m_change_generation;
+    }
+
+    void redraw_needed () const
+    {
+        ++m_change_generation;
     }
 
     void send_seq_event (int seqno, midicontrolout::seqaction what)
@@ -3467,6 +3647,8 @@ private:
 private:
 
     void show_key_error (const keystroke & k, const std::string & tag);
+    void post_notice (const notice & n);
+    void dispatch_notice (const notice & n);
 
     static void print_parameters
     (
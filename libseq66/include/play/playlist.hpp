@@ -35,9 +35,16 @@
  *      Add filepath to BAD playlist message.
  */
 
+#include <atomic>                       /* std::atomic<bool>                */
 #include <map>                          /* std::map<>                       */
+#include <memory>                       /* std::unique_ptr<>                */
+#include <mutex>                        /* std::mutex                       */
+#include <thread>                       /* std::thread                      */
+#include <vector>                       /* std::vector<>                    */
 
 #include "cfg/basesettings.hpp"         /* seq66::basesettings class        */
+#include "midi/midibytes.hpp"           /* seq66::midibytes                 */
+#include "util/condition.hpp"           /* seq66::synchronizer              */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -185,6 +192,76 @@ private:
 
     using play_list = std::map<int, play_list_t>;
 
+    /**
+     *  Prefetches the file bytes of the songs next to the current song on a
+     *  background thread, so that changing to one of them does not wait on
+     *  the disk.  Nothing is parsed ahead:  parsing fills in the performer
+     *  directly, so the song change still stops, clears, and parses (see the
+     *  TODO file).  The thread is started by the first request.
+     */
+
+    class songprefetch final : public synchronizer
+    {
+
+    private:
+
+        /**
+         *  Guards the list of wanted files and the prefetched file bytes.
+         */
+
+        std::mutex m_mutex;
+
+        /**
+         *  The full paths of the songs to keep in memory.
+         */
+
+        std::vector<std::string> m_wanted;
+
+        /**
+         *  The file bytes read so far, keyed by the full path of the song.
+         */
+
+        std::map<std::string, midibytes> m_songs;
+
+        /**
+         *  Set when m_wanted changes, to wake up the thread.
+         */
+
+        std::atomic<bool> m_pending;
+
+        /**
+         *  Set to tell the thread to exit.
+         */
+
+        std::atomic<bool> m_done;
+
+        /**
+         *  The reading thread.
+         */
+
+        std::thread m_thread;
+
+    public:
+
+        songprefetch ();
+        songprefetch (const songprefetch &) = delete;
+        songprefetch & operator = (const songprefetch &) = delete;
+        virtual ~songprefetch ();
+
+        void request (const std::vector<std::string> & fnames);
+        bool take (const std::string & fname, midibytes & data);
+
+        virtual bool predicate () const override
+        {
+            return m_pending || m_done;
+        }
+
+    private:
+
+        void run ();
+
+    };
+
 private:
 
     /**
@@ -262,6 +339,13 @@ private:
 
     bool m_show_on_stdout;
 
+    /**
+     *  Prefetches the file bytes of the next and previous songs of the
+     *  current play-list.  Created when a song is first opened.
+     */
+
+    std::unique_ptr<songprefetch> m_song_prefetch;
+
 public:
 
     playlist
@@ -439,6 +523,7 @@ private:
     bool check_song_list (const play_list_t & plist);
     bool add_list (const play_list_t & plist);
     void show_list (const play_list_t & pl) const;
+    void prefetch_neighbors ();
 
     std::string song_filepath (const song_spec_t & s) const;
     bool add_song (song_spec_t & sspec);
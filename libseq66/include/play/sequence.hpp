@@ -39,15 +39,18 @@
  */
 
 #include <atomic>                       /* std::atomic<bool> for dirt       */
-#include <stack>                        /* std::stack<eventlist>            */
+#include <memory>                       /* std::shared_ptr<> snapshots      */
 #include <string>                       /* std::string                      */
+#include <vector>                       /* std::vector<> for noteindex      */
 
 #include "seq66_features.hpp"           /* various feature #defines         */
 #include "cfg/usrsettings.hpp"          /* enum class record                */
 #include "midi/calculations.hpp"        /* seq66::lengthfix, quantization   */
 #include "midi/eventlist.hpp"           /* seq66::eventlist                 */
+#include "midi/eventpack.hpp"           /* seq66::eventpack for playback    */
 #include "play/triggers.hpp"            /* seq66::triggers, etc.            */
 #include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
+#include "util/undojournal.hpp"         /* seq66::undojournal<> template    */
 
 /**
  *  Provides an integer value for color that matches PaletteColor::NONE.  That
@@ -268,14 +271,153 @@ public:
 
     };      // nested class note_info
 
+    /**
+     *  A time-ordered copy of the drawable note information of a sequence,
+     *  used by the pattern editor to find the notes that fall inside the
+     *  exposed part of the piano roll without walking, and locking for,
+     *  every event of the pattern on each paint.  It is rebuilt, under a
+     *  single lock, only when the draw generation of the sequence changes.
+     *  See sequence::draw_generation().
+     */
+
+    class noteindex
+    {
+    private:
+
+        std::vector<note_info> nx_notes;    /* in event (start) order       */
+        std::vector<draw> nx_kinds;         /* linked, note_on, ...         */
+        std::vector<midipulse> nx_reach;    /* running maximum of reaches   */
+        std::vector<int> nx_extras;         /* wrapped notes, tempo events  */
+        unsigned nx_generation;             /* sequence draw generation     */
+        bool nx_valid;                      /* false if never/badly built   */
+        bool nx_sorted;                     /* false while events unsorted  */
+
+    public:
+
+        noteindex ();
+
+        void clear ()
+        {
+            nx_valid = false;
+        }
+
+        bool valid () const
+        {
+            return nx_valid;
+        }
+
+        int count () const
+        {
+            return int(nx_notes.size());
+        }
+
+        draw kind (int i) const
+        {
+            return nx_kinds[i];
+        }
+
+        const note_info & info (int i) const
+        {
+            return nx_notes[i];
+        }
+
+        bool refresh (const sequence & s);
+        void visible
+        (
+            midipulse tick_s, midipulse tick_f, std::vector<int> & indices
+        ) const;
+
+    private:
+
+        static bool extra (draw dt, const note_info & ni);
+        bool in_range (int i, midipulse tick_s, midipulse tick_f) const;
+
+    };      // nested class noteindex
+
 private:
 
     /**
-     *  Provides a stack of event-lists for use with the undo and redo
-     *  facility.
+     *  Provides a journal of event-list changes for use with the undo and
+     *  redo facility.
+     */
+
+    using eventjournal = undojournal<event>;
+
+    /**
+     *  Provides an immutable, packed copy of the event list for use by the
+     *  output thread.  See m_play_events.
      */
 
-    using eventstack = std::stack<eventlist>;
+    using snapshot = eventpack::pointer;
+
+    /**
+     *  Locks m_mutex for the span of an operation, like automutex, and
+     *  counts the nesting of such locks.  When the outermost editlock is
+     *  released, and the events were changed while it was held, the playback
+     *  snapshot is built, once.  Thus a quantize, a drag, or a paste that
+     *  calls modify() for each step still publishes only one snapshot.
+     */
+
+    class editlock
+    {
+
+    private:
+
+        const sequence & m_seq;
+        automutex m_locker;
+
+    public:
+
+        editlock () = delete;
+        editlock (const editlock &) = delete;
+        editlock & operator = (const editlock &) = delete;
+
+        explicit editlock (const sequence & s) :
+            m_seq       (s),
+            m_locker    (s.m_mutex)
+        {
+            ++m_seq.m_edit_depth;
+        }
+
+        ~editlock ()
+        {
+            if (--m_seq.m_edit_depth == 0 && m_seq.m_publish_pending)
+                const_cast<sequence &>(m_seq).flush_events();
+        }
+
+    };      // nested class editlock
+
+    /**
+     *  Marks the span of an edit that reports, via touch_undo_range(), the
+     *  ticks of every event it adds, removes, or changes.  Changes published
+     *  inside the span then keep the undo range (see undo_hint()) valid.
+     *  Used under an editlock.
+     */
+
+    class undotracker
+    {
+
+    private:
+
+        sequence & m_seq;
+
+    public:
+
+        undotracker () = delete;
+        undotracker (const undotracker &) = delete;
+        undotracker & operator = (const undotracker &) = delete;
+
+        explicit undotracker (sequence & s) : m_seq (s)
+        {
+            ++m_seq.m_undo_tracking;
+        }
+
+        ~undotracker ()
+        {
+            --m_seq.m_undo_tracking;
+        }
+
+    };      // nested class undotracker
 
 #if defined SEQ66_TIME_SIG_DRAWING
 
@@ -356,6 +498,37 @@ private:
 
     eventlist m_events;
 
+    /**
+     *  Holds the latest published copy of m_events, which is what play() and
+     *  live_play() actually play.  Editing functions work on m_events under
+     *  an editlock and then call publish_events(); when the outermost
+     *  editlock is released, a new snapshot is built, once, and swapped in
+     *  atomically (std::atomic_store()).  The output thread
+     *  grabs the current snapshot with std::atomic_load(), so it never waits
+     *  on an edit, a quantization, or a piano-roll redraw.  The snapshot is
+     *  an eventpack, which holds only what playback needs, 16 bytes per
+     *  event, so that scanning many armed patterns stays in the cache.
+     */
+
+    snapshot m_play_events;
+
+    /**
+     *  Holds events recorded (via stream_event()) while the pattern plays.
+     *  Appending to it is O(1); the input thread merges it into m_events
+     *  after each burst of input (see merge_recorded()), so that a fast
+     *  performance does not re-sort and re-publish the whole pattern for
+     *  every incoming note.  Protected by m_mutex.
+     */
+
+    event::buffer m_record_events;
+
+    /**
+     *  Raised when m_record_events is not empty, so that merge_recorded()
+     *  can check for work without taking m_mutex.
+     */
+
+    std::atomic<bool> m_record_pending;
+
     /**
      *  Holds the list of triggers associated with the sequence, used in the
      *  performance/song editor.
@@ -397,16 +570,26 @@ private:
     bool m_have_redo;
 
     /**
-     *  Provides a list of event actions to undo.
+     *  Provides the event changes to undo and to redo.  Only the changed
+     *  range of events is stored for each step, and the total is capped by
+     *  usr().undo_limit().
      */
 
-    eventstack m_events_undo;
+    eventjournal m_events_undo;
 
     /**
-     *  Provides a list of event actions to redo.
+     *  The range of ticks changed by tracked edits (see undotracker) since
+     *  the last undo-journal action, so that the journal need compare only
+     *  the events in that range.  Empty (m_undo_lo > m_undo_hi) if nothing
+     *  has changed.  Any change published outside of a tracked edit makes
+     *  the range invalid, and the journal then compares all of the events.
+     *  Protected by m_mutex.
      */
 
-    eventstack m_events_redo;
+    bool m_undo_range_valid;
+    midipulse m_undo_lo;
+    midipulse m_undo_hi;
+    int m_undo_tracking;
 
     /**
      *  A new feature for recording, based on a "stazed" feature.  If true
@@ -702,6 +885,23 @@ private:
 
     mutable std::atomic<bool> m_dirty_names;
 
+    /**
+     *  Incremented whenever the drawable content of the pattern (events,
+     *  links, or selection) might have changed.  Unlike the dirty flags, it
+     *  is never reset, so that any number of views can compare it against
+     *  the value they last drew.  See the noteindex class.
+     */
+
+    mutable std::atomic<unsigned> m_draw_generation;
+
+    /**
+     *  Incremented whenever the triggers of the pattern change.  Trigger
+     *  changes do not touch the draw generation, so that the pattern
+     *  editors do not redraw for them.  See mark_trigger_modified().
+     */
+
+    std::atomic<unsigned> m_trigger_generation;
+
     /**
      *  Indicates the pattern was modified.  Unlike the is_dirty_xxx flags,
      *  this one is not reset when checked.  Useful when closing a file or the
@@ -744,6 +944,23 @@ private:
     midipulse m_queued_tick;        /**< Provides the tick for queuing.     */
     midipulse m_trigger_offset;     /**< Provides the trigger offset.       */
 
+    /**
+     *  Provides a persistent playback cursor, so that play() and live_play()
+     *  do not have to scan the event list from the beginning on every call
+     *  from the output thread.  The index is that of the next event to
+     *  examine, and the base is the start of the loop pass (in global
+     *  pulses) in which that event is to be played.  The next-stamp member
+     *  is the offset start tick at which the next frame is expected to
+     *  begin; if the next frame starts elsewhere (relocation, trigger
+     *  offset change, set_last_tick()), the cursor is re-seated by a binary
+     *  search of the event list.  See play_cursor().
+     */
+
+    std::size_t m_play_index;
+    midipulse m_play_base;
+    midipulse m_play_next;
+    midipulse m_play_length;
+
     /**
      *  This constant provides the scaling used to calculate the time position
      *  in ticks (pulses), based also on the PPQN value.  Hardwired to
@@ -910,6 +1127,25 @@ private:
 
     mutable recmutex m_mutex;
 
+    /**
+     *  Provides locking for the playback state shared with the output
+     *  thread:  the triggers, the armed/queued flags, the last tick, the
+     *  trigger offset, and the playing-notes counters.  The output thread
+     *  takes only this lock, never m_mutex; functions that take both must
+     *  take m_mutex first.  It is held only briefly by the user-interface.
+     */
+
+    mutable recmutex m_play_mutex;
+
+    /**
+     *  The nesting depth of editlock objects, and a flag that the events
+     *  have changed since the playback snapshot was last built.  Both are
+     *  protected by m_mutex.  See publish_events().
+     */
+
+    mutable int m_edit_depth;
+    mutable bool m_publish_pending;
+
 private:
 
     /*
@@ -971,6 +1207,8 @@ public:
         return (-1);
     }
 
+    static void load_defaults ();
+
     eventlist & events ()
     {
         return m_events;
@@ -1137,6 +1375,7 @@ public:
 
     bool loop_count_max (int m, bool user_change = false);
     void modify (bool notifychange = true);
+    void mark_modified (bool notifychange = true);
 
     void unmodify ()
     {
@@ -1160,7 +1399,7 @@ public:
 
     void set_have_redo ()
     {
-        m_have_redo = m_events_redo.size() > 0;
+        m_have_redo = m_events_undo.have_redo();
     }
 
     bool have_redo () const
@@ -1548,6 +1787,19 @@ public:
     bool is_dirty_names () const;
     void set_dirty_mp ();
     void set_dirty ();
+
+    unsigned draw_generation () const
+    {
+        return m_draw_generation;
+    }
+
+    unsigned trigger_generation () const
+    {
+        return m_trigger_generation;
+    }
+
+    void redraw_needed () const;
+
     std::string channel_string () const;            /* "F" or "<channel+1>" */
     bool set_channels (int channel);                /* modifies event list  */
 
@@ -1583,6 +1835,7 @@ public:
     std::string to_string () const;
     void play (midipulse tick, bool playback_mode, bool resume = false);
     void live_play (midipulse tick);
+    void publish_events ();
     void play_queue (midipulse tick, bool playbackmode, bool resume);
     bool push_add_note
     (
@@ -1624,6 +1877,7 @@ public:
     );
     bool append_event (const event & er);
     void sort_events ();
+    void merge_recorded ();
     event find_event (const event & e, bool nextmatch = false);
     bool remove_duplicate_events (midipulse tick, int note = (-1));
     void notify_change (bool userchange = true);
@@ -1826,6 +2080,7 @@ public:
     void clear_events ()
     {
         m_events.clear();
+        redraw_needed();
     }
 
     void draw_lock () const;
@@ -1976,6 +2231,8 @@ protected:
 
 private:
 
+    void flush_events ();
+
     mastermidibus * master_bus ()
     {
         return m_master_bus;
@@ -1996,7 +2253,33 @@ private:
         midibyte status, midibyte cc, int divide, bool linked = false
     );
     bool change_ppqn (int p);
-    void put_event_on_bus (const event & ev);
+    void put_event_on_bus (const event & ev, midipulse tick = c_null_midipulse);
+    void put_event_on_bus
+    (
+        const eventpack & evs, const eventpack::record & r,
+        midipulse tick, int transpose = 0
+    );
+    void send_event (event & evout, midibyte channel);
+    bool play_frame (midipulse tick, bool playback_mode, bool resume);
+    void mark_trigger_modified ();
+    eventpack::const_iterator play_cursor
+    (
+        const eventpack & evs,
+        midipulse startstamp, midipulse length
+    );
+    void park_play_cursor
+    (
+        const eventpack & evs, eventpack::const_iterator e,
+        midipulse base, midipulse nextstamp, midipulse length
+    );
+
+    snapshot play_events () const
+    {
+        return std::atomic_load(&m_play_events);
+    }
+    void push_events_undo ();               /* push_undo(), no lock     */
+    void undo_hint ();
+    void touch_undo_range (midipulse lo, midipulse hi);
     void reset_loop ();
     void set_trigger_offset (midipulse trigger_offset);
     void adjust_trigger_offsets_to_length (midipulse newlen);
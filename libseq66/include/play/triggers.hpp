@@ -36,10 +36,10 @@
  */
 
 #include <string>
-#include <stack>
 #include <vector>
 
 #include "midi/midibytes.hpp"           /* seq66::midipulse alias, etc.     */
+#include "util/undojournal.hpp"         /* seq66::undojournal<> template    */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -146,6 +146,18 @@ public:
         return m_tick_start < rhs.m_tick_start;
     }
 
+    /**
+     *  Compares everything but the selection status.  Used by the undo
+     *  journal.
+     */
+
+    bool same (const trigger & rhs) const
+    {
+        return m_tick_start == rhs.m_tick_start &&
+            m_tick_end == rhs.m_tick_end && m_offset == rhs.m_offset &&
+            m_transpose == rhs.m_transpose;
+    }
+
     std::string to_string () const;
 
     bool is_valid () const
@@ -351,11 +363,11 @@ private:
     using container = std::vector<trigger>;
 
     /**
-     *  Provides a stack for use with the undo/redo features of the
+     *  Provides a journal for use with the undo/redo features of the
      *  trigger support.
      */
 
-    using stack = std::stack<container>;
+    using journal = undojournal<trigger>;
 
 private:
 
@@ -386,16 +398,11 @@ private:
     trigger m_clipboard;
 
     /**
-     *  Handles the undo list for a series of operations on triggers.
+     *  Handles the undo and redo lists for a series of operations on
+     *  triggers.  Only the changed range of triggers is stored for each step.
      */
 
-    stack m_undo_stack;
-
-    /**
-     *  Handles the redo list for a series of operations on triggers.
-     */
-
-    stack m_redo_stack;
+    journal m_undo_journal;
 
     /**
      *  An iterator for cycling through the triggers during drawing.
@@ -432,6 +439,34 @@ private:
 
     int m_length;
 
+    /**
+     *  A lookup index over m_triggers, used to find the first trigger
+     *  bracketing a tick in O(log n) instead of walking the whole list.
+     *  Element i holds the largest tick_end() of triggers 0 to i.  Since the
+     *  list is sorted by tick_start(), an upper_bound() on the starts bounds
+     *  the candidates from the right, and a lower_bound() on this running
+     *  maximum bounds them from the left.  The index is rebuilt lazily, when
+     *  first needed after a modification.  All callers hold the sequence's
+     *  play mutex, so the rebuild in const functions is safe.
+     */
+
+    mutable std::vector<midipulse> m_end_index;
+
+    /**
+     *  Set by every function that alters trigger ticks or the list, so that
+     *  the next lookup rebuilds m_end_index.
+     */
+
+    mutable bool m_index_dirty;
+
+    /**
+     *  False if the list was found to be out of tick_start() order when the
+     *  index was rebuilt (offset_selected() can do that).  In that case the
+     *  lookups fall back to the linear scans.
+     */
+
+    mutable bool m_index_usable;
+
 public:
 
     triggers (sequence & parent);
@@ -474,6 +509,7 @@ public:
 
     container & triggerlist ()
     {
+        modified();                     /* caller might alter the triggers  */
         return m_triggers;
     }
 
@@ -550,6 +586,7 @@ public:
     {
         m_triggers.clear();
         m_number_selected = 0;
+        modified();
     }
 
     trigger next ();
@@ -575,6 +612,14 @@ public:
 
 private:
 
+    void modified ()
+    {
+        m_index_dirty = true;
+    }
+
+    void reindex () const;
+    int first_reaching (midipulse tick) const;
+    int first_bracketing (midipulse tick) const;
     void sort ();
     bool split (trigger & t, midipulse splittick);
     bool rescale (int oldppqn, int newppqn);
@@ -78,6 +78,22 @@ extern bool file_close
     std::FILE * filehandle,
     const std::string & filename = ""
 );
+extern bool file_sync
+(
+    std::FILE * filehandle,
+    const std::string & filename = ""
+);
+extern bool directory_sync (const std::string & path);
+extern bool file_replace
+(
+    const std::string & source,
+    const std::string & destination
+);
+extern bool file_copy_mode
+(
+    const std::string & source,
+    const std::string & destination
+);
 extern bool file_delete (const std::string & filespec);
 extern bool file_copy
 (
@@ -0,0 +1,194 @@
+#if ! defined SEQ66_MPSC_QUEUE_HPP
+#define SEQ66_MPSC_QUEUE_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          mpsc_queue.hpp
+ *
+ *  This module defines a bounded, lock-free queue that many threads can
+ *  write, and one thread reads.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ */
+
+#include <atomic>                       /* std::atomic<> for the sequences  */
+#include <cstddef>                      /* std::size_t                      */
+#include <memory>                       /* std::unique_ptr<>                */
+
+namespace seq66
+{
+
+/**
+ *  A bounded multiple-producer/single-consumer queue of objects, after
+ *  Dmitry Vyukov's bounded queue.  Each slot has a sequence counter that
+ *  says whose turn it is:  a producer claims the write position with a
+ *  compare-and-swap, fills the slot, then hands it to the consumer by
+ *  bumping the slot's sequence; the consumer reads the slot, then hands it
+ *  back to the producers one lap later.  No locks, no allocation after
+ *  construction.
+ *
+ *  Unlike ring_buffer, which has one producer, this queue can be fed by the
+ *  output thread, the MIDI input thread, and the GUI thread at once.  A full
+ *  queue rejects the new item, and the caller decides what to do with it.
+ *
+ *  TYPE should be cheap to copy, and its assignment must not allocate, so
+ *  that a real-time thread can push it.
+ */
+
+template <typename TYPE>
+class mpsc_queue
+{
+
+public:
+
+    using value_type = TYPE;
+    using size_type = std::size_t;
+
+private:
+
+    /**
+     *  A slot of the queue.  The slot at position p is free for the producer
+     *  when its sequence is p, and holds an item for the consumer when its
+     *  sequence is p + 1.
+     */
+
+    class cell
+    {
+    public:
+
+        std::atomic<size_type> c_sequence;
+        value_type c_data;
+    };
+
+    std::unique_ptr<cell []> m_cells;   /**< The power-of-two slot array.   */
+    size_type m_size_mask;              /**< Restricts index to < size.     */
+    std::atomic<size_type> m_enqueue;   /**< Next write position, shared.   */
+    size_type m_dequeue;                /**< Next read position, consumer.  */
+
+public:
+
+    explicit mpsc_queue (size_type sz);
+    mpsc_queue (const mpsc_queue &) = delete;
+    mpsc_queue & operator = (const mpsc_queue &) = delete;
+    ~mpsc_queue () = default;
+
+    int buffer_size () const
+    {
+        return int(m_size_mask + 1);
+    }
+
+    bool push (const value_type & item);
+    bool pop (value_type & dest);
+
+};          // class mpsc_queue<TYPE>
+
+/**
+ *  Creates a queue to hold at least sz items.  The actual size is rounded up
+ *  to the next power of two.
+ */
+
+template <typename TYPE>
+mpsc_queue<TYPE>::mpsc_queue (size_type sz) :
+    m_cells         (),
+    m_size_mask     (0),
+    m_enqueue       (0),
+    m_dequeue       (0)
+{
+    size_type psize = 2;
+    while (psize < sz)
+        psize <<= 1;
+
+    m_cells.reset(new cell[psize]);
+    m_size_mask = psize - 1;
+    for (size_type i = 0; i < psize; ++i)
+        m_cells[i].c_sequence.store(i, std::memory_order_relaxed);
+}
+
+/**
+ *  Any thread.  Claims the next write position, and fills it.
+ *
+ * \return
+ *      Returns false if the queue is full; the item is not added.
+ */
+
+template <typename TYPE>
+bool
+mpsc_queue<TYPE>::push (const value_type & item)
+{
+    cell * c = nullptr;
+    size_type pos = m_enqueue.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        c = &m_cells[pos & m_size_mask];
+        size_type seq = c->c_sequence.load(std::memory_order_acquire);
+        long dif = long(seq) - long(pos);
+        if (dif == 0)
+        {
+            if (m_enqueue.compare_exchange_weak(pos, pos + 1,
+                std::memory_order_relaxed))
+                break;                          /* we own the slot now      */
+        }
+        else if (dif < 0)
+            return false;                       /* a lap behind, i.e. full  */
+        else
+            pos = m_enqueue.load(std::memory_order_relaxed);
+    }
+    c->c_data = item;
+    c->c_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *  Consumer only.  Removes the front item, if any.
+ *
+ * \return
+ *      Returns false if the queue is empty, or if the producer that claimed
+ *      the front slot has not finished filling it yet.
+ */
+
+template <typename TYPE>
+bool
+mpsc_queue<TYPE>::pop (value_type & dest)
+{
+    cell & c = m_cells[m_dequeue & m_size_mask];
+    size_type seq = c.c_sequence.load(std::memory_order_acquire);
+    if (long(seq) - long(m_dequeue + 1) < 0)
+        return false;
+
+    dest = c.c_data;
+    c.c_sequence.store(m_dequeue + m_size_mask + 1, std::memory_order_release);
+    ++m_dequeue;
+    return true;
+}
+
+}           // namespace seq66
+
+#endif      // SEQ66_MPSC_QUEUE_HPP
+
+/*
+ * mpsc_queue.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -32,6 +32,7 @@
  * \license       GNU GPLv2 or above
  */
 
+#include <atomic>                       /* std::atomic<> for head and tail  */
 #include <cstddef>
 #include <sys/types.h>
 #include <vector>
@@ -47,6 +48,23 @@
 namespace seq66
 {
 
+/**
+ *  A wait-free single-producer/single-consumer ring buffer of objects.
+ *
+ *  The head (read) and tail (write) indices are free-running counters;
+ *  the slot is the index masked by the power-of-two size, and the number
+ *  of items is simply tail - head.  Only the producer stores the tail, only
+ *  the consumer stores the head.  Each side publishes its index with a
+ *  release store after touching the slot, and reads the other side's index
+ *  with an acquire load, so a slot is never read before it is written, nor
+ *  overwritten before it is read.  No locks, no allocation after
+ *  construction.
+ *
+ *  Unlike the earlier version, a full buffer rejects the new item (and
+ *  counts it as dropped), because the producer cannot safely discard the
+ *  consumer's front item.
+ */
+
 template <typename TYPE>
 class ring_buffer
 {
@@ -63,13 +81,12 @@ private:
 
     container m_buffer;         /**< Container for all push/popped items.   */
     size_type m_buffer_size;    /**< Constant power-of-two container size.  */
-    size_type m_contents_size;  /**< Number of active entries in container. */
-    volatile size_type m_tail;  /**< Index where next item is written.      */
-    volatile size_type m_head;  /**< Index where next item is read.         */
     size_type m_size_mask;      /**< Restricts index to < buffer size.      */
+    std::atomic<size_type> m_tail;  /**< Counter of items written.          */
+    std::atomic<size_type> m_head;  /**< Counter of items read.             */
     bool m_locked;              /**< Is memory locked? NOT YET SUPPORTED.   */
-    size_type m_contents_max;   /**< Useful in trouble-shooting.            */
-    int m_dropped;              /**< Number of items overwritten in run.    */
+    size_type m_contents_max;   /**< Useful in trouble-shooting. Producer.  */
+    int m_dropped;              /**< Number of items rejected. Producer.    */
 
 public:
 
@@ -85,12 +102,14 @@ public:
 
     void reset ()
     {
-        m_head = m_tail = 0;
+        m_head.store(0);
+        m_tail.store(0);
     }
 
     void clear ()
     {
-        m_dropped = m_contents_size = 0;
+        m_dropped = 0;
+        m_contents_max = 0;
         reset();
         initialize();
     }
@@ -100,9 +119,14 @@ public:
         return int(m_buffer_size);
     }
 
+    /**
+     *  An instantaneous count; from the producer side it can only grow, and
+     *  from the consumer side it can only shrink, before the next call.
+     */
+
     int count () const
     {
-        return int(m_contents_size);
+        return int(read_space());
     }
 
     int count_max () const
@@ -112,7 +136,7 @@ public:
 
     bool empty () const
     {
-        return count() == 0;
+        return read_space() == 0;
     }
 
     int dropped () const
@@ -120,41 +144,53 @@ public:
         return m_dropped;
     }
 
-    void write_advance ();
-    void read_advance ();
-    size_type write_space () const;
-    size_type read_space () const;
+    size_type write_space () const
+    {
+        return m_buffer_size - read_space();
+    }
+
+    size_type read_space () const
+    {
+        return m_tail.load(std::memory_order_acquire) -
+            m_head.load(std::memory_order_acquire);
+    }
+
     size_type read (reference dest);
     size_type write (const_reference src);
     bool push_back (const value_type & value);
+    bool write_block (const value_type * src, size_type n);
+    size_type read_block (value_type * dest, size_type n) const;
+    void read_skip (size_type n);
+
+    /**
+     *  Consumer only.  Removes the front item, if any.
+     */
 
     void pop_front ()
     {
-        if (m_contents_size > 0)
-            increment_head();
+        read_skip(1);
     }
 
     /*
      * Returns reference to the first element in the queue. This element will
-     * be the first element to be removed on a call to pop().  The return
-     * value might not be valid, either a default-constructed object or an
-     * old and "overwritten" value. An alternative is to call the read()
-     * function and check the return value.
+     * be the first element to be removed on a call to pop_front().  Consumer
+     * only, and valid only if read_space() is non-zero.  An alternative is to
+     * call the read() function and check the return value.
      */
 
     reference front ()
     {
-        return m_buffer[m_head];
+        return m_buffer[m_head.load(std::memory_order_relaxed) & m_size_mask];
     }
 
     const_reference front () const
     {
-        return m_buffer[m_head];
+        return m_buffer[m_head.load(std::memory_order_relaxed) & m_size_mask];
     }
 
     /**
-     *  Currently there's no way to be sure that the back item is a
-     *  valid item.
+     *  Producer only: the item most recently pushed.  Currently there's no
+     *  way to be sure that the back item is a valid item.
      */
 
     reference back ()
@@ -170,12 +206,10 @@ public:
 private:    // helper functions
 
     void initialize ();
-    void increment_head ();
-    void increment_tail ();
 
-    size_t previous_tail ()
+    size_type previous_tail () const
     {
-        return m_tail > 0 ? m_tail - 1 : m_buffer_size -1  ;
+        return (m_tail.load(std::memory_order_relaxed) - 1) & m_size_mask;
     }
 
 };          // class ring_buffer<TYPE>
@@ -189,10 +223,9 @@ template<typename TYPE>
 ring_buffer<TYPE>::ring_buffer (size_type sz) :
     m_buffer        (),
     m_buffer_size   (0),
-    m_contents_size (0),
+    m_size_mask     (0),
     m_tail          (0),
     m_head          (0),                    /* supports empty buffer case   */
-    m_size_mask     (0),
     m_locked        (false),
     m_contents_max  (0),
     m_dropped       (0)
@@ -220,7 +253,7 @@ ring_buffer<TYPE>::~ring_buffer ()
 {
 #if defined SEQ66_USE_MEMORY_LOCK
     if (m_locked)
-        ::munlock(m_buffer, m_buffer_size);
+        ::munlock(m_buffer.data(), m_buffer_size * sizeof(TYPE));
 #endif
 }
 
@@ -228,37 +261,7 @@ template<typename TYPE>
 void
 ring_buffer<TYPE>::initialize ()
 {
-    TYPE empty_value;
-    m_buffer.clear();
-    m_buffer.reserve(m_buffer_size);
-    for (size_t i = 0; i < m_buffer_size; ++i)
-        (void) m_buffer.push_back(empty_value); /* prepare buffer for usage */
-}
-
-template<typename TYPE>
-void
-ring_buffer<TYPE>::increment_head ()
-{
-    if (m_contents_size > 0)
-    {
-        ++m_head;
-        --m_contents_size;
-        if (m_head == m_buffer_size)
-            m_head = 0;                                 /* wrap around  */
-    }
-}
-
-template<typename TYPE>
-void
-ring_buffer<TYPE>::increment_tail ()
-{
-    ++m_tail;
-    ++m_contents_size;
-    if (m_contents_size > m_contents_max)               /* for checking */
-        m_contents_max = m_contents_size;
-
-    if (m_tail == m_buffer_size)
-        m_tail = 0;                                     /* wrap around  */
+    m_buffer.assign(m_buffer_size, TYPE());     /* prepare buffer for usage */
 }
 
 /**
@@ -271,7 +274,7 @@ bool
 ring_buffer<TYPE>::mlock ()
 {
 #if defined SEQ66_USE_MEMORY_LOCK
-    if (::mlock(m_buffer, m_buffer_size) != 0)
+    if (::mlock(m_buffer.data(), m_buffer_size * sizeof(TYPE)) != 0)
         return false;
 
     m_locked = true;
@@ -282,137 +285,132 @@ ring_buffer<TYPE>::mlock ()
 }
 
 /**
- *  Return the number of elements available for writing.  This is the number
- *  of elements in front of the write/tail pointer and behind the read/head
- *  pointer.
+ *  Producer only.  Since we only push one element at a time, the return code
+ *  is 1 if the element was written, and 0 if there was no space left.
  */
 
 template<typename TYPE>
 std::size_t
-ring_buffer<TYPE>::write_space () const
+ring_buffer<TYPE>::write (const_reference src)
 {
-    size_type t = m_tail;                           /* index for writing    */
-    size_type h = m_head;                           /* index for reading    */
-    if (t > h)
-        return ((h - t + m_buffer_size) & m_size_mask) - 1;
-    else if (t < h)
-        return (h - t) - 1;
-    else
-        return m_buffer_size - m_contents_size;
+    return push_back(src) ? 1 : 0 ;
 }
 
+/**
+ *  The copying data reader.  Unlike the original "C" version, this function
+ *  does not copy `cnt' bytes from `rb'.  Instead it copies one element to
+ *  the destination and returns 1 if that works.
+ *
+ *  Unlike front(), this function and pop_front() "remove" the element.
+ *  Consumer only.
+ */
+
 template<typename TYPE>
-void
-ring_buffer<TYPE>::write_advance ()
+std::size_t
+ring_buffer<TYPE>::read (reference dest)
 {
-    increment_tail();
+    size_type h = m_head.load(std::memory_order_relaxed);
+    if (m_tail.load(std::memory_order_acquire) == h)
+        return 0;
+
+    dest = m_buffer[h & m_size_mask];
+    m_head.store(h + 1, std::memory_order_release);
+    return 1;
 }
 
 /**
- *  Since we only push one element at a time, the return code is used to
- *  determine the number of elements currently active in the ring_buffer,
- *  unless 0 is returned, which indicates an error (no space left).
+ *  Producer only.  Copies the item into the tail slot, then publishes it.
+ *
+ * \return
+ *      Returns false if the buffer is full; the item is dropped.
  */
 
 template<typename TYPE>
-std::size_t
-ring_buffer<TYPE>::write (const_reference src)
+bool
+ring_buffer<TYPE>::push_back (const value_type & item)
 {
-    size_type result = 0;
-    size_type write_cnt = write_space();
-    if (write_cnt > 0)
+    size_type t = m_tail.load(std::memory_order_relaxed);
+    size_type used = t - m_head.load(std::memory_order_acquire);
+    if (used >= m_buffer_size)
     {
-        (void) push_back(src);
-        result = m_contents_size;
+        ++m_dropped;
+        return false;
     }
-    return result;
+    m_buffer[t & m_size_mask] = item;
+    m_tail.store(t + 1, std::memory_order_release);
+    if (used + 1 > m_contents_max)                      /* for checking     */
+        m_contents_max = used + 1;
+
+    return true;
 }
 
 /**
- *  Return the number of elements (TYPE) available for reading.  This is the
- *  number of elements in front of the read pointer and behind the write
- *  pointer.
+ *  Producer only.  Writes n items, wrapping as needed, all or nothing.
+ *  Used for spilling blocks of bytes (e.g. SysEx data).
+ *
+ * \return
+ *      Returns false if there is not room for all n items.
  */
 
 template<typename TYPE>
-std::size_t
-ring_buffer<TYPE>::read_space () const
+bool
+ring_buffer<TYPE>::write_block (const value_type * src, size_type n)
 {
-    if (count() > 0)
+    size_type t = m_tail.load(std::memory_order_relaxed);
+    size_type used = t - m_head.load(std::memory_order_acquire);
+    if (n > m_buffer_size - used)
     {
-        size_type t = m_tail;                       /* index for writing    */
-        size_type h = m_head;                       /* index for reading    */
-        if (t > h)
-            return t - h;
-        else if (t == h)
-            return m_contents_size;
-        else
-            return (t - h + m_buffer_size) & m_size_mask;
+        ++m_dropped;
+        return false;
     }
-    else
-        return 0;
-}
+    for (size_type i = 0; i < n; ++i)
+        m_buffer[(t + i) & m_size_mask] = src[i];
 
-template<typename TYPE>
-void
-ring_buffer<TYPE>::read_advance ()
-{
-    ++m_head;
-    m_head &= m_size_mask;
+    m_tail.store(t + n, std::memory_order_release);
+    if (used + n > m_contents_max)
+        m_contents_max = used + n;
+
+    return true;
 }
 
 /**
- *  The copying data reader.  Unlike the original "C" version, this function
- *  does not copy `cnt' bytes from `rb'.  Instead it copies one element to
- *  the destination and returns 1 if that works.
+ *  Consumer only.  Copies up to n items from the front without removing
+ *  them.  Call read_skip() to remove them.
  *
- *  Unlike front(), this function and pop_front() "remove" the element.
- *  The result return is the number of elements still stored.
+ * \return
+ *      Returns the number of items copied.
  */
 
 template<typename TYPE>
 std::size_t
-ring_buffer<TYPE>::read (reference dest)
+ring_buffer<TYPE>::read_block (value_type * dest, size_type n) const
 {
-    size_t result = 0;
-    size_type read_cnt = read_space();
-    if (read_cnt > 0)
-    {
-        dest = m_buffer[m_head];
-        pop_front();
-        result = m_contents_size;
-    }
-    return result;
+    size_type h = m_head.load(std::memory_order_relaxed);
+    size_type avail = m_tail.load(std::memory_order_acquire) - h;
+    if (n > avail)
+        n = avail;
+
+    for (size_type i = 0; i < n; ++i)
+        dest[i] = m_buffer[(h + i) & m_size_mask];
+
+    return n;
 }
 
 /**
- *  Increment the tail, then increment the head. This function supports the
- *  special case of an empty buffer.
+ *  Consumer only.  Removes up to n items from the front.
  */
 
 template<typename TYPE>
-bool
-ring_buffer<TYPE>::push_back (const value_type & item)
+void
+ring_buffer<TYPE>::read_skip (size_type n)
 {
-    if (m_contents_size == 0)
-    {
-        m_tail = m_head;
-        m_buffer[m_tail] = item;
-        increment_tail();
-    }
-    else if (m_contents_size < m_buffer_size)
-    {
-        m_buffer[m_tail] = item;
-        increment_tail();
-    }
-    else                                    /* accept item and drop front() */
-    {
-        increment_head();
-        m_buffer[m_tail] = item;
-        increment_tail();
-        ++m_dropped;                        /* for future use in expansion  */
-    }
-    return true;
+    size_type h = m_head.load(std::memory_order_relaxed);
+    size_type avail = m_tail.load(std::memory_order_acquire) - h;
+    if (n > avail)
+        n = avail;
+
+    if (n > 0)
+        m_head.store(h + n, std::memory_order_release);
 }
 
 /*
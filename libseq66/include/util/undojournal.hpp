@@ -0,0 +1,670 @@
+#if ! defined SEQ66_UNDOJOURNAL_HPP
+#define SEQ66_UNDOJOURNAL_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          undojournal.hpp
+ *
+ *  This module defines an undo/redo journal that stores the differences
+ *  between the saved states of a vector, rather than copies of the vector.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ */
+
+#include <algorithm>                    /* std::min(), std::max()           */
+#include <cstddef>                      /* std::size_t                      */
+#include <deque>                        /* std::deque<> of patches          */
+#include <utility>                      /* std::move()                      */
+#include <vector>                       /* std::vector<> container          */
+
+namespace seq66
+{
+
+/**
+ *  The number of bytes that an item holds on the heap, beyond sizeof(TYPE).
+ *  Overloaded for types, such as event, that have such data.
+ */
+
+template <typename TYPE>
+inline std::size_t
+undo_heap_bytes (const TYPE &)
+{
+    return 0;
+}
+
+/**
+ *  An undo/redo journal for a std::vector of items, such as the events of a
+ *  sequence or its triggers.  Formerly each undo step pushed a copy of the
+ *  whole container onto a std::stack, so that nudging one note in a large
+ *  pattern copied every event, and memory grew without bound during a long
+ *  editing session.
+ *
+ *  Here, each step is stored as a patch: a position, the items removed there,
+ *  and the items inserted there.  The journal keeps one "shadow" copy of the
+ *  container as of the latest journal action.  The top undo patch turns the
+ *  shadow into the newest saved state, the one below it turns that state
+ *  into the next older one, and so on; the redo patches work the same way in
+ *  the other direction.  Edits made between journal actions are found by
+ *  trimming the common head and tail of the shadow and the container, and
+ *  are folded into the top patches, so that the caller needs no changes to
+ *  its editing code.
+ *
+ *  The patches hold only the changed items.  Finding the change compares the
+ *  shadow with the container, which is linear in the size of the container,
+ *  unless the caller passes a hint() before the journal action, giving the
+ *  number of leading and trailing items that it knows did not change.  Then
+ *  only the rest is compared, and the cost is proportional to the edit.
+ *  The memory held is the shadow plus the patches, and both are counted
+ *  against the limit.
+ *
+ *  The TYPE must provide "bool same (const TYPE &) const", which compares
+ *  the content that undo needs to restore, ignoring transient items such as
+ *  selection or links.  If a TYPE holds data on the heap, an overload of
+ *  undo_heap_bytes() for it, found by argument-dependent lookup, lets the
+ *  journal count that data too.
+ *
+ *  The journal is not thread-safe; the caller locks.
+ */
+
+template <typename TYPE>
+class undojournal
+{
+
+public:
+
+    using value_type = TYPE;
+    using size_type = std::size_t;
+    using container = std::vector<value_type>;
+
+private:
+
+    /**
+     *  Replaces the pt_from items at pt_position with the pt_to items.
+     */
+
+    class patch
+    {
+    public:
+
+        size_type pt_position;
+        container pt_from;
+        container pt_to;
+
+        patch () : pt_position (0), pt_from (), pt_to ()
+        {
+            // no code
+        }
+
+        bool empty () const
+        {
+            return pt_from.empty() && pt_to.empty();
+        }
+
+        size_type bytes () const
+        {
+            return container_bytes(pt_from) + container_bytes(pt_to);
+        }
+    };
+
+    using patchlist = std::deque<patch>;
+
+    /**
+     *  The contents of the container as of the latest push(), undo(), or
+     *  redo().
+     */
+
+    container m_shadow;
+
+    /**
+     *  False until the first journal action copies the container.
+     */
+
+    bool m_shadow_valid;
+
+    /**
+     *  The undo patches, oldest first.  The back patch applies to the
+     *  shadow.
+     */
+
+    patchlist m_undo;
+
+    /**
+     *  The redo patches, oldest first.  The back patch applies to the
+     *  shadow.
+     */
+
+    patchlist m_redo;
+
+    /**
+     *  The number of bytes held by all of the patches, and by the shadow.
+     */
+
+    size_type m_patch_bytes;
+    size_type m_shadow_bytes;
+
+    /**
+     *  The approximate maximum number of bytes for the shadow and the patches
+     *  to hold.  If exceeded, the oldest steps are dropped, but the newest
+     *  undo and redo steps are always kept.  Zero means no limit.
+     */
+
+    size_type m_limit;
+
+    /**
+     *  The numbers of leading and trailing items that the caller says are
+     *  unchanged since the latest journal action.  Used by the next rebase()
+     *  only, if m_hinted is true.
+     */
+
+    size_type m_hint_head;
+    size_type m_hint_tail;
+    bool m_hinted;
+
+public:
+
+    undojournal (size_type limit = 0);
+
+    void clear ();
+
+    void limit (size_type bytes)
+    {
+        m_limit = bytes;
+    }
+
+    bool have_undo () const
+    {
+        return ! m_undo.empty();
+    }
+
+    bool have_redo () const
+    {
+        return ! m_redo.empty();
+    }
+
+    int undo_count () const
+    {
+        return int(m_undo.size());
+    }
+
+    int redo_count () const
+    {
+        return int(m_redo.size());
+    }
+
+    size_type bytes () const
+    {
+        return m_patch_bytes + m_shadow_bytes;
+    }
+
+    /**
+     *  Tells the next push(), undo(), or redo() that the first \a head and
+     *  the last \a tail items of the container have not changed since the
+     *  latest journal action, so it need not compare them.
+     */
+
+    void hint (size_type head, size_type tail)
+    {
+        m_hint_head = head;
+        m_hint_tail = tail;
+        m_hinted = true;
+    }
+
+    void push (const container & current);
+    void push (const container & current, const container & saved);
+    bool undo (container & current);
+    bool redo (container & current);
+
+private:
+
+    void rebase (const container & current);
+    void add (patch && p, patchlist & pl);
+    patch take (patchlist & pl);
+    void enforce_limit ();
+    void apply_to_shadow (const patch & p);
+    static size_type container_bytes (const container & c);
+    static patch difference
+    (
+        const container & a, const container & b,
+        size_type head = 0, size_type tail = 0
+    );
+    static patch compose
+    (
+        const patch & p, const patch & q, const container & middle
+    );
+    static void reverse (patch & p);
+    static void apply (const patch & p, container & c);
+    static void trim (patch & p);
+
+};          // class undojournal<TYPE>
+
+/**
+ *  Creates an empty journal.
+ *
+ * \param limit
+ *      The approximate maximum number of bytes to hold in the journal.
+ *      Zero, the default, means no limit.
+ */
+
+template <typename TYPE>
+undojournal<TYPE>::undojournal (size_type limit) :
+    m_shadow        (),
+    m_shadow_valid  (false),
+    m_undo          (),
+    m_redo          (),
+    m_patch_bytes   (0),
+    m_shadow_bytes  (0),
+    m_limit         (limit),
+    m_hint_head     (0),
+    m_hint_tail     (0),
+    m_hinted        (false)
+{
+    // no code
+}
+
+/**
+ *  Drops all undo and redo steps, and the shadow copy.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::clear ()
+{
+    m_shadow.clear();
+    m_shadow_valid = false;
+    m_undo.clear();
+    m_redo.clear();
+    m_patch_bytes = 0;
+    m_shadow_bytes = 0;
+    m_hinted = false;
+}
+
+/**
+ *  Saves the current contents of the container as the newest undo step.
+ *  The caller then edits the container.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::push (const container & current)
+{
+    rebase(current);
+    add(patch(), m_undo);                   /* the shadow is the new state  */
+    enforce_limit();
+}
+
+/**
+ *  Saves the given contents, rather than the current contents, as the newest
+ *  undo step.  The saved contents are an earlier state of the container, so
+ *  the shadow is first moved to them, then on to the current contents; the
+ *  second rebase makes the new step go from the current to the saved
+ *  contents.  A hint() describes the current contents, not the saved ones,
+ *  so it is dropped.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::push (const container & current, const container & saved)
+{
+    m_hinted = false;
+    rebase(saved);
+    add(patch(), m_undo);
+    rebase(current);
+    enforce_limit();
+}
+
+/**
+ *  Restores the newest undo step into the container, saving the current
+ *  contents as the newest redo step.  The shadow is brought up to date even
+ *  if there is no step, so that every journal action uses up the hint().
+ *
+ * \return
+ *      Returns true if there was a step to undo.
+ */
+
+template <typename TYPE>
+bool
+undojournal<TYPE>::undo (container & current)
+{
+    bool result = have_undo();
+    if (m_shadow_valid)
+        rebase(current);                    /* always uses up any hint()    */
+    else
+        m_hinted = false;
+
+    if (result)
+    {
+        patch p = take(m_undo);
+        apply(p, current);
+        apply_to_shadow(p);
+        reverse(p);
+        add(std::move(p), m_redo);
+        enforce_limit();
+    }
+    return result;
+}
+
+/**
+ *  Restores the newest redo step into the container, saving the current
+ *  contents as the newest undo step.  As with undo(), the shadow is brought
+ *  up to date even if there is no step.
+ *
+ * \return
+ *      Returns true if there was a step to redo.
+ */
+
+template <typename TYPE>
+bool
+undojournal<TYPE>::redo (container & current)
+{
+    bool result = have_redo();
+    if (m_shadow_valid)
+        rebase(current);                    /* always uses up any hint()    */
+    else
+        m_hinted = false;
+
+    if (result)
+    {
+        patch p = take(m_redo);
+        apply(p, current);
+        apply_to_shadow(p);
+        reverse(p);
+        add(std::move(p), m_undo);
+        enforce_limit();
+    }
+    return result;
+}
+
+/**
+ *  Brings the shadow up to date with the container.  The edit since the
+ *  last journal action is folded into the top undo and redo patches, which
+ *  must now start from the edited contents.  The first call makes the one
+ *  and only full copy.  Later calls compare the shadow with the container
+ *  (see difference()), skipping the items that a hint() says are unchanged.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::rebase (const container & current)
+{
+    bool hinted = m_hinted;
+    m_hinted = false;
+    if (m_shadow_valid)
+    {
+        patch edit = hinted ?
+            difference(m_shadow, current, m_hint_head, m_hint_tail) :
+            difference(m_shadow, current) ;
+
+        if (! edit.empty())
+        {
+            patch back = edit;
+            reverse(back);                  /* current to shadow            */
+            if (have_undo())
+                add(compose(back, take(m_undo), m_shadow), m_undo);
+
+            if (have_redo())
+                add(compose(back, take(m_redo), m_shadow), m_redo);
+
+            apply_to_shadow(edit);
+        }
+    }
+    else
+    {
+        m_shadow = current;
+        m_shadow_valid = true;
+        m_shadow_bytes = container_bytes(m_shadow);
+    }
+}
+
+template <typename TYPE>
+void
+undojournal<TYPE>::add (patch && p, patchlist & pl)
+{
+    m_patch_bytes += p.bytes();
+    pl.push_back(std::move(p));
+}
+
+template <typename TYPE>
+typename undojournal<TYPE>::patch
+undojournal<TYPE>::take (patchlist & pl)
+{
+    patch result = std::move(pl.back());
+    pl.pop_back();
+    m_patch_bytes -= result.bytes();
+    return result;
+}
+
+/**
+ *  Drops the oldest undo steps, then the oldest redo steps, until the
+ *  journal is under its limit.  The newest step of each kind is kept, and
+ *  the shadow cannot be dropped, so a very large container can leave the
+ *  journal over its limit with only those steps.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::enforce_limit ()
+{
+    if (m_limit > 0)
+    {
+        while (bytes() > m_limit && m_undo.size() > 1)
+        {
+            m_patch_bytes -= m_undo.front().bytes();
+            m_undo.pop_front();
+        }
+        while (bytes() > m_limit && m_redo.size() > 1)
+        {
+            m_patch_bytes -= m_redo.front().bytes();
+            m_redo.pop_front();
+        }
+    }
+}
+
+/**
+ *  Applies a patch to the shadow, keeping its byte count current.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::apply_to_shadow (const patch & p)
+{
+    m_shadow_bytes += container_bytes(p.pt_to);
+    m_shadow_bytes -= container_bytes(p.pt_from);
+    apply(p, m_shadow);
+}
+
+/**
+ *  The bytes held by a container's items, including their heap data, but
+ *  not counting unused capacity.
+ */
+
+template <typename TYPE>
+typename undojournal<TYPE>::size_type
+undojournal<TYPE>::container_bytes (const container & c)
+{
+    size_type result = c.size() * sizeof(value_type);
+    for (const auto & item : c)
+        result += undo_heap_bytes(item);
+
+    return result;
+}
+
+/**
+ *  Finds the single range that differs between two containers, by skipping
+ *  the items they have in common at the front and at the back.  Without a
+ *  hint, this is linear in the size of the containers, even for a small
+ *  edit.
+ *
+ * \param head
+ *      The number of leading items known to be the same in both containers.
+ *      They are not compared.
+ *
+ * \param tail
+ *      The number of trailing items known to be the same in both containers.
+ *      They are not compared.
+ *
+ * \return
+ *      Returns the patch that changes \a a into \a b.
+ */
+
+template <typename TYPE>
+typename undojournal<TYPE>::patch
+undojournal<TYPE>::difference
+(
+    const container & a, const container & b,
+    size_type head, size_type tail
+)
+{
+    size_type count = std::min(a.size(), b.size());
+    head = std::min(head, count);
+    while (head < count && a[head].same(b[head]))
+        ++head;
+
+    tail = std::min(tail, count - head);
+    while
+    (
+        tail < count - head &&
+        a[a.size() - 1 - tail].same(b[b.size() - 1 - tail])
+    )
+    {
+        ++tail;
+    }
+
+    patch result;
+    result.pt_position = head;
+    result.pt_from.assign(a.begin() + head, a.end() - tail);
+    result.pt_to.assign(b.begin() + head, b.end() - tail);
+    return result;
+}
+
+/**
+ *  Combines patch \a p, which changes A into B, with patch \a q, which
+ *  changes B into C, giving one patch that changes A into C.  The result
+ *  covers both ranges as seen in B; the parts of A and C outside \a p and
+ *  \a q are the same as in B, so only B is needed.
+ *
+ * \param middle
+ *      The full contents of B.
+ */
+
+template <typename TYPE>
+typename undojournal<TYPE>::patch
+undojournal<TYPE>::compose
+(
+    const patch & p, const patch & q, const container & middle
+)
+{
+    if (p.empty())
+        return q;
+
+    if (q.empty())
+        return p;
+
+    size_type pend = p.pt_position + p.pt_to.size();
+    size_type qend = q.pt_position + q.pt_from.size();
+    size_type lo = std::min(p.pt_position, q.pt_position);
+    size_type hi = std::max(pend, qend);
+    auto b = middle.begin();
+    patch result;
+    result.pt_position = lo;
+    result.pt_from.reserve(hi - lo + p.pt_from.size());
+    result.pt_from.insert(result.pt_from.end(), b + lo, b + p.pt_position);
+    result.pt_from.insert
+    (
+        result.pt_from.end(), p.pt_from.begin(), p.pt_from.end()
+    );
+    result.pt_from.insert(result.pt_from.end(), b + pend, b + hi);
+    result.pt_to.reserve(hi - lo + q.pt_to.size());
+    result.pt_to.insert(result.pt_to.end(), b + lo, b + q.pt_position);
+    result.pt_to.insert(result.pt_to.end(), q.pt_to.begin(), q.pt_to.end());
+    result.pt_to.insert(result.pt_to.end(), b + qend, b + hi);
+    trim(result);
+    return result;
+}
+
+template <typename TYPE>
+void
+undojournal<TYPE>::reverse (patch & p)
+{
+    p.pt_from.swap(p.pt_to);
+}
+
+/**
+ *  Replaces the pt_from items of the patch with its pt_to items.  Items are
+ *  assigned over where possible, then the remainder inserted or erased.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::apply (const patch & p, container & c)
+{
+    if (! p.empty())
+    {
+        auto first = c.begin() + p.pt_position;
+        size_type common = std::min(p.pt_from.size(), p.pt_to.size());
+        std::copy(p.pt_to.begin(), p.pt_to.begin() + common, first);
+        first += common;
+        if (p.pt_to.size() > common)
+            c.insert(first, p.pt_to.begin() + common, p.pt_to.end());
+        else
+            c.erase(first, first + (p.pt_from.size() - common));
+    }
+}
+
+/**
+ *  Removes items that a composed patch would replace with themselves.
+ */
+
+template <typename TYPE>
+void
+undojournal<TYPE>::trim (patch & p)
+{
+    container & f = p.pt_from;
+    container & t = p.pt_to;
+    size_type count = std::min(f.size(), t.size());
+    size_type tail = 0;
+    while (tail < count && f[f.size() - 1 - tail].same(t[t.size() - 1 - tail]))
+        ++tail;
+
+    f.erase(f.end() - tail, f.end());
+    t.erase(t.end() - tail, t.end());
+    count -= tail;
+
+    size_type head = 0;
+    while (head < count && f[head].same(t[head]))
+        ++head;
+
+    f.erase(f.begin(), f.begin() + head);
+    t.erase(t.begin(), t.begin() + head);
+    p.pt_position += head;
+}
+
+}           // namespace seq66
+
+#endif      // SEQ66_UNDOJOURNAL_HPP
+
+/*
+ * undojournal.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
@@ -85,6 +85,7 @@ HEADERS += include/seq66_features.h \
  include/midi/editable_events.hpp \
  include/midi/event.hpp \
  include/midi/eventlist.hpp \
+ include/midi/eventpack.hpp \
  include/midi/jack_assistant.hpp \
  include/midi/mastermidibase.hpp \
  include/midi/midibase.hpp \
@@ -93,6 +94,7 @@ HEADERS += include/seq66_features.h \
  include/midi/midi_splitter.hpp \
  include/midi/midi_vector_base.hpp \
  include/midi/midi_vector.hpp \
+ include/midi/tempomap.hpp \
  include/midi/wrkfile.hpp \
  include/play/clockslist.hpp \
  include/play/inputslist.hpp \
@@ -120,12 +122,14 @@ HEADERS += include/seq66_features.h \
  include/util/basic_macros.hpp \
  include/util/condition.hpp \
  include/util/filefunctions.hpp \
+ include/util/mpsc_queue.hpp \
  include/util/named_bools.hpp \
  include/util/palette.hpp \
  include/util/recmutex.hpp \
  include/util/rect.hpp \
  include/util/ring_buffer.hpp \
- include/util/strfunctions.hpp
+ include/util/strfunctions.hpp \
+ include/util/undojournal.hpp
 
 SOURCES += src/seq66_features.cpp \
  src/cfg/basesettings.cpp \
@@ -167,6 +171,7 @@ SOURCES += src/seq66_features.cpp \
  src/midi/editable_events.cpp \
  src/midi/event.cpp \
  src/midi/eventlist.cpp \
+ src/midi/eventpack.cpp \
  src/midi/jack_assistant.cpp \
  src/midi/mastermidibase.cpp \
  src/midi/midibase.cpp \
@@ -175,6 +180,7 @@ SOURCES += src/seq66_features.cpp \
  src/midi/midi_splitter.cpp \
  src/midi/midi_vector_base.cpp \
  src/midi/midi_vector.cpp \
+ src/midi/tempomap.cpp \
  src/midi/wrkfile.cpp \
  src/play/clockslist.cpp \
  src/play/inputslist.cpp \
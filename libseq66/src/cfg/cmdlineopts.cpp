@@ -327,6 +327,9 @@ static const std::string s_help_4b =
 "      no-daemonize  Or not. These options do not apply to Windows. If given,\n"
 "                    the application writes these options to the 'usr' file\n"
 "                    and exits. Subsequent runs are thus affected. Tricky!\n"
+"      render=file   Play the song of the MIDI file given on the command line\n"
+"                    offline, as fast as possible, write what it plays to\n"
+"                    this file as a plain SMF 1, and exit.\n"
 "\n"
 "Add '--user-save' to make these options permanent in the 'usr' file.\n"
 "\n"
@@ -565,6 +568,13 @@ cmdlineopts::parse_o_options (int argc, char * argv [])
                             {
                                 result = parse_o_virtual(arg);
                             }
+                            else if (optionname == "render")
+                            {
+                                arg = strip_quotes(arg);
+                                result = ! arg.empty();
+                                if (result)
+                                    usr().option_render(arg);
+                            }
                         }
                         if (! result)
                         {
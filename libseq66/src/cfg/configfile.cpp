@@ -47,6 +47,7 @@
  *  istream::tellg() returns a streampos.
  */
 
+#include <algorithm>                    /* std::lower_bound()               */
 #include <cctype>                       /* std::isspace(), std::isdigit()   */
 #include <iomanip>                      /* std::hex, std::setw()            */
 
@@ -106,6 +107,11 @@ configfile::configfile
     m_name              (name),
     m_version           ("0"),
     m_file_version      ("0"),
+    m_index_stream      (nullptr),
+    m_index_lines       (),
+    m_index_tail        (0),
+    m_index_tags        (),
+    m_index_sections    (),
     m_line              (),
     m_line_number       (0),
     m_line_pos          (0)
@@ -373,6 +379,40 @@ configfile::get_variable
 )
 {
     std::string result;
+    if (index_stream(file))
+    {
+        int start = index_find_line(std::streampos(position));
+        int header = start >= 0 ? index_find_tag(tag, start) : (-2) ;
+        if (header >= 0)
+        {
+            const indexsection & section = index_section(header);
+            auto vi = section.is_vars.find(variablename);
+            if (vi != section.is_vars.end())
+            {
+                for (int li : vi->second)
+                {
+                    const std::string & text = m_index_lines[li].il_text;
+                    std::string value = extract_variable(text, variablename);
+                    if (! is_questionable_string(value))
+                    {
+                        index_seek(file, li, start);
+                        return value;
+                    }
+                }
+            }
+            if (section.is_end < int(m_index_lines.size()))
+                index_seek(file, section.is_end, start);
+            else
+                index_seek_end(file, start);
+
+            return result;
+        }
+        else if (header == (-1))
+        {
+            index_seek_end(file, start);
+            return result;
+        }
+    }
     for
     (
         bool done = ! line_after(file, tag, position);
@@ -496,6 +536,7 @@ configfile::write_seq66_header
     const std::string & ver
 )
 {
+    index_clear();                      /* the file is being rewritten      */
     file <<
         "\n[Seq66]\n\nconfig-type = \"" << configtype << "\"\n"
         "version = " << ver << "\n"
@@ -765,6 +806,21 @@ configfile::line_after
 )
 {
     bool result = false;
+    if (index_stream(file))
+    {
+        int start = index_find_line(std::streampos(position));
+        int header = start >= 0 ? index_find_tag(tag, start) : (-2) ;
+        if (header >= 0)
+        {
+            index_seek(file, header, start);
+            return next_data_line(file, strip); /* might preserve space etc */
+        }
+        else if (header == (-1))
+        {
+            index_seek_end(file, start);
+            return false;
+        }
+    }
     file.clear();                               /* clear the file flags     */
     file.seekg(std::streampos(position), std::ios::beg); /* seek to spot    */
     m_line_number = 0;                          /* back to beginning        */
@@ -813,6 +869,20 @@ int
 configfile::find_tag (std::ifstream & file, const std::string & tag)
 {
     int result = (-1);
+    if (index_stream(file))
+    {
+        int header = index_find_tag(tag, 0);
+        if (header >= 0)
+        {
+            index_seek(file, header, 0);
+            return line_position();             /* int(m_line_pos)          */
+        }
+        else if (header == (-1))
+        {
+            index_seek_end(file, 0);
+            return result;
+        }
+    }
     file.clear();                               /* clear the file flags     */
     file.seekg(0, std::ios::beg);               /* seek to the beginning    */
     m_line_number = 0;                          /* back to beginning        */
@@ -909,6 +979,8 @@ configfile::append_error_message (const std::string & msg)
 bool
 configfile::set_up_ifstream (std::ifstream & instream)
 {
+    index_clear();                      /* a new parse, a fresh index       */
+
     bool result = instream.is_open();
     if (result)
     {
@@ -946,6 +1018,209 @@ configfile::set_up_ifstream (std::ifstream & instream)
     return result;
 }
 
+/**
+ *  Reads the whole file once, recording each line as get_line() would
+ *  return it, and the position of each section line.  The lookups done by
+ *  get_variable(), line_after(), and find_tag() then go straight to the
+ *  section, rather than re-reading the file from the given position.
+ *  They leave the stream, line(), line_number(), and line_position() as the
+ *  scans did, so that the callers can carry on with next_data_line().
+ *
+ * \param file
+ *      The stream to index.  If it is the stream already indexed, nothing
+ *      is done.
+ *
+ * \return
+ *      Returns true if the index can be used.
+ */
+
+bool
+configfile::index_stream (std::ifstream & file)
+{
+    if (m_index_stream == &file)
+        return true;
+
+    index_clear();
+    if (! file.is_open())
+        return false;
+
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    for (;;)
+    {
+        std::streampos pos = file.tellg();
+        if (pos == std::streampos(-1))
+            return false;
+
+        std::string text;
+        (void) std::getline(file, text);
+        if (! file.good())
+        {
+            m_index_tail = pos;                 /* a partial line, or EOF   */
+            break;
+        }
+        text = trim(text);
+        text = strip_comments(text);
+        if (! text.empty() && text[0] == '[')
+            m_index_tags[text].push_back(int(m_index_lines.size()));
+
+        m_index_lines.push_back(indexline{pos, text});
+    }
+    file.clear();
+    m_index_stream = &file;
+    return true;
+}
+
+void
+configfile::index_clear ()
+{
+    m_index_stream = nullptr;
+    m_index_lines.clear();
+    m_index_tail = 0;
+    m_index_tags.clear();
+    m_index_sections.clear();
+}
+
+/**
+ *  Finds the line starting at the given position.
+ *
+ * \return
+ *      Returns the index of the line, or -1 if the position is not at the
+ *      start of a line.
+ */
+
+int
+configfile::index_find_line (std::streampos position) const
+{
+    if (position == std::streampos(0))
+        return 0;
+
+    if (position == m_index_tail)
+        return int(m_index_lines.size());
+
+    auto li = std::lower_bound
+    (
+        m_index_lines.begin(), m_index_lines.end(), position,
+        [] (const indexline & il, std::streampos p)
+        {
+            return il.il_pos < p;
+        }
+    );
+    if (li != m_index_lines.end() && li->il_pos == position)
+        return int(li - m_index_lines.begin());
+
+    return (-1);
+}
+
+/**
+ *  Finds the first line at or after the start line that line_after() would
+ *  accept for the tag.  It uses strncompare(), so any section line that is
+ *  a leading part of the tag matches.
+ *
+ * \return
+ *      Returns the index of the line, -1 if there is no such line, or -2 if
+ *      the tag is not a section tag and the index cannot be used.
+ */
+
+int
+configfile::index_find_tag (const std::string & tag, int startline) const
+{
+    if (tag.empty() || tag[0] != '[')
+        return (-2);
+
+    int result = (-1);
+    for (size_t len = 1; len <= tag.length(); ++len)
+    {
+        auto ti = m_index_tags.find(tag.substr(0, len));
+        if (ti != m_index_tags.end())
+        {
+            const std::vector<int> & lines = ti->second;
+            auto li = std::lower_bound(lines.begin(), lines.end(), startline);
+            if (li != lines.end())
+            {
+                if (result < 0 || *li < result)
+                    result = *li;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ *  Gets the data lines of a section, indexing them by variable name the
+ *  first time.  Like next_data_line(), this skips empty and comment lines,
+ *  and stops at the next section line.
+ */
+
+const configfile::indexsection &
+configfile::index_section (int header)
+{
+    auto si = m_index_sections.find(header);
+    if (si == m_index_sections.end())
+    {
+        indexsection section;
+        int count = int(m_index_lines.size());
+        int li = header + 1;
+        for ( ; li < count; ++li)
+        {
+            const std::string & text = m_index_lines[li].il_text;
+            if (text.empty() || text[0] == '#')
+                continue;
+
+            if (text[0] == '[')
+                break;
+
+            auto epos = text.find_first_of("=");
+            if (epos != std::string::npos)
+            {
+                auto spos = text.find_first_of(" ");
+                if (spos > epos)
+                    spos = epos;
+
+                section.is_vars[text.substr(0, spos)].push_back(li);
+            }
+        }
+        section.is_end = li;
+        si = m_index_sections.emplace(header, std::move(section)).first;
+    }
+    return si->second;
+}
+
+/**
+ *  Leaves the stream and the line members as if the given line had just
+ *  been read by get_line(), counting lines from the start line.
+ */
+
+void
+configfile::index_seek (std::ifstream & file, int lineindex, int startline)
+{
+    const indexline & il = m_index_lines[lineindex];
+    int next = lineindex + 1;
+    m_line = il.il_text;
+    m_line_pos = il.il_pos;
+    m_line_number = lineindex - startline + 1;
+    file.clear();
+    if (next < int(m_index_lines.size()))
+        file.seekg(m_index_lines[next].il_pos, std::ios::beg);
+    else
+        file.seekg(m_index_tail, std::ios::beg);
+}
+
+/**
+ *  Leaves the stream and the line members as a scan that ran off the end of
+ *  the file would.  The last get_line() is actually done, to get the same
+ *  stream flags.
+ */
+
+void
+configfile::index_seek_end (std::ifstream & file, int startline)
+{
+    m_line_number = int(m_index_lines.size()) - startline;
+    file.clear();
+    file.seekg(m_index_tail, std::ios::beg);
+    (void) get_line(file);
+}
+
 /*
  *  Free functions.
  */
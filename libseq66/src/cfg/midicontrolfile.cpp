@@ -427,6 +427,7 @@ midicontrolfile::parse ()
         if (! result)
             file_error("Read failed", name());
     }
+    index_clear();                              /* the stream is going away */
     return result;
 }
 
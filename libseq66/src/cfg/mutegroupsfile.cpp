@@ -256,6 +256,7 @@ mutegroupsfile::parse ()
         file_error("Mutes open failed", name());
         result = false;
     }
+    index_clear();                              /* the stream is going away */
     return result;
 }
 
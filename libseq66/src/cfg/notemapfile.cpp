@@ -190,6 +190,7 @@ notemapfile::parse ()
         append_error_message(msg);
         result = false;
     }
+    index_clear();                              /* the stream is going away */
     return result;
 }
 
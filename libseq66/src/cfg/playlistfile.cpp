@@ -361,6 +361,7 @@ playlistfile::parse ()
         result = set_error_message(msg);
     }
     (void) play_list().reset_list(0, ! result); /* reset, not clear, if ok  */
+    index_clear();                              /* the stream is going away */
     return result;
 }
 
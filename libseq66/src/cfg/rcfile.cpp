@@ -303,8 +303,16 @@ rcfile::parse ()
         int buffersize = rc().jack_buffer_size();
         buffersize = get_integer(file, tag, "jack-buffer-size", 0);
         rc().jack_buffer_size(buffersize);
+
+        int lookahead = get_integer(file, tag, "jack-lookahead", 0);
+        rc().jack_lookahead(lookahead);
     }
 
+    tag = "[alsa-output]";
+
+    int lookahead = get_integer(file, tag, "lookahead-ms");
+    rc_ref().alsa_lookahead(lookahead);
+
     tag = "[manual-ports]";
 
     bool flag = get_boolean(file, tag, "virtual-ports");
@@ -1142,6 +1150,9 @@ rcfile::write ()
 "# jack-use-offset attempts to calculate timestamp offsets to improve accuracy\n"
 "# at high-buffer sizes. Still a work in progress.\n"
 "# jack-buffer-size allows for changing the frame-count, a power of 2.\n"
+"# jack-lookahead delays JACK MIDI output by this many periods (0 to 4), so\n"
+"# that each event can be placed at its exact frame in a later cycle, instead\n"
+"# of at the start of the current one. 0 (the default) disables it.\n"
 "\n[jack-transport]\n\n"
         << "transport-type = " << jacktransporttype << "\n"
         << "song-start-mode = " << rc_ref().song_mode_string() << "\n"
@@ -1150,6 +1161,15 @@ rcfile::write ()
     write_boolean(file, "jack-auto-connect", rc_ref().jack_auto_connect());
     write_boolean(file, "jack-use-offset", rc_ref().jack_use_offset());
     write_integer(file, "jack-buffer-size", rc_ref().jack_buffer_size());
+    write_integer(file, "jack-lookahead", rc_ref().jack_lookahead());
+    file << "\n"
+"# lookahead-ms, if greater than 0 (the maximum is 100), schedules ALSA output\n"
+"# on the ALSA sequencer queue this many milliseconds ahead, so that the kernel\n"
+"# delivers each event on time, at the cost of this much added latency. If 0\n"
+"# (the default), events are sent directly, when the output thread wakes.\n"
+"\n[alsa-output]\n\n"
+        ;
+    write_integer(file, "lookahead-ms", rc_ref().alsa_lookahead());
     file << "\n"
 "# 'auto-save-rc' sets automatic saving of the  'rc' and other files. If set,\n"
 "# many command-line settings are saved to configuration files.\n"
@@ -94,6 +94,8 @@ rcsettings::rcsettings () :
     m_jack_auto_connect         (true),
     m_jack_use_offset           (true),
     m_jack_buffer_size          (0),
+    m_jack_lookahead            (0),
+    m_alsa_lookahead            (0),
     m_song_start_mode           (sequence::playback::automatic),
     m_song_start_is_auto        (true),
     m_manual_ports              (false),
@@ -201,6 +203,8 @@ rcsettings::set_defaults ()
     m_jack_auto_connect         = true;
     m_jack_use_offset           = true;
     m_jack_buffer_size          = 0;
+    m_jack_lookahead            = 0;
+    m_alsa_lookahead            = 0;
     m_song_start_mode           = sequence::playback::automatic;
     m_song_start_is_auto        = true;
     m_manual_ports              = false;
@@ -50,7 +50,7 @@ namespace seq66
 
 static const int s_usr_legacy = 5;
 static const int s_usr_smf_1 = 8;
-static const int s_usr_file_version = 10;       /* from 9 on 2022-07-21     */
+static const int s_usr_file_version = 11;       /* from 10 on 2026-10-16    */
 
 /**
  *  Principal constructor.
@@ -66,6 +66,7 @@ static const int s_usr_file_version = 10;       /* from 9 on 2022-07-21     */
  *      8:  2021-10-06: Added "convert-to-smf-1".
  *      9:  2021-10-26: Added "swap-coordinates".
  *     10:  2022-07-21: Added "pattern-box-shown" (issue #78).
+ *     11:  2026-10-16: Added "undo-limit".
  *
  * \param name
  *      Provides the full file path specification to the configuration file.
@@ -449,6 +450,11 @@ usrfile::parse ()
         usr().progress_note_min_max(v, x);
         flag = get_boolean(file, tag, "lock-main-window");
         usr().lock_main_window(flag);
+        flag = get_boolean(file, tag, "grid-canvas");
+        usr().grid_canvas(flag);
+        s = get_variable(file, tag, "undo-limit");
+        if (! s.empty())
+            usr().undo_limit(string_to_int(s));
     }
     std::string s = get_variable(file, "[user-session]", "session");
     usr().session_manager(s);
@@ -871,6 +877,14 @@ usrfile::write ()
 "#\n"
 "# lock-main-window prevents the accidental change of size of the main\n"
 "# window.\n"
+"#\n"
+"# grid-canvas draws the live grid on one canvas, from cached pattern\n"
+"# images, instead of one button per slot. Uses less CPU for large grids.\n"
+"#\n"
+"# undo-limit sets the approximate memory, in megabytes, kept for undo/redo\n"
+"# of each pattern, including one copy of the pattern. The oldest steps are\n"
+"# dropped when it is exceeded.\n"
+"# Ranges from 0 (no limit) to 4096; the default is 64.\n"
         "\n[user-ui-tweaks]\n\n"
         ;
 
@@ -895,6 +909,8 @@ usrfile::write ()
     write_integer(file, "progress-note-min", usr().progress_note_min());
     write_integer(file, "progress-note-max", usr().progress_note_max());
     write_boolean(file, "lock-main-window", usr().lock_main_window());
+    write_boolean(file, "grid-canvas", usr().grid_canvas());
+    write_integer(file, "undo-limit", usr().undo_limit());
 
     /*
      * [user-session]
@@ -296,6 +296,14 @@ static const int c_fingerprint_size_min =  32;
 static const int c_fingerprint_size     =  32;
 static const int c_fingerprint_size_max = 128;
 
+/**
+ *  Limits for the undo journal of each pattern, in megabytes.
+ */
+
+static const int c_undo_limit_none      =    0;
+static const int c_undo_limit           =   64;
+static const int c_undo_limit_max       = 4096;
+
 /**
  *  Default constructor.
  */
@@ -368,6 +376,7 @@ usrsettings::usrsettings () :
     m_user_save_daemonize       (false),
     m_user_use_logfile          (false),
     m_user_option_logfile       (),
+    m_user_option_render        (),
     m_user_pdf_viewer           (),
     m_user_browser              (),
 
@@ -388,6 +397,8 @@ usrsettings::usrsettings () :
     m_progress_note_min         (0),
     m_progress_note_max         (127),
     m_lock_main_window          (false),
+    m_grid_canvas               (false),
+    m_undo_limit                (c_undo_limit),
     m_session_manager           (session::none),
     m_session_url               (),
     m_in_nsm_session            (false),
@@ -467,6 +478,7 @@ usrsettings::set_defaults ()
     m_user_save_daemonize = false;
     m_user_use_logfile = false;
     m_user_option_logfile.clear();
+    m_user_option_render.clear();
     m_user_pdf_viewer.clear();
     m_user_browser.clear();
     m_user_ui_key_height = c_def_key_height;
@@ -482,6 +494,8 @@ usrsettings::set_defaults ()
     m_progress_note_min = 0;
     m_progress_note_max = 127;
     m_lock_main_window = false;
+    m_grid_canvas = false;
+    m_undo_limit = c_undo_limit;
     m_session_manager = session::none;
     m_session_url.clear();
     m_in_nsm_session = false;
@@ -536,6 +550,13 @@ usrsettings::progress_note_min_max (int vmin, int vmax)
         m_progress_note_max = vmax;
 }
 
+void
+usrsettings::undo_limit (int megabytes)
+{
+    if (megabytes >= c_undo_limit_none && megabytes <= c_undo_limit_max)
+        m_undo_limit = megabytes;
+}
+
 void
 usrsettings::new_pattern_record_style (const std::string & style)
 {
@@ -77,6 +77,7 @@
 #include "cfg/settings.hpp"             /* seq66::rc() rcsettings getter    */
 #include "ctrl/keycontainer.hpp"        /* seq66::keycontainer class        */
 #include "ctrl/midicontrolin.hpp"       /* seq66::midicontrolin class       */
+#include "ctrl/opcontainer.hpp"         /* seq66::opcontainer class         */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -95,7 +96,9 @@ midicontrolin::midicontrolin (const std::string & name) :
     m_container         (),
     m_comments_block    (),
     m_control_status    (automation::ctrlstatus::none),
-    m_have_controls     (false)
+    m_have_controls     (false),
+    m_dispatch_index    (),
+    m_dispatch_list     ()
 {
    // no code
 }
@@ -136,6 +139,8 @@ midicontrolin::add (const midicontrol & mc)
     {
         if (! mc.blank())
             m_have_controls = true;
+
+        decompile();                        /* the table is now stale       */
     }
     else
     {
@@ -203,6 +208,97 @@ midicontrolin::control (const midicontrol::key & k) const
         return sm_midicontrol_dummy;
 }
 
+/**
+ *  Builds the flat dispatch table used by lookup().  For each status byte
+ *  (0x80 to 0xFF) and d0 value (0 to 127), the table holds the control that
+ *  control() would find, already paired with its operation.  As with
+ *  std::multimap::find(), if more than one control has the same status and
+ *  d0, the first one in the container is used.  Controls that are not
+ *  usable, or whose operation is not usable, are left out.
+ *
+ *  This function must be called again whenever the container or the
+ *  operations change.  Both add() and clear() empty the table, so that
+ *  compiled() reports the need.
+ *
+ * \param ops
+ *      The operations that the controls call.  The table holds pointers to
+ *      these operations, so the container must outlive the table or be
+ *      followed by another call to compile().
+ */
+
+void
+midicontrolin::compile (const opcontainer & ops)
+{
+    decompile();
+    m_dispatch_index.assign(0x80 * 0x80, short(-1));    /* -1 == no control */
+    if (have_controls())
+    {
+        for (const auto & mcpair : m_container)
+        {
+            const midicontrol::key & k = mcpair.first;
+            if (k.status() < 0x80 || k.d0() >= 0x80)
+                continue;
+
+            int slot = ((k.status() - 0x80) << 7) + k.d0();
+            if (m_dispatch_index[slot] != (-1))
+                continue;                       /* first one wins, as find() */
+
+            const midicontrol & mc = mcpair.second;
+            short entry = (-2);                 /* found, but not callable  */
+            if (mc.is_usable())
+            {
+                const midioperation & mop = ops.operation(mc.slot_number());
+                if (mop.is_usable())
+                {
+                    dispatch d;
+                    d.dp_operation = &mop;
+                    d.dp_action = mc.action_code();
+                    d.dp_d0 = mc.d0();
+                    d.dp_d1 = mc.d1();
+                    d.dp_index = mc.control_code();     /* in lieu of d1()  */
+                    d.dp_min_d1 = midibyte(mc.min_d1());
+                    d.dp_max_d1 = midibyte(mc.max_d1());
+                    d.dp_inverse = mc.inverse_active();
+                    entry = short(m_dispatch_list.size());
+                    m_dispatch_list.push_back(d);
+                }
+            }
+            m_dispatch_index[slot] = entry;
+        }
+    }
+}
+
+/**
+ *  Looks up the compiled control for the incoming event.  This replaces the
+ *  control() and opcontainer::operation() searches on the input thread with
+ *  one table access.  The source-buss check is the same as in control().
+ *
+ * \param ev
+ *      The incoming event.  Its status byte and d0 value select the entry.
+ *
+ * \return
+ *      Returns a pointer to the compiled control, or a null pointer if there
+ *      is none or the table has not been compiled.
+ */
+
+const midicontrolin::dispatch *
+midicontrolin::lookup (const event & ev) const
+{
+    const dispatch * result = nullptr;
+    midibyte status = ev.get_status();
+    midibyte d0 = ev.d0();
+    if (compiled() && status >= 0x80 && d0 < 0x80)
+    {
+        short entry = m_dispatch_index[((status - 0x80) << 7) + d0];
+        if (entry >= 0)
+        {
+            if (is_null_buss(nominal_buss()) || ev.input_bus() == true_buss())
+                result = &m_dispatch_list[entry];
+        }
+    }
+    return result;
+}
+
 /**
  *  The possible status are contained in automation::ctrlstatus, and consist
  *  of none, replace, snapshot, queue, keep_queue, oneshot, and learn. There
@@ -390,6 +390,47 @@ busarray::play (bussbyte bus, const event * e24, midibyte channel)
         m_container[bus].bus()->play(e24, channel);
 }
 
+/**
+ *  Turns off the notes still sounding on each active buss.  Each buss tracks
+ *  the notes it has played, so only the needed Note Offs are sent, plus the
+ *  All Notes Off and All Sound Off controllers on each channel.
+ *
+ * \param displaybuss
+ *      A buss to skip, such as the buss of a Launchpad whose lights should
+ *      not be cleared.
+ *
+ * \return
+ *      Returns the number of Note Offs sent.
+ */
+
+int
+busarray::panic (int displaybuss)
+{
+    int result = 0;
+    for (int bus = 0; bus < count(); ++bus)
+    {
+        if (bus != displaybuss && m_container[bus].active())
+            result += m_container[bus].bus()->panic();
+    }
+    return result;
+}
+
+/**
+ *  Counts the notes still sounding on all of the active busses.
+ */
+
+int
+busarray::active_note_count () const
+{
+    int result = 0;
+    for (const auto & bi : m_container)
+    {
+        if (bi.active())
+            result += bi.bus()->active_note_count();
+    }
+    return result;
+}
+
 /**
  *  Handles SysEx events; used for output busses.
  *
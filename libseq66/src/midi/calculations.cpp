@@ -410,7 +410,32 @@ pulses_to_time_string (midipulse p, const midi_timing & timinginfo)
 std::string
 pulses_to_time_string (midipulse p, midibpm bpm, int ppqn, bool showus)
 {
-    unsigned long microseconds = ticks_to_delta_time_us(p, bpm, ppqn);
+    return microseconds_to_time_string
+    (
+        ticks_to_delta_time_us(p, bpm, ppqn), showus
+    );
+}
+
+/**
+ *  Converts a time in microseconds into a string that represents
+ *  "hours:minutes:seconds.fraction".  Used by pulses_to_time_string(), and
+ *  by the performer to show the time of a song with tempo changes, as
+ *  looked up in its tempomap.
+ *
+ * \param us
+ *      Provides the time in microseconds.  Negative values are shown as 0.
+ *
+ * \param showus
+ *      If true (the default), shows the hundredths of a second as well.
+ *
+ * \return
+ *      Returns the time-string representation of the time.
+ */
+
+std::string
+microseconds_to_time_string (double us, bool showus)
+{
+    unsigned long microseconds = us > 0.0 ? (unsigned long)(us) : 0UL ;
     int seconds = int(microseconds / 1000000UL);
     int minutes = seconds / 60;
     int hours = seconds / (60 * 60);
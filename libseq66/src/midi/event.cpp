@@ -92,6 +92,13 @@ namespace seq66
  * --------------------------------------------------------------
  */
 
+/**
+ *  The buffer that get_sysex() returns for an event without SysEx or Meta
+ *  data.
+ */
+
+const event::sysex event::sm_no_sysex;
+
 /**
  *  This constructor simply initializes all of the class members to default
  *  values.
@@ -103,7 +110,7 @@ event::event () :
     m_status        (EVENT_NOTE_OFF),       /* note-off, channel 0  */
     m_channel       (null_channel()),       /* 0x80                 */
     m_data          (),                     /* a two-element array  */
-    m_sysex         (),                     /* an std::vector       */
+    m_sysex         (),                     /* no SysEx/Meta data   */
     m_linked        (nullptr),
     m_has_link      (false),
     m_selected      (false),
@@ -138,7 +145,7 @@ event::event (midipulse tstamp, midibyte status, midibyte d0, midibyte d1) :
     m_status        (status),               /* keep the channel 2021-08-09  */
     m_channel       (mask_channel(status)),
     m_data          (),                     /* two-element array, midibytes */
-    m_sysex         (),                     /* an std::vector of midibytes  */
+    m_sysex         (),                     /* no SysEx/Meta data yet       */
     m_linked        (nullptr),
     m_has_link      (false),
     m_selected      (false),
@@ -158,14 +165,14 @@ event::event (midipulse tstamp, midibpm tempo) :
     m_status        (EVENT_MIDI_META),
     m_channel       (EVENT_META_SET_TEMPO),
     m_data          (),                     /* two-element array, midibytes */
-    m_sysex         (),                     /* an std::vector of midibytes  */
+    m_sysex         (),                     /* no SysEx/Meta data yet       */
     m_linked        (nullptr),
     m_has_link      (false),
     m_selected      (false),
     m_marked        (false),
     m_painted       (false)
 {
-    set_tempo(tempo);                       /* fills the m_sysex vector     */
+    set_tempo(tempo);                       /* fills the m_sysex buffer     */
 }
 
 /**
@@ -185,7 +192,7 @@ event::event
     m_status        (notekind),
     m_channel       (channel),
     m_data          (),                     /* two-element array, midibytes */
-    m_sysex         (),                     /* an std::vector of midibytes  */
+    m_sysex         (),                     /* no SysEx/Meta data yet       */
     m_linked        (nullptr),
     m_has_link      (false),
     m_selected      (false),
@@ -220,10 +227,9 @@ event::event
  *      eventlist::verify_and_link() function.
  *
  * \warning
- *      This function does not yet copy the SysEx data.  The inclusion
- *      of SysEx events was not complete in Seq24, and it is still not
- *      complete in Seq66.  Nor does it currently bother with the
- *      links, as noted above.
+ *      The SysEx data is shared with the source, not copied; see
+ *      sysex_data().  The inclusion of SysEx events was not complete in
+ *      Seq24, and it is still not complete in Seq66.
  *
  * \param rhs
  *      Provides the event object to be copied.
@@ -235,7 +241,7 @@ event::event (const event & rhs) :
     m_status        (rhs.m_status),
     m_channel       (rhs.m_channel),
     m_data          (),                     /* a two-element array      */
-    m_sysex         (rhs.m_sysex),          /* copies a vector of data  */
+    m_sysex         (rhs.m_sysex),          /* shares the data buffer   */
     m_linked        (rhs.m_linked),         /* for vector implemenation */
     m_has_link      (rhs.m_has_link),       /* m_linked has 2 linkers!  */
     m_selected      (rhs.m_selected),
@@ -290,7 +296,7 @@ event::operator = (const event & rhs)
 /**
  *  This destructor explicitly deletes m_sysex and sets it to null.
  *  The reset_sysex() function does what we need.  But now that m_sysex is a
- *  vector, no action is needed.
+ *  shared pointer, no action is needed.
  */
 
 event::~event ()
@@ -333,6 +339,25 @@ event::prep_for_send (midipulse tick, const event & source)
     m_sysex         = source.m_sysex;
 }
 
+/**
+ *  The same as the other prep_for_send(), but for an event taken from an
+ *  eventpack, which holds only these fields.  The caller sets the SysEx
+ *  payload, if any.
+ */
+
+void
+event::prep_for_send
+(
+    midipulse tick, midibyte status, midibyte d0, midibyte d1
+)
+{
+    m_timestamp     = tick;
+    m_status        = status;
+    m_data[0]       = d0;
+    m_data[1]       = d1;
+    m_sysex.reset();
+}
+
 /**
  *  If the current timestamp equal the event's timestamp, then this
  *  function returns true if the current rank is less than the event's
@@ -413,6 +438,28 @@ event::match (const event & target) const
     return result;
 }
 
+/**
+ *  Indicates that the events have the same content: buss, time-stamp,
+ *  status, channel, data bytes, and SysEx/Meta data.  Unlike match(), this
+ *  is exact.  The link, selection, mark, and paint status are ignored, as
+ *  they are not restored by an undo.  Used by the undo journal.
+ */
+
+bool
+event::same (const event & rhs) const
+{
+    return
+    (
+        m_timestamp == rhs.m_timestamp &&
+        m_status == rhs.m_status &&
+        m_channel == rhs.m_channel &&
+        m_data[0] == rhs.m_data[0] &&
+        m_data[1] == rhs.m_data[1] &&
+        m_input_buss == rhs.m_input_buss &&
+        get_sysex() == rhs.get_sysex()
+    );
+}
+
 /**
  *  Returns true if the event's status is *not* a control-change, but does
  *  match the given status OR if the event's status is a control-change that
@@ -738,18 +785,15 @@ std::string
 event::get_text () const
 {
     std::string result;
-    size_t dsize = m_sysex.size();
-    for (size_t i = 0; i < dsize; ++i)
-    {
-        char c = char(m_sysex[i]);
-        result.push_back(c);
-    }
+    for (auto b : get_sysex())
+        result.push_back(char(b));
+
     return result;
 }
 
 /**
  *  This base-class version unconditionally loads bytes into the
- *  m_sysex vector.
+ *  m_sysex buffer.
  */
 
 bool
@@ -758,9 +802,8 @@ event::set_text (const std::string & s)
     bool result = ! s.empty();
     if (result)
     {
-        m_sysex.clear();
-        for (const auto c : s)
-            m_sysex.push_back(c);
+        sysex & sx = sysex_data();
+        sx.assign(s.cbegin(), s.cend());
     }
     return result;
 }
@@ -803,8 +846,8 @@ event::append_meta_data (midibyte metatype, const midibyte * data, int dsize)
     if (result)
     {
         set_meta_status(metatype);
-        for (int i = 0; i < dsize; ++i)
-            m_sysex.push_back(data[i]);
+        sysex & sx = sysex_data();
+        sx.insert(sx.end(), data, data + dsize);
     }
     else
     {
@@ -836,8 +879,8 @@ event::append_meta_data (midibyte metatype, const midibytes & data)
     if (result)
     {
         set_meta_status(metatype);
-        for (int i = 0; i < dsize; ++i)
-             m_sysex.push_back(data[i]);
+        sysex & sx = sysex_data();
+        sx.insert(sx.end(), data.cbegin(), data.cend());
     }
     else
     {
@@ -860,15 +903,15 @@ event::append_meta_data (midibyte metatype, const midibytes & data)
 bool
 event::append_sysex_byte (midibyte data)
 {
-    m_sysex.push_back(data);
+    sysex_data().push_back(data);
     return data != EVENT_MIDI_SYSEX_END;
 }
 
 /**
  *  Appends SYSEX data to a new buffer.  We now use a vector instead of an
  *  array, so there is no need for reallocation and copying of the current
- *  SYSEX data.  The data represented by data and dsize is appended to that
- *  data buffer.
+ *  SYSEX data, unless it is shared with a copy of this event.  The data
+ *  represented by data and dsize is appended to that data buffer.
  *
  * \param data
  *      Provides the additional SysEx/Meta data.  If not provided, nothing is
@@ -889,8 +932,8 @@ event::append_sysex (const midibyte * data, int dsize)
     bool result = not_nullptr(data) && (dsize > 0);
     if (result)
     {
-        for (int i = 0; i < dsize; ++i)
-            m_sysex.push_back(data[i]);
+        sysex & sx = sysex_data();
+        sx.insert(sx.end(), data, data + dsize);
     }
     else
     {
@@ -905,8 +948,8 @@ event::append_sysex (const midibytes & data)
     bool result = ! data.empty();
     if (result)
     {
-        for (auto b : data)
-            m_sysex.push_back(b);
+        sysex & sx = sysex_data();
+        sx.insert(sx.end(), data.cbegin(), data.cend());
     }
     else
     {
@@ -947,9 +990,30 @@ void
 event::set_sysex_size (int len)
 {
     if (len == 0)
-        m_sysex.clear();
+        m_sysex.reset();
     else if (len > 0)
-        m_sysex.resize(len);
+        sysex_data().resize(len);
+}
+
+/**
+ *  Gets the SysEx/Meta buffer for modification.  If the buffer is shared
+ *  with copies of this event, this event gets its own copy first, so that
+ *  the change does not leak into an undo entry, the clipboard, or another
+ *  pattern.
+ *
+ * \return
+ *      Returns a reference to a buffer that only this event uses.
+ */
+
+event::sysex &
+event::sysex_data ()
+{
+    if (! m_sysex)
+        m_sysex = std::make_shared<sysex>();
+    else if (m_sysex.use_count() > 1)
+        m_sysex = std::make_shared<sysex>(*m_sysex);
+
+    return *m_sysex;
 }
 
 /**
@@ -1049,7 +1113,7 @@ event::to_string () const
             if (use_linefeeds && (i % 16) == 0)
                 result += "\n         ";
 
-            (void) snprintf(tmp, sizeof tmp, "%02X ", m_sysex[i]);
+            (void) snprintf(tmp, sizeof tmp, "%02X ", get_sysex(i));
             result += tmp;
         }
         result += "\n";
@@ -1137,9 +1201,9 @@ event::tempo () const
     if (is_tempo() && sysex_size() == 3)
     {
         midibyte b[3];
-        b[0] = m_sysex[0];                  /* convert vector to array type */
-        b[1] = m_sysex[1];
-        b[2] = m_sysex[2];
+        b[0] = get_sysex(0);                /* convert vector to array type */
+        b[1] = get_sysex(1);
+        b[2] = get_sysex(2);
         result = bpm_from_bytes(b);
     }
     return result;
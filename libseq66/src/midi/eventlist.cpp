@@ -32,7 +32,7 @@
  *  tempo) have been added to the container.
  */
 
-#include <algorithm>                    /* std::sort(), std::merge()        */
+#include <algorithm>                    /* std::sort(), std::inplace_merge()*/
 
 #include "cfg/settings.hpp"             /* seq66::usr()                     */
 #include "midi/eventlist.hpp"           /* seq66::eventlist                 */
@@ -139,6 +139,34 @@ eventlist::get_max_timestamp () const
     return result;
 }
 
+/**
+ *  Finds the first event whose timestamp is not less than the given tick.
+ *  This is a binary search, so the events must be sorted.  Used to
+ *  (re)position the playback cursor of the sequence.  It is static so that it
+ *  can be applied to the playback snapshot of the sequence.
+ *
+ * \param evs
+ *      Provides the sorted events to search.
+ *
+ * \param tick
+ *      Provides the timestamp to look for, relative to the start of the
+ *      pattern.
+ *
+ * \return
+ *      Returns the iterator to the first event at or after the tick, or end()
+ *      if there is no such event.
+ */
+
+event::const_iterator
+eventlist::lower_bound (const event::buffer & evs, midipulse tick)
+{
+    return std::lower_bound
+    (
+        evs.cbegin(), evs.cend(), tick,
+        [] (const event & e, midipulse t) { return e.timestamp() < t; }
+    );
+}
+
 /**
  *  Adds an event to the internal event list without sorting.  It is a
  *  wrapper, wrapper for insert() or push_front(), with an option to call
@@ -178,6 +206,18 @@ bool
 eventlist::append (const event & e)
 {
     m_events.push_back(e);                      /* std::vector operation    */
+    note_flags(e);
+    return true;
+}
+
+/**
+ *  Updates the modification flag and the tempo/signature flags for an event
+ *  that has just been added.
+ */
+
+void
+eventlist::note_flags (const event & e)
+{
     m_is_modified = true;
     if (e.is_tempo())
         m_has_tempo = true;
@@ -187,52 +227,53 @@ eventlist::append (const event & e)
 
     if (e.is_key_signature())
         m_has_key_signature = true;
-
-    return true;
 }
 
 /**
  *  An internal function to add events to a temporary list.  Used in
- *  quantization and tightening operations.
+ *  quantization and tightening operations.  The list is kept sorted, so a
+ *  binary search finds the insertion point.
  */
 
 bool
 eventlist::add (event::buffer & evlist, const event & e)
 {
-    evlist.push_back(e);                        /* std::vector operation    */
-    std::sort(evlist.begin(), evlist.end());
+    auto pos = std::upper_bound(evlist.begin(), evlist.end(), e);
+    evlist.insert(pos, e);                      /* std::vector operation    */
     return true;
 }
 
 /**
- *  Adds an event to the internal event list in a sorted manner.  Note
- *  that, for speed, it is better to call append() for each event, and
- *  then later sort them.
+ *  Adds an event to the internal event list in a sorted manner.  The list is
+ *  already sorted, so we do a binary search for the insertion point (after
+ *  any equivalent events) rather than appending and re-sorting the whole
+ *  list.  Note that, for loading a lot of events, it is still better to call
+ *  append() for each event, and then sort them once.
  *
  * \param e
  *      Provides the event to be added to the list.
  *
  * \return
  *      Returns true.  We assume the insertion succeeded, and no longer
- *      care about an increment in container size.  It's a multimap, so it
- *      always inserts, and if we don't have memory left, all bets are off
- *      anyway.
+ *      care about an increment in container size.
  */
 
 bool
 eventlist::add (const event & e)
 {
-    bool result = append(e);
-    if (result)
-        sort();                         /* by time-stamp and "rank" */
-
-    return result;
+    auto pos = std::upper_bound(m_events.begin(), m_events.end(), e);
+    m_action_in_progress = true;
+    m_events.insert(pos, e);                    /* invalidates iterators    */
+    m_action_in_progress = false;
+    note_flags(e);
+    return true;
 }
 
 /**
  *  Sorts the event list.  For the vector, equivalent elements are not
  *  guaranteed to keep their original relative order [see
- *  std::stable_sort(), which we could try at some point].
+ *  std::stable_sort(), which we could try at some point].  An
+ *  already-sorted list, the usual case, costs only a linear check.
  *
  *  This method is probably flawed.
  */
@@ -240,9 +281,113 @@ eventlist::add (const event & e)
 void
 eventlist::sort ()
 {
-    m_action_in_progress = true;
-    std::sort(m_events.begin(), m_events.end());
-    m_action_in_progress = false;
+    if (! std::is_sorted(m_events.begin(), m_events.end()))
+    {
+        m_action_in_progress = true;
+        std::sort(m_events.begin(), m_events.end());
+        m_action_in_progress = false;
+    }
+}
+
+/**
+ *  Merges a batch of events, such as the notes recorded during one burst of
+ *  input, into the sorted event list, and relinks the notes.  The batch is
+ *  sorted (it is small and usually already in order), appended, and merged
+ *  in place from the first position it touches.  Events before that
+ *  position do not move, so only the notes from there on are relinked;
+ *  see relink_from().
+ *
+ * \param [inout] evlist
+ *      Provides the events to merge.  It is emptied, but keeps its capacity
+ *      for the next batch.
+ *
+ * \return
+ *      Returns true if any events were merged.
+ */
+
+bool
+eventlist::merge_sorted (event::buffer & evlist)
+{
+    bool result = ! evlist.empty();
+    if (result)
+    {
+        std::stable_sort(evlist.begin(), evlist.end());
+        m_action_in_progress = true;
+
+        const event * olddata = m_events.data();
+        std::size_t oldsize = m_events.size();
+        std::size_t first = std::size_t
+        (
+            std::upper_bound
+            (
+                m_events.begin(), m_events.end(), evlist.front()
+            ) - m_events.begin()
+        );
+        m_events.insert(m_events.end(), evlist.begin(), evlist.end());
+        std::inplace_merge
+        (
+            m_events.begin() + first,
+            m_events.begin() + oldsize, m_events.end()
+        );
+        m_action_in_progress = false;
+        for (const auto & e : evlist)
+            note_flags(e);
+
+        evlist.clear();
+        if (m_events.data() != olddata)         /* reallocated, links stale */
+            first = 0;
+
+        relink_from(first);
+    }
+    return result;
+}
+
+/**
+ *  Relinks the notes after the events from the given index on have moved.
+ *  The events before that index keep their links, except those linked into
+ *  the moved range, which are stale.  The linking pass then starts at the
+ *  first unlinked note, which is normally near the first recorded event,
+ *  rather than at the start of the pattern.  If it would start at the first
+ *  event anyway, all of the links are rebuilt, as in verify_and_link().
+ *
+ * \param first
+ *      The index of the first event that moved.  If 0, all of the events
+ *      are relinked.
+ */
+
+void
+eventlist::relink_from (std::size_t first)
+{
+    std::size_t start = first < m_events.size() ? first : 0 ;
+    if (start > 0)
+    {
+        const event * moved = &m_events[first];
+        for (std::size_t i = 0; i < first; ++i)
+        {
+            event & e = m_events[i];
+            if (e.is_linked())
+            {
+                if (&(*e.link()) < moved)
+                    continue;
+
+                e.clear_links();                    /* partner has moved    */
+            }
+            if ((e.is_note_on() || e.is_note_off()) && i < start)
+                start = i;
+        }
+    }
+    if (start > 0)
+    {
+        for (auto ev = m_events.begin() + first; ev != m_events.end(); ++ev)
+            ev->clear_links();
+
+        link_new(false, start);
+    }
+    else
+    {
+        clear_links();                      /* link_new() may sort them     */
+        link_new();
+    }
 }
 
 /**
@@ -308,10 +453,12 @@ eventlist::merge (const eventlist & el, bool presort)
 }
 
 /**
- *  Links a new event.  This function checks for a note on, then look for
- *  its note off.  This function is provided in the eventlist because it
- *  does not depend on any external data.  Also note that any desired
- *  thread-safety must be provided by the caller.
+ *  Links the unlinked notes.  Each Note On is linked to the first free Note
+ *  Off of the same channel and note that follows it.  This is done in one
+ *  pass, with a queue of pending Note Ons per (channel, note), so it is
+ *  linear in the number of events.  This function is provided in the
+ *  eventlist because it does not depend on any external data.  Also note
+ *  that any desired thread-safety must be provided by the caller.
  *
  * Link wraparound:
  *
@@ -333,44 +480,72 @@ eventlist::merge (const eventlist & el, bool presort)
  * \param wrap
  *      Optionally (the default is false) wrap when relinking.  Can be used to
  *      override usr().new_pattern_wraparound().  Defaults to false.
+ *
+ * \param start
+ *      The index of the first event to consider.  Events before it are
+ *      assumed to be linked already.  If not 0, the list must already be
+ *      sorted.  Defaults to 0.
  */
 
 void
-eventlist::link_new (bool wrap)
+eventlist::link_new (bool wrap, std::size_t start)
 {
+    /*
+     * One queue of pending Note Ons per channel and note.  Ons are linked in
+     * order, each to the first free Note Off after it, which is what the old
+     * nested search did, but in one pass.  The queues are kept per thread
+     * and reused, so that relinking does not allocate once they have grown;
+     * keeping them per eventlist would cost every pattern the 2048 queues.
+     */
+
+    static const int s_key_count = 16 * c_midibyte_data_max;
+    using pending = std::vector<event::iterator>;
+    static thread_local std::vector<pending> ons(s_key_count);
+    static thread_local std::vector<pending> offs(s_key_count);
+    static thread_local std::vector<std::size_t> heads(s_key_count);
     bool wrap_em = m_link_wraparound || wrap;       /* a Stazed extension   */
-    sort();                                         /* IMPORTANT!           */
-    for (auto on = m_events.begin(); on != m_events.end(); ++on)
+    for (int k = 0; k < s_key_count; ++k)
     {
-        if (on->on_linkable())
+        ons[k].clear();
+        offs[k].clear();
+        heads[k] = 0;
+    }
+    if (start == 0)
+        sort();                                     /* IMPORTANT!           */
+
+    for (auto ev = m_events.begin() + start; ev != m_events.end(); ++ev)
+    {
+        if (ev->on_linkable())
         {
-            bool endfound = false;                  /* end-of-note flag     */
-            auto off = on;                          /* point to note on     */
-            ++off;                                  /* get next element     */
-            while (off != m_events.end())
-            {
-                endfound = link_notes(on, off);     /* calls off_linkable() */
-                if (endfound)
-                    break;
+            ons[link_key(*ev)].push_back(ev);
+        }
+        else if (ev->off_linkable())
+        {
+            int k = link_key(*ev);
+            if (heads[k] < ons[k].size())
+                (void) link_notes(ons[k][heads[k]++], ev);
+            else
+                offs[k].push_back(ev);              /* a wraparound off?    */
+        }
+    }
 
-                ++off;
-            }
-            if (! endfound)
+    /*
+     * Second pass over the leftovers.  Any unmatched Note Off of a key lies
+     * before all of its unmatched Note Ons, so we pair them in order.
+     */
+
+    for (int k = 0; k < s_key_count; ++k)
+    {
+        std::size_t offcount = offs[k].size();
+        for (std::size_t o = 0; o < offcount && heads[k] < ons[k].size(); ++o)
+        {
+            event::iterator on = ons[k][heads[k]++];
+            event::iterator off = offs[k][o];
+            (void) link_notes(on, off);
+            if (! wrap_em)
             {
-                off = m_events.begin();
-                while (off != on)
-                {
-                    if (link_notes(on, off))
-                    {
-                        if (! wrap_em)
-                        {
-                            if (off->timestamp() < on->timestamp())
-                                off->set_timestamp(get_length() - 1);
-                        }
-                        break;
-                    }
-                    ++off;
-                }
+                if (off->timestamp() < on->timestamp())
+                    off->set_timestamp(get_length() - 1);
             }
         }
     }
@@ -1222,13 +1397,12 @@ eventlist::jitter_notes (int jitter)
     return result;
 }
 
-#if defined SEQ66_USE_FILL_TIME_SIG_AND_TEMPO
-
 /**
  *  Scans the event-list for any tempo or time_signature events.
  *  The user may have deleted them and is depending on a setting made in the
  *  user-interface.  So we must set/unset the flags before saving.  This check
- *  was added to fix issue #141.
+ *  was added to fix issue #141.  Also used after an undo or redo, which
+ *  replaces only part of the list.
  */
 
 void
@@ -1248,8 +1422,6 @@ eventlist::scan_meta_events ()
     }
 }
 
-#endif  // SEQ66_USE_FILL_TIME_SIG_AND_TEMPO
-
 /**
  *  This function tries to link tempo events.  Native support for temp tracks
  *  is a new feature of seq66.  These links are only in one direction: forward
@@ -2287,7 +2459,7 @@ eventlist::copy_selected (eventlist & clipbd)
     for (auto & e : m_events)
     {
         if (e.is_selected())
-            clipbd.add(e);                              /* sorts every time */
+            clipbd.add(e);                              /* binary insertion */
     }
     if (! clipbd.empty())
     {
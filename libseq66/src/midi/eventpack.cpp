@@ -0,0 +1,212 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          eventpack.cpp
+ *
+ *  This module defines the packed playback copy of the events of a pattern.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Formerly the playback snapshot of a sequence was a plain copy of its
+ *  event list, which also copied every SysEx vector, and made play() step
+ *  through the editing fields of each event.
+ */
+
+#include <algorithm>                    /* std::lower_bound()               */
+
+#include "midi/calculations.hpp"        /* seq66::bpm_from_bytes()          */
+#include "midi/eventpack.hpp"           /* seq66::eventpack class           */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Packs the events.  Two passes are made, so that the buffers are
+ *  allocated only once.
+ *
+ * \param evs
+ *      The events to pack, sorted by timestamp, as held by eventlist.
+ */
+
+eventpack::eventpack (const event::buffer & evs) :
+    m_records       (),
+    m_payloads      (),
+    m_payload_bytes ()
+{
+    std::size_t excount = 0;
+    std::size_t exbytes = 0;
+    for (const auto & e : evs)
+    {
+        if (e.is_ex_data())
+        {
+            ++excount;
+            exbytes += e.sysex_size();
+        }
+    }
+    m_records.reserve(evs.size());
+    m_payloads.reserve(excount);
+    m_payload_bytes.reserve(exbytes);
+    for (const auto & e : evs)
+    {
+        record r;
+        r.r_tick = e.timestamp();
+        r.r_status = e.get_status();
+        r.r_channel = e.channel();
+        r.r_d0 = e.d0();
+        r.r_d1 = e.d1();
+        r.r_payload = 0;
+        if (e.is_note_on_linked())
+            r.r_d0 |= c_linked_bit;
+
+        if (e.is_ex_data())
+        {
+            span s;
+            s.s_offset = std::uint32_t(m_payload_bytes.size());
+            s.s_size = std::uint32_t(e.sysex_size());
+            r.r_payload = std::uint32_t(m_payloads.size());
+            m_payloads.push_back(s);
+            m_payload_bytes.insert
+            (
+                m_payload_bytes.end(),
+                e.get_sysex().cbegin(), e.get_sysex().cend()
+            );
+        }
+        m_records.push_back(r);
+    }
+}
+
+/**
+ * \return
+ *      Returns the first record at or after the tick, or end() if there is
+ *      no such record.
+ */
+
+eventpack::const_iterator
+eventpack::lower_bound (midipulse tick) const
+{
+    return std::lower_bound
+    (
+        m_records.cbegin(), m_records.cend(), tick,
+        [] (const record & r, midipulse t) { return r.r_tick < t; }
+    );
+}
+
+/**
+ * \return
+ *      Returns a pointer to the SysEx or Meta bytes of the record, or a null
+ *      pointer if it has none.
+ */
+
+const midibyte *
+eventpack::payload (const record & r) const
+{
+    if (r.is_ex_data() && r.r_payload < m_payloads.size())
+    {
+        const span & s = m_payloads[r.r_payload];
+        if (s.s_size > 0)
+            return &m_payload_bytes[s.s_offset];
+    }
+    return nullptr;
+}
+
+int
+eventpack::payload_size (const record & r) const
+{
+    if (r.is_ex_data() && r.r_payload < m_payloads.size())
+        return int(m_payloads[r.r_payload].s_size);
+
+    return 0;
+}
+
+/**
+ *  The same as event::tempo(), for a record.
+ */
+
+midibpm
+eventpack::tempo (const record & r) const
+{
+    midibpm result = 0.0;
+    if (r.is_tempo() && payload_size(r) == 3)
+    {
+        const midibyte * p = payload(r);
+        midibyte b[3];
+        b[0] = p[0];
+        b[1] = p[1];
+        b[2] = p[2];
+        result = bpm_from_bytes(b);
+    }
+    return result;
+}
+
+/**
+ *  Fills in an event for sending, as event::prep_for_send() does for an
+ *  event.
+ *
+ * \param r
+ *      The record to send.
+ *
+ * \param tick
+ *      The playback time of the event.
+ *
+ * \param [out] evout
+ *      The event to fill.
+ *
+ * \param transpose
+ *      The transposition to apply to a note, if any.  If the note would go
+ *      out of range, it is not changed, as in event::transpose_note().
+ */
+
+void
+eventpack::unpack
+(
+    const record & r, midipulse tick, event & evout, int transpose
+) const
+{
+    midibyte d0 = r.d0();
+    if (transpose != 0 && r.is_note())
+    {
+        int note = int(d0) + transpose;
+        if (note >= 0 && note < c_midibyte_data_max)
+            d0 = midibyte(note);
+    }
+    evout.prep_for_send(tick, r.r_status, d0, r.r_d1);
+    if (r.is_ex_data())
+    {
+        int sz = payload_size(r);
+        if (sz > 0)
+            (void) evout.set_sysex(payload(r), sz);
+    }
+}
+
+}           // namespace seq66
+
+/*
+ * eventpack.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
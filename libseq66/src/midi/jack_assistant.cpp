@@ -1291,6 +1291,10 @@ jack_assistant::set_beats_per_minute (midibpm bpminute)
  *  Helgrind complains about a possible data race involving
  *  jack_transport_locate() when starting playing.
  *
+ *  In Song mode, if the song has tempo changes, the frame is looked up in the
+ *  performer's tempo map, instead of assuming the current tempo all the way
+ *  from the start of the song.
+ *
  * \param songmode
  *      True if the caller wants to position while in Song mode.
  *
@@ -1312,16 +1316,25 @@ void
 jack_assistant::position (bool songmode, midipulse tick)
 {
 #if defined SEQ66_JACK_SUPPORT
-    if (songmode)                               /* master in song mode  */
-        tick = is_null_midipulse(tick) ? 0 : tick * c_jack_factor ;
+    uint64_t jack_frame;
+    tempomap::pointer tmap = parent().tempo_map();
+    if (songmode && ! is_null_midipulse(tick) && ! tmap->empty())
+    {
+        jack_frame = uint64_t(tmap->tick_to_frame(tick, m_frame_rate));
+    }
     else
-        tick = 0;
+    {
+        if (songmode)                           /* master in song mode  */
+            tick = is_null_midipulse(tick) ? 0 : tick * c_jack_factor ;
+        else
+            tick = 0;
 
-    int ticks_per_beat = m_ppqn * c_jack_factor;
-    int beats_per_minute = parent().get_beats_per_minute();
-    uint64_t tick_rate = (uint64_t(m_frame_rate) * tick * 60.0);
-    long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
-    uint64_t jack_frame = tick_rate / tpb_bpm;
+        int ticks_per_beat = m_ppqn * c_jack_factor;
+        int beats_per_minute = parent().get_beats_per_minute();
+        uint64_t tick_rate = (uint64_t(m_frame_rate) * tick * 60.0);
+        long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
+        jack_frame = tick_rate / tpb_bpm;
+    }
     if (is_master())
     {
         /*
@@ -1364,6 +1377,11 @@ jack_assistant::set_position (midipulse tick)
     pos.beat_type = m_beat_width;
     pos.ticks_per_beat = m_ppqn;                        /* only at first    */
     pos.beats_per_minute = get_beats_per_minute();
+
+    tempomap::pointer tmap = parent().tempo_map();
+    if (parent().song_mode() && ! tmap->empty())
+        pos.beats_per_minute = tmap->bpm(tick);         /* tempo at tick    */
+
     jack_set_position(m_jack_client, pos, tick);
 }
 
@@ -2138,11 +2156,23 @@ jack_timebase_callback
     if (new_pos || not_bbt)
     {
         /*
-         * This code is hit at Start and Stop actions from all clients.
+         * This code is hit at Start and Stop actions from all clients.  With
+         * tempo changes in the song, the tick comes from the tempo map.
          */
 
-        double minute = pos->frame / framerate;
-        long abs_tick = long(minute * ticks_per_minute);
+        long abs_tick;
+        tempomap::pointer tmap = jack->parent().tempo_map();
+        if (jack->parent().song_mode() && ! tmap->empty())
+        {
+            midipulse t = tmap->frame_to_tick(pos->frame, pos->frame_rate);
+            abs_tick = long(t * c_jack_factor);
+            pos->beats_per_minute = tmap->bpm(t);
+        }
+        else
+        {
+            double minute = pos->frame / framerate;
+            abs_tick = long(minute * ticks_per_minute);
+        }
         long abs_beat = long(abs_tick / pos->ticks_per_beat);
         pos->bar = int(abs_beat / pos->beats_per_bar);
         pos->beat = int(abs_beat - (pos->bar * pos->beats_per_bar) + 1);
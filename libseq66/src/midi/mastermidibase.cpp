@@ -79,6 +79,7 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
+    m_capture           (nullptr),
     m_mutex             ()
 {
     // Empty body now
@@ -263,36 +264,42 @@ void
 mastermidibase::flush ()
 {
     automutex locker(m_mutex);
-    api_flush();
+    if (is_nullptr(m_capture))
+        api_flush();
 }
 
 /**
  *  Stops all notes on all channels on all busses.  Adapted from Oli Kester's
- *  Kepler34 project.  Whether the buss is active or not is ultimately checked
- *  in the busarray::play() function.  A bit wasteful, but do we really care?
+ *  Kepler34 project.  Kepler34 sends a Note Off for every note on every
+ *  channel of every buss, which floods slow ports for seconds.  Each output
+ *  buss now tracks the notes it has turned on, so only those are turned off,
+ *  followed by All Notes Off and All Sound Off on each channel for any notes
+ *  it did not track (see midibase::panic()).  Whether the buss is active or
+ *  not is checked in busarray::panic().
  */
 
 void
 mastermidibase::panic (int displaybuss)
 {
     automutex locker(m_mutex);
-    for (int bus = 0; bus < c_busscount_max; ++bus)
-    {
-        if (bus == displaybuss)             /* do not clear the Launchpad   */
-            continue;
-
-        for (int channel = 0; channel < c_midichannel_max; ++channel)
-        {
-            for (int note = 0; note < c_midibyte_data_max; ++note)
-            {
-                event e(0, EVENT_NOTE_OFF, channel, note, 0);
-                m_outbus_array.play(bus, &e, channel);
-            }
-        }
-    }
+    (void) m_outbus_array.panic(displaybuss);   /* do not clear Launchpad   */
     api_flush();
 }
 
+/**
+ *  Counts the notes that have been played on the output busses and not yet
+ *  turned off, i.e. the notes that panic() would turn off.
+ *
+ * \threadsafe
+ */
+
+int
+mastermidibase::active_note_count () const
+{
+    automutex locker(m_mutex);
+    return m_outbus_array.active_note_count();
+}
+
 /**
  *  Handle the sending of SYSEX events.  There's currently no
  *  implementation-specific API function for this call.
@@ -307,7 +314,30 @@ void
 mastermidibase::sysex (bussbyte bus, const event * ev)
 {
     automutex locker(m_mutex);
-    m_outbus_array.sysex(bus, ev);
+    if (not_nullptr(m_capture))
+        m_capture->emplace_back(bus, midibyte(null_channel()), *ev);
+    else
+        m_outbus_array.sysex(bus, ev);
+}
+
+/**
+ *  Diverts (or stops diverting) the output events into a list.  Used by the
+ *  offline render, which drives the normal playback code from a virtual
+ *  clock, and must not send anything to the ports.
+ *
+ * \threadsafe
+ *
+ * \param cl
+ *      The list to hold the events, or nullptr to resume normal output.  The
+ *      caller owns the list, and must reset the capture before the list goes
+ *      away.
+ */
+
+void
+mastermidibase::capture_output (capturelist * cl)
+{
+    automutex locker(m_mutex);
+    m_capture = cl;
 }
 
 /**
@@ -333,15 +363,25 @@ void
 mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
+    if (not_nullptr(m_capture))
+        m_capture->emplace_back(bus, channel, *e24);
+    else
+        m_outbus_array.play(bus, e24, channel);
 }
 
 void
 mastermidibase::play_and_flush (bussbyte bus, event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
-    api_flush();
+    if (not_nullptr(m_capture))
+    {
+        m_capture->emplace_back(bus, channel, *e24);
+    }
+    else
+    {
+        m_outbus_array.play(bus, e24, channel);
+        api_flush();
+    }
 }
 
 /**
@@ -737,12 +777,13 @@ mastermidibase::poll_for_midi ()
 
 /**
  *  Provides a default implementation of api_poll_for_midi().  This
- *  implementation adds a millisecond of sleep time unless more than two
- *  events are pending.  Some input devices may need to override this
+ *  implementation sleeps for a millisecond if no events are pending; when
+ *  events are pending, it returns at once, so as not to delay them.  APIs
+ *  that can block on a descriptor (see mastermidibus) override this
  *  function.
  *
- *  For a quick threadsafe check, call is_more_input() instead.  But see the
- *  warning in the non-API poll_for_midi() function.
+ *  For a quick check, call is_more_input() instead.  But see the warning in
+ *  the non-API poll_for_midi() function.
  *
  * \return
  *      Returns the number of events found by the first successful poll of the
@@ -753,15 +794,9 @@ int
 mastermidibase::api_poll_for_midi ()
 {
     int result = m_inbus_array.poll_for_midi();
-    if (result > 0)
-    {
-        if (result <= 2)
-            (void) microsleep(std_sleep_us());      /* is this sensible?    */
-    }
-    else
-    {
+    if (result <= 0)
         (void) microsleep(std_sleep_us());
-    }
+
     return result;
 }
 
@@ -773,7 +808,8 @@ mastermidibase::api_poll_for_midi ()
  *  while the PortMidi implementation loops through all of the input midibus
  *  objects, calling the poll_for_midi() function of each.
  *
- * \threadsafe
+ *  No lock is taken, as in poll_for_midi(); this is called once per input
+ *  event, and the master-bus lock would compete with the output thread.
  *
  * \return
  *      Returns true if ALSA is supported, and the returned size is greater
@@ -783,10 +819,20 @@ mastermidibase::api_poll_for_midi ()
 bool
 mastermidibase::is_more_input ()
 {
-    automutex locker(m_mutex);
     return m_inbus_array.poll_for_midi() > 0;
 }
 
+/**
+ *  Wakes up the input thread if it is blocked in poll_for_midi(), so that
+ *  it can see that it is time to exit.  Safe to call from any thread.
+ */
+
+void
+mastermidibase::wake_input ()
+{
+    api_wake_input();
+}
+
 /**
  *  Start the given MIDI port.  This function is called by
  *  api_get_midi_event() when the ALSA event SND_SEQ_EVENT_PORT_START is
@@ -958,6 +1004,30 @@ mastermidibase::dump_midi_input (event ev)
     }
 }
 
+/**
+ *  Merges the events that the recording sequences have staged in
+ *  stream_event().  Called by the input thread after each burst of input, so
+ *  that the output thread does not have to lock the sequences to do it.
+ *  A sequence with nothing staged returns at once.  Like dump_midi_input(),
+ *  this function does not lock; sequence::set_recording() holds the
+ *  sequence lock while calling set_sequence_input().
+ */
+
+void
+mastermidibase::merge_recorded_input ()
+{
+    if (m_filter_by_channel)
+    {
+        for (auto s : m_vector_sequence)
+        {
+            if (not_nullptr(s))
+                s->merge_recorded();
+        }
+    }
+    else if (not_nullptr(m_seq))
+        m_seq->merge_recorded();
+}
+
 }           // namespace seq66
 
 /*
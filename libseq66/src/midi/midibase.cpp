@@ -47,6 +47,7 @@
  */
 
 #include "cfg/settings.hpp"             /* seq66::rc()                      */
+#include "midi/controllers.hpp"         /* seq66::cc::all_notes_off, etc.   */
 #include "midi/event.hpp"               /* seq66::event (MIDI event)        */
 #include "midi/midibase.hpp"            /* seq66::midibase for ALSA         */
 
@@ -174,6 +175,7 @@ midibase::midibase
     m_lasttick          (0),
     m_io_type           (iotype),
     m_port_type         (porttype),
+    m_active_notes      (),
     m_mutex             ()
 {
     if (m_port_type != port::manual)
@@ -458,9 +460,88 @@ void
 midibase::play (const event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
+    if (e24->is_note_on() || e24->is_note_off())
+    {
+        midibyte note, velocity;
+        e24->get_data(note, velocity);
+        if (note < c_midibyte_data_max)
+        {
+            int ch = int(e24->get_status(channel) & EVENT_GET_CHAN_MASK);
+            bool on = e24->is_note_on() && velocity > 0;
+            m_active_notes[ch].set(note, on);
+        }
+    }
     api_play(e24, channel);
 }
 
+/**
+ *  Sends a Note Off for each note that play() has turned on and that has not
+ *  yet been turned off, then forgets them.  These exact Note Offs go first,
+ *  so that devices that ignore channel-mode messages are still silenced.
+ *  Then All Notes Off (CC 123) and All Sound Off (CC 120) go to every
+ *  channel, to catch notes this buss did not see, such as notes held by the
+ *  sustain pedal or left by another application.  That adds only 32
+ *  messages, not the 2048 Note Offs of the old full sweep.  The caller
+ *  flushes.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns the number of Note Offs sent.
+ */
+
+int
+midibase::panic ()
+{
+    automutex locker(m_mutex);
+    int result = 0;
+    for (int channel = 0; channel < c_midichannel_max; ++channel)
+    {
+        auto & notes = m_active_notes[channel];
+        if (notes.none())
+            continue;
+
+        for (int note = 0; note < c_midibyte_data_max; ++note)
+        {
+            if (notes.test(note))
+            {
+                event e(0, EVENT_NOTE_OFF, channel, note, 0);
+                api_play(&e, midibyte(channel));
+                ++result;
+            }
+        }
+        notes.reset();
+    }
+    for (int channel = 0; channel < c_midichannel_max; ++channel)
+    {
+        midibyte allnotesoff = midibyte(cc::all_notes_off);
+        midibyte allsoundoff = midibyte(cc::all_sound_off);
+        event notesoff(0, EVENT_CONTROL_CHANGE, channel, allnotesoff, 0);
+        event soundoff(0, EVENT_CONTROL_CHANGE, channel, allsoundoff, 0);
+        api_play(&notesoff, midibyte(channel));
+        api_play(&soundoff, midibyte(channel));
+    }
+    return result;
+}
+
+/**
+ *  Counts the notes that are still on, i.e. the notes that panic() would
+ *  turn off.
+ *
+ * \threadsafe
+ */
+
+int
+midibase::active_note_count () const
+{
+    automutex locker(m_mutex);
+    int result = 0;
+    for (const auto & notes : m_active_notes)
+        result += int(notes.count());
+
+    return result;
+}
+
 /**
  *  Takes a native SYSEX event, encodes it to an ALSA event, and then
  *  puts it in the queue.
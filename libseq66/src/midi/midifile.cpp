@@ -84,8 +84,11 @@
  *      -#  Any data bytes are ignored when the buffer is 0.
  */
 
-#include <fstream>                      /* std::ifstream and std::ofstream  */
+#include <atomic>                       /* std::atomic<> track counter      */
+#include <cstdio>                       /* std::rename(), std::fwrite()     */
+#include <fstream>                      /* std::ifstream                    */
 #include <memory>                       /* std::unique_ptr<>                */
+#include <thread>                       /* std::thread for track parsing    */
 
 #include "cfg/settings.hpp"             /* seq66::rc() and choose_ppqn()    */
 #include "midi/midifile.hpp"            /* seq66::midifile                  */
@@ -96,6 +99,12 @@
 #include "util/filefunctions.hpp"       /* seq66::get_full_path()           */
 #include "util/palette.hpp"             /* seq66::palette_to_int(), colors  */
 
+#if defined SEQ66_PLATFORM_UNIX
+#include <fcntl.h>                      /* ::open()                         */
+#include <sys/mman.h>                   /* ::mmap(), ::munmap()             */
+#include <unistd.h>                     /* ::close()                        */
+#endif
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -120,11 +129,13 @@ static const size_t c_minimum_midi_file_size = 14;
 static const unsigned c_legacy_mute_group = 1024;           /* 0x0400       */
 
 /**
- *  A manifest constant for controlling the length of the stream buffering
- *  array in a MIDI file.
+ *  A rough number of bytes per event, plus a per-track allowance for the
+ *  track header and the meta and SeqSpec events, used to reserve the output
+ *  buffer up front.
  */
 
-static const int c_midi_line_max = 1024;
+static const int c_bytes_per_event = 4;
+static const int c_bytes_per_track = 256;
 
 /**
  *  The maximum length of a Seq24/Seq66 track nam3.
@@ -279,8 +290,11 @@ midifile::midifile
     m_disable_reported          (false),
     m_pos                       (0),
     m_name                      (name),
-    m_data                      (),
-    m_char_list                 (),
+    m_data                      (nullptr),
+    m_data_buffer               (),
+    m_map                       (nullptr),
+    m_map_size                  (0),
+    m_file_bytes                 (),
     m_global_bgsequence         (globalbgs),
     m_use_scaled_ppqn           (false),                /* scaled()         */
     m_ppqn                      (ppqn),                 /* can start as 0   */
@@ -297,7 +311,41 @@ midifile::midifile
 
 midifile::~midifile ()
 {
-    // empty body
+    release_input();
+}
+
+/**
+ *  Unmaps or frees the input data.
+ */
+
+void
+midifile::release_input ()
+{
+#if defined SEQ66_PLATFORM_UNIX
+    if (not_nullptr(m_map))
+        (void) ::munmap(m_map, m_map_size);
+#endif
+    m_map = nullptr;
+    m_map_size = 0;
+    m_data = nullptr;
+    m_data_buffer.clear();
+}
+
+/**
+ *  Hands the file data, already read into memory (e.g. by the play-list song
+ *  preloader), to this object, so that parse() does not have to touch the
+ *  disk.  The data must be the whole file named in the constructor.
+ *
+ * \param data
+ *      The file data.  It is swapped into this object, and is left empty.
+ */
+
+void
+midifile::preload (midibytes & data)
+{
+    release_input();
+    m_data_buffer.swap(data);
+    m_data = m_data_buffer.data();
 }
 
 /**
@@ -609,7 +657,9 @@ midifile::read_gap (size_t sz)
 /**
  *  Creates the stream input, reads it into the "buffer", and then closes
  *  the file.  No file buffering needed on these beefy machines!  :-)
- *  As a side-effect, also sets m_file_size.
+ *  As a side-effect, also sets m_file_size.  On UNIX-like systems the file
+ *  is memory-mapped instead of read, and pages are brought in as the tracks
+ *  are parsed.
  *
  *  We were using the assignment operator, but this caused an error using old
  *  32-bit debian stable, g++ 4.9 on one of our old laptops.  The assignment
@@ -631,6 +681,17 @@ midifile::read_gap (size_t sz)
 bool
 midifile::grab_input_stream (const std::string & tag)
 {
+    bool preloaded = ! m_data_buffer.empty() && m_data == m_data_buffer.data();
+    if (preloaded)
+    {
+        m_file_size = m_data_buffer.size();
+        m_error_is_fatal = false;
+        if (m_file_size < c_minimum_midi_file_size)
+            return set_error("File too small");
+
+        return true;
+    }
+
     m_file_size = file_size(m_name);
     if (m_name.empty() || m_file_size == 0)
     {
@@ -659,15 +720,41 @@ midifile::grab_input_stream (const std::string & tag)
         }
         else
         {
-            file.seekg(0, std::ios::beg);       /* seek to the file's start */
-            try
+            release_input();
+#if defined SEQ66_PLATFORM_UNIX
+            int fd = ::open(m_name.c_str(), O_RDONLY);
+            if (fd >= 0)
             {
-                m_data.resize(m_file_size);     /* allocate the data        */
-                file.read((char *)(&m_data[0]), m_file_size);
+                void * addr = ::mmap
+                (
+                    nullptr, m_file_size, PROT_READ, MAP_PRIVATE, fd, 0
+                );
+                (void) ::close(fd);             /* the mapping stays valid  */
+                if (addr != MAP_FAILED)
+                {
+                    (void) ::madvise(addr, m_file_size, MADV_WILLNEED);
+                    m_map = addr;
+                    m_map_size = m_file_size;
+                    m_data = static_cast<const midibyte *>(addr);
+                }
             }
-            catch (const std::bad_alloc & ex)
+            if (is_nullptr(m_data))             /* fall back to reading it  */
+#endif
             {
-                result = set_error("MIDI file stream memory allocation failed");
+                file.seekg(0, std::ios::beg);   /* seek to the file's start */
+                try
+                {
+                    m_data_buffer.resize(m_file_size);
+                    file.read((char *)(&m_data_buffer[0]), m_file_size);
+                    m_data = m_data_buffer.data();
+                }
+                catch (const std::bad_alloc & ex)
+                {
+                    result = set_error
+                    (
+                        "MIDI file stream memory allocation failed"
+                    );
+                }
             }
             file.close();
         }
@@ -1048,11 +1135,9 @@ bool
 midifile::parse_smf_1 (performer & p, int screenset, bool is_smf0)
 {
     bool result = true;
-    bool got_song_info = false;
     midibyte buss_override = usr().midi_buss_override();
     midishort track_count = read_short();
     midishort fileppqn = read_short();
-    bool gotfirst_bpm = false;
     file_ppqn(int(fileppqn));                       /* original file PPQN   */
     if (usr().use_file_ppqn())
     {
@@ -1074,551 +1159,809 @@ midifile::parse_smf_1 (performer & p, int screenset, bool is_smf0)
         }
         infoprintf("Track count %d", int(track_count));
     }
+    std::vector<trackinfo> chunks;
+    bool parallel = ! is_smf0 && track_count > 1 &&
+        scan_tracks(track_count, chunks);
+
+    if (parallel)
+    {
+        bool done = false;                          /* stop or fatal error  */
+        parse_tracks(p, chunks);
+        for (auto & info : chunks)                  /* install in order     */
+        {
+            if (! done && ! info.error.empty())
+                m_error_message = info.error;
+
+            if (! done)
+                apply_track(p, info);
+
+            if (! done && info.status == trackstatus::ok)
+            {
+                install_track(p, info, screenset, is_smf0, buss_override);
+            }
+            else
+            {
+                if (! done)
+                {
+                    done = true;
+                    result = info.status == trackstatus::stop;
+                }
+                delete info.seq;                    /* never installed      */
+            }
+        }
+        return result;
+    }
     for (midishort track = 0; track < track_count; ++track)
     {
-        midibyte tentative_channel = null_channel();
         midilong ID = read_long();                  /* get track marker     */
         midilong TrackLength = read_long();         /* get track length     */
         if (ID == c_mtrk_tag)                       /* magic number 'MTrk'  */
         {
-            bool timesig_set = false;               /* first time-sig wins  */
-            midipulse runningtime = 0;              /* reset time           */
-            midipulse currenttime = 0;              /* adjusted by PPQN     */
-            midishort seqnum = c_midishort_max;     /* either read or set   */
-            midibyte status = 0;
-            midibyte runningstatus = 0;
-            midilong seqspec = 0;                   /* sequencer-specific   */
-            bool done = false;                      /* done for each track  */
-            sequence * sp = create_sequence(p);     /* create new sequence  */
-            if (is_nullptr(sp))
+            trackinfo info;
+            info.track = track;
+            info.status = parse_track(p, info, is_smf0);
+            apply_track(p, info);
+            if (info.status == trackstatus::ok)
             {
-                set_error_dump("MIDI file parse: sequence allocation failed");
-                return false;
+                install_track(p, info, screenset, is_smf0, buss_override);
             }
-            sequence & s = *sp;                     /* references better    */
-            while (! done)                          /* get events in track  */
+            else
             {
-                event e;                            /* note-off, no channel */
-                midilong len;                       /* important counter!   */
-                midibyte d0, d1;                    /* the two data bytes   */
-                midipulse delta = read_varinum();   /* time delta from prev */
-                status = m_data[m_pos];             /* current event byte   */
-                if (event::is_status(status))       /* is there a 0x80 bit? */
-                {
-                    skip(1);                                /* get to d0    */
-                    if (event::is_system_common_msg(status))
-                        runningstatus = 0;                  /* clear it     */
-                    else if (! event::is_realtime_msg(status))
-                        runningstatus = status;             /* log status   */
-                }
-                else
-                {
-                    /*
-                     * Handle data values. If in running status, set that as
-                     * status; the next value to be read is the d0 value.  If
-                     * not running status, is this an error?
-                     */
-
-                    if (runningstatus > 0)      /* running status in force? */
-                        status = runningstatus; /* yes, use running status  */
-                }
-                e.set_status_keep_channel(status);  /* set status, channel  */
-
-                /*
-                 *  See "PPQN" section in banner.
-                 */
+                delete info.seq;                    /* never installed      */
+                return info.status == trackstatus::stop;
+            }
+        }
+        else
+        {
+            if (track > 0)                              /* non-fatal later  */
+            {
+                (void) set_error_dump("Unknown MIDI track ID, skipping...", ID);
+            }
+            else                                        /* fatal in 1st one */
+            {
+                result = set_error_dump("First track unsupported track ID", ID);
+                break;
+            }
+            skip(TrackLength);
+        }
+    }                                                   /* for each track   */
+    return result;
+}
 
-                runningtime += delta;           /* add in the time          */
-                currenttime = runningtime;
-                if (scaled())                   /* adjust time via ppqn     */
-                    currenttime = midipulse(currenttime * ppqn_ratio());
+/**
+ *  Locates the MTrk chunks of an SMF 1 file without parsing them, so that
+ *  they can be parsed concurrently.  Leaves m_pos after the last chunk, where
+ *  the SeqSpec section (if any) starts.
+ *
+ * \param track_count
+ *      The number of tracks given in the MThd header.
+ *
+ * \param [out] chunks
+ *      Receives the offset of each MTrk chunk, in file order.
+ *
+ * \return
+ *      Returns false if any chunk is not an MTrk chunk or overruns the file.
+ *      The caller then parses the file serially, which handles (or reports)
+ *      such files the old way.  m_pos is restored in that case.
+ */
 
-                e.set_timestamp(currenttime);
+bool
+midifile::scan_tracks (midishort track_count, std::vector<trackinfo> & chunks)
+{
+    std::size_t start = m_pos;
+    std::size_t pos = m_pos;
+    chunks.clear();
+    chunks.reserve(track_count);
+    for (midishort track = 0; track < track_count; ++track)
+    {
+        if (pos + 8 > m_file_size)
+            break;
+
+        m_pos = pos;
+        midilong ID = read_long();
+        midilong length = read_long();
+        std::size_t next = m_pos + std::size_t(length);
+        if (ID != c_mtrk_tag || next > m_file_size)
+            break;
+
+        trackinfo info;
+        info.track = track;
+        info.offset = m_pos;
+        chunks.push_back(info);
+        pos = next;
+    }
+    bool result = chunks.size() == std::size_t(track_count);
+    m_pos = result ? pos : start ;
+    if (! result)
+        chunks.clear();
 
-                midibyte eventcode = event::mask_status(status);    /* F0 */
-                midibyte channel = event::mask_channel(status);     /* 0F */
-                switch (eventcode)
-                {
-                case EVENT_NOTE_OFF:                    /* 3-byte events    */
-                case EVENT_NOTE_ON:
-                case EVENT_AFTERTOUCH:
-                case EVENT_CONTROL_CHANGE:
-                case EVENT_PITCH_WHEEL:
+    return result;
+}
 
-                    d0 = read_byte();
-                    d1 = read_byte();
-                    if (event::is_note_off_velocity(eventcode, d1))
-                        e.set_channel_status(EVENT_NOTE_OFF, channel);
+/**
+ *  Parses the located MTrk chunks on a pool of threads.  Each thread uses its
+ *  own midifile object that shares (read-only) our file data, so the readers
+ *  do not interfere.  The first track is parsed here, on the calling thread.
+ *  Neither the performer nor the sequence statics are written while the
+ *  pool runs:  the statics are loaded before it starts, and the tempo and
+ *  song information of track 0 are kept in its trackinfo.  The sequences are
+ *  not installed; the caller installs them in track order, so that the
+ *  numbering is the same as for a serial parse.
+ *
+ * \param p
+ *      Provides the performer, used only (read-only) for the master bus of
+ *      new sequences.
+ *
+ * \param [inout] chunks
+ *      Provides the chunk offsets, and receives the parsed sequences.
+ */
 
-                    e.set_data(d0, d1);               /* set data and add   */
+void
+midifile::parse_tracks (performer & p, std::vector<trackinfo> & chunks)
+{
+    std::atomic<std::size_t> next(1);
+    unsigned hc = std::thread::hardware_concurrency();
+    std::size_t threadcount = hc > 1 ? std::size_t(hc - 1) : 1 ;
+    if (threadcount > chunks.size() - 1)
+        threadcount = chunks.size() - 1;
 
-                    /*
-                     * s.append_event() doesn't sort events; sort after we
-                     * get them all.  Also, it is kind of weird we change the
-                     * channel for the whole sequence here.
-                     */
+    auto worker = [this, &p, &chunks, &next] ()
+    {
+        midifile reader(m_name, m_ppqn, m_global_bgsequence, m_verify_mode);
+        for (;;)
+        {
+            std::size_t t = next++;
+            if (t >= chunks.size())
+                break;
 
-                    s.append_event(e);                  /* does not sort    */
-                    tentative_channel = channel;        /* log MIDI channel */
-                    if (is_smf0)
-                        m_smf0_splitter.increment(channel); /* count chan.  */
-                    break;
+            trackinfo & info = chunks[t];
+            reader.share_input(*this, info.offset);
+            info.status = reader.parse_track(p, info, false);
+            info.error = reader.m_error_message;
+        }
+    };
+    sequence::load_defaults();                      /* before the pool  */
 
-                case EVENT_PROGRAM_CHANGE:              /* 1-data-byte event*/
-                case EVENT_CHANNEL_PRESSURE:
+    std::vector<std::thread> pool;
+    pool.reserve(threadcount);
+    for (std::size_t i = 0; i < threadcount; ++i)
+        pool.emplace_back(worker);
 
-                    d0 = read_byte();                   /* was data[0]      */
-                    e.set_data(d0);                     /* set data and add */
+    std::size_t endpos = m_pos;
+    trackinfo & first = chunks[0];
+    m_pos = first.offset;
+    m_error_message.clear();
+    first.status = parse_track(p, first, false);
+    first.error = m_error_message;
+    m_error_message.clear();
+    m_pos = endpos;
+    for (auto & t : pool)
+        t.join();
+}
 
-                    /*
-                     * s.append_event() doesn't sort events; they're sorted
-                     * after we read them all.
-                     */
+/**
+ *  Makes this object a reader of the data of another midifile, starting at
+ *  the given offset.  Used by the track-parsing threads.
+ */
 
-                    s.append_event(e);                  /* does not sort    */
-                    tentative_channel = channel;
-                    if (is_smf0)
-                        m_smf0_splitter.increment(channel); /* count chan.  */
-                    break;
+void
+midifile::share_input (const midifile & source, std::size_t offset)
+{
+    m_data = source.m_data;
+    m_file_size = source.m_file_size;
+    m_pos = offset;
+    m_use_scaled_ppqn = source.m_use_scaled_ppqn;
+    m_ppqn = source.m_ppqn;
+    m_file_ppqn = source.m_file_ppqn;
+    m_ppqn_ratio = source.m_ppqn_ratio;
+    m_error_message.clear();
+    m_disable_reported = false;
+}
 
-                case EVENT_MIDI_REALTIME:               /* 0xFn MIDI events */
+/**
+ *  Parses the events of one MTrk chunk into a new sequence.  m_pos must be
+ *  just past the chunk header.  This is the body of the old parse_smf_1()
+ *  track loop; see that function's banner for the details.
+ *
+ * \param p
+ *      Provides the performer, which is not modified, so that tracks can be
+ *      parsed on several threads.  See apply_track().
+ *
+ * \param [inout] info
+ *      Provides the track number, and receives the new sequence (even on an
+ *      error, in which case the caller deletes it), its number, and its
+ *      channel.  For track 0, it also receives the first tempo, time
+ *      signature, and text event.
+ *
+ * \param is_smf0
+ *      True if we detected that the MIDI file is in SMF 0 format.
+ *
+ * \return
+ *      Returns trackstatus::ok if the track was parsed.  trackstatus::stop
+ *      means that junk was found and no further tracks are to be processed;
+ *      trackstatus::fatal means the parse failed.
+ */
 
-                    if (status == EVENT_MIDI_META)      /* 0xFF             */
-                    {
-                        midibyte mtype = read_byte();   /* get meta type    */
-                        len = read_varinum();           /* if 0 catch later */
-                        switch (mtype)
-                        {
-                        case EVENT_META_SEQ_NUMBER:     /* FF 00 02 ss      */
+midifile::trackstatus
+midifile::parse_track (performer & p, trackinfo & info, bool is_smf0)
+{
+    midishort track = midishort(info.track);
+    midibyte tentative_channel = null_channel();
+    bool gotfirst_bpm = false;
+    bool got_song_info = false;
+    bool timesig_set = false;                   /* first time-sig wins  */
+    midipulse runningtime = 0;                  /* reset time           */
+    midipulse currenttime = 0;                  /* adjusted by PPQN     */
+    midishort seqnum = c_midishort_max;         /* either read or set   */
+    midibyte status = 0;
+    midibyte runningstatus = 0;
+    midilong seqspec = 0;                       /* sequencer-specific   */
+    bool done = false;                          /* done for each track  */
+    sequence * sp = create_sequence(p);         /* create new sequence  */
+    if (is_nullptr(sp))
+    {
+        set_error_dump("MIDI file parse: sequence allocation failed");
+        return trackstatus::fatal;
+    }
+    info.seq = sp;                              /* caller owns it now   */
+    sequence & s = *sp;                         /* references better    */
+    while (! done)                              /* get events in track  */
+    {
+        event e;                                /* note-off, no channel */
+        midilong len;                           /* important counter!   */
+        midibyte d0, d1;                        /* the two data bytes   */
+        midipulse delta = read_varinum();       /* time delta from prev */
+        status = m_data[m_pos];                 /* current event byte   */
+        if (event::is_status(status))           /* is there a 0x80 bit? */
+        {
+            skip(1);                                    /* get to d0    */
+            if (event::is_system_common_msg(status))
+                runningstatus = 0;                      /* clear it     */
+            else if (! event::is_realtime_msg(status))
+                runningstatus = status;                 /* log status   */
+        }
+        else
+        {
+            /*
+             * Handle data values. If in running status, set that as
+             * status; the next value to be read is the d0 value.  If
+             * not running status, is this an error?
+             */
 
-                            if (! checklen(len, mtype))
-                                return false;
+            if (runningstatus > 0)          /* running status in force? */
+                status = runningstatus; /* yes, use running status  */
+        }
+        e.set_status_keep_channel(status);      /* set status, channel  */
 
-                            seqnum = read_short();
-                            break;
+        /*
+         *  See "PPQN" section in banner.
+         */
 
-                        case EVENT_META_TRACK_NAME:     /* FF 03 len text   */
+        runningtime += delta;               /* add in the time          */
+        currenttime = runningtime;
+        if (scaled())                       /* adjust time via ppqn     */
+            currenttime = midipulse(currenttime * ppqn_ratio());
 
-                            if (checklen(len, mtype))
-                            {
-                                int count = 0;
-                                char trackname[c_trackname_max];
-                                for (int i = 0; i < int(len); ++i)
-                                {
-                                    char ch = char(read_byte());
-                                    if (count < c_trackname_max)
-                                    {
-                                        trackname[count] = ch;
-                                        ++count;
-                                    }
-                                }
-                                trackname[count] = '\0';
-                                s.set_name(trackname);
-                            }
-                            else
-                                return false;
+        e.set_timestamp(currenttime);
 
-                            break;
+        midibyte eventcode = event::mask_status(status);        /* F0 */
+        midibyte channel = event::mask_channel(status);         /* 0F */
+        switch (eventcode)
+        {
+        case EVENT_NOTE_OFF:                        /* 3-byte events    */
+        case EVENT_NOTE_ON:
+        case EVENT_AFTERTOUCH:
+        case EVENT_CONTROL_CHANGE:
+        case EVENT_PITCH_WHEEL:
 
-                        case EVENT_META_END_OF_TRACK:   /* FF 2F 00         */
+            d0 = read_byte();
+            d1 = read_byte();
+            if (event::is_note_off_velocity(eventcode, d1))
+                e.set_channel_status(EVENT_NOTE_OFF, channel);
 
-                            s.set_length(currenttime, false);
-                            s.zero_markers();
-                            done = true;
-                            break;
+            e.set_data(d0, d1);                   /* set data and add   */
 
-                        case EVENT_META_SET_TEMPO:      /* FF 51 03 tttttt  */
+            /*
+             * s.append_event() doesn't sort events; sort after we
+             * get them all.  Also, it is kind of weird we change the
+             * channel for the whole sequence here.
+             */
 
-                            if (! checklen(len, mtype))
-                                return false;
+            s.append_event(e);                      /* does not sort    */
+            tentative_channel = channel;            /* log MIDI channel */
+            if (is_smf0)
+                m_smf0_splitter.increment(channel); /* count chan.  */
+            break;
 
-                            if (len == 3)
-                            {
-                                midibyte bt[4];         /* "Tempo events"   */
-                                bt[0] = read_byte();                /* tt   */
-                                bt[1] = read_byte();                /* tt   */
-                                bt[2] = read_byte();                /* tt   */
+        case EVENT_PROGRAM_CHANGE:                  /* 1-data-byte event*/
+        case EVENT_CHANNEL_PRESSURE:
 
-                                double tt = tempo_us_from_bytes(bt);
-                                if (tt > 0)
-                                {
-                                    if (track == 0)
-                                    {
-                                        midibpm bpm = bpm_from_tempo_us(tt);
-                                        if (! gotfirst_bpm)
-                                        {
-                                            gotfirst_bpm = true;
-                                            p.set_beats_per_minute(bpm);
-                                            p.us_per_quarter_note(int(tt));
-                                            s.us_per_quarter_note(int(tt));
-                                        }
-                                    }
-
-                                    bool ok = e.append_meta_data(mtype, bt, 3);
-                                    if (ok)
-                                        s.append_event(e);
-                                }
-                            }
-                            else
-                                skip(len);              /* eat it           */
-                            break;
+            d0 = read_byte();                       /* was data[0]      */
+            e.set_data(d0);                         /* set data and add */
 
-                        case EVENT_META_TIME_SIGNATURE: /* FF 58 04 n d c b */
+            /*
+             * s.append_event() doesn't sort events; they're sorted
+             * after we read them all.
+             */
 
-                            if (! checklen(len, mtype))
-                                return false;
+            s.append_event(e);                      /* does not sort    */
+            tentative_channel = channel;
+            if (is_smf0)
+                m_smf0_splitter.increment(channel); /* count chan.  */
+            break;
 
-                            if ((len == 4) && ! timesig_set)
-                            {
-                                int bpb = int(read_byte());         // nn
-                                int logbase2 = int(read_byte());    // dd
-                                int cc = read_byte();               // cc
-                                int bb = read_byte();               // bb
-                                int bw = beat_power_of_2(logbase2);
+        case EVENT_MIDI_REALTIME:                   /* 0xFn MIDI events */
 
-#if defined SEQ66_USE_TRACK_0_AS_GLOBAL_TIME_SIG
+            if (status == EVENT_MIDI_META)          /* 0xFF             */
+            {
+                midibyte mtype = read_byte();       /* get meta type    */
+                len = read_varinum();               /* if 0 catch later */
+                switch (mtype)
+                {
+                case EVENT_META_SEQ_NUMBER:         /* FF 00 02 ss      */
 
-                                /*
-                                 * Could use c_perf_bp_mes and c_perf_bw
-                                 * instead.
-                                 */
+                    if (! checklen(len, mtype))
+                        return trackstatus::fatal;
 
-                                if (track == 0)
-                                {
-                                    p.set_beats_per_bar(bpb);
-                                    p.set_beat_width(bw);
-                                    p.clocks_per_metronome(cc);
-                                    p.set_32nds_per_quarter(bb);
-                                }
-#endif
+                    seqnum = read_short();
+                    break;
 
-                                midibyte bt[4];
-                                bt[0] = midibyte(bpb);
-                                bt[1] = midibyte(logbase2);
-                                bt[2] = midibyte(cc);
-                                bt[3] = midibyte(bb);
+                case EVENT_META_TRACK_NAME:         /* FF 03 len text   */
 
-                                bool ok = e.append_meta_data(mtype, bt, 4);
-                                if (ok)
-                                {
-                                    /*
-                                     * Consolidate the settings for
-                                     * integrity's sake.
-                                     *
-                                     * s.set_beats_per_bar(bpb);
-                                     * s.set_beat_width(bw);
-                                     */
-
-                                    s.set_time_signature(bpb, bw);
-                                    s.clocks_per_metronome(cc);
-                                    s.set_32nds_per_quarter(bb);
-                                    s.append_event(e);
-                                    timesig_set = true;
-                                }
+                    if (checklen(len, mtype))
+                    {
+                        int count = 0;
+                        char trackname[c_trackname_max];
+                        for (int i = 0; i < int(len); ++i)
+                        {
+                            char ch = char(read_byte());
+                            if (count < c_trackname_max)
+                            {
+                                trackname[count] = ch;
+                                ++count;
                             }
-                            else
-                                skip(len);              /* eat it           */
-                            break;
+                        }
+                        trackname[count] = '\0';
+                        s.set_name(trackname);
+                    }
+                    else
+                        return trackstatus::fatal;
 
-                        case EVENT_META_KEY_SIGNATURE:  /* FF 59 02 ss kk   */
+                    break;
 
-                            if (len == 2)
-                            {
-                                midibyte bt[2];
-                                bt[0] = read_byte();            /* #/b no.  */
-                                bt[1] = read_byte();            /* min/maj  */
+                case EVENT_META_END_OF_TRACK:       /* FF 2F 00         */
 
-                                bool ok = e.append_meta_data(mtype, bt, 2);
-                                if (ok)
-                                    s.append_event(e);
-                            }
-                            else
-                                skip(len);              /* eat it           */
-                            break;
+                    s.set_length(currenttime, false);
+                    s.zero_markers();
+                    done = true;
+                    break;
 
-                        case EVENT_META_SEQSPEC:      /* FF F7 = SeqSpec    */
+                case EVENT_META_SET_TEMPO:          /* FF 51 03 tttttt  */
 
-                            if (len > 4)              /* FF 7F len data     */
-                            {
-                                seqspec = read_long();
-                                len -= 4;
-                            }
-                            else if (! checklen(len, mtype))
-                                return false;
+                    if (! checklen(len, mtype))
+                        return trackstatus::fatal;
 
-                            if (seqspec == c_midibus)
-                            {
-                                (void) s.set_midi_bus(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_midichannel)
-                            {
-                                midibyte channel = read_byte();
-                                tentative_channel = channel;
-                                --len;
-                                if (is_smf0)
-                                    m_smf0_splitter.increment(channel);
-                            }
-                            else if (seqspec == c_timesig)
-                            {
-                                /*
-                                 * This can override an early time-signature.
-                                 */
-
-                                int bpb = int(read_byte());
-                                int bw = int(read_byte());
-                                s.set_beats_per_bar(bpb);
-                                s.set_beat_width(bw);
-                                timesig_set = true;
-                                len -= 2;
-                            }
-                            else if (seqspec == c_triggers)
-                            {
-                                int sz = trigger::datasize(c_triggers);
-                                int num_triggers = len / sz;
-                                for (int i = 0; i < num_triggers; ++i)
-                                {
-                                    add_old_trigger(s);
-                                    len -= sz;
-                                }
-                            }
-                            else if (seqspec == c_triggers_ex)
-                            {
-                                int sz = trigger::datasize(c_triggers_ex);
-                                int num_triggers = len / sz;
-                                midishort p = scaled() ? file_ppqn() : 0 ;
-                                for (int i = 0; i < num_triggers; ++i)
-                                {
-                                    add_trigger(s, p, false);
-                                    len -= sz;
-                                }
-                            }
-                            else if (seqspec == c_trig_transpose)
+                    if (len == 3)
+                    {
+                        midibyte bt[4];             /* "Tempo events"   */
+                        bt[0] = read_byte();                    /* tt   */
+                        bt[1] = read_byte();                    /* tt   */
+                        bt[2] = read_byte();                    /* tt   */
+
+                        double tt = tempo_us_from_bytes(bt);
+                        if (tt > 0)
+                        {
+                            if (track == 0)
                             {
-                                int sz = trigger::datasize(c_trig_transpose);
-                                int num_triggers = len / sz;
-                                midishort p = scaled() ? file_ppqn() : 0 ;
-                                for (int i = 0; i < num_triggers; ++i)
+                                midibpm bpm = bpm_from_tempo_us(tt);
+                                if (! gotfirst_bpm)
                                 {
-                                    add_trigger(s, p, true);
-                                    len -= sz;
+                                    gotfirst_bpm = true;
+                                    info.bpm = bpm;
+                                    info.us_per_qn = int(tt);
+                                    s.us_per_quarter_note(int(tt));
                                 }
                             }
-                            else if (seqspec == c_musickey)
-                            {
-                                s.musical_key(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_musicscale)
-                            {
-                                s.musical_scale(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_backsequence)
-                            {
-                                s.background_sequence(int(read_long()));
-                                len -= 4;
-                            }
-                            else if (seqspec == c_transpose)
-                            {
-                                s.set_transposable(read_byte() != 0);
-                                --len;
-                            }
-                            else if (seqspec == c_seq_color)
-                            {
-                                s.set_color(read_byte());
-                                --len;
-                            }
-                            else if (seqspec == c_seq_loopcount)
-                            {
-                                s.loop_count_max(int(read_short()));
-                                len -= 2;
-                            }
-                            else if (seqspec == c_mutegroups)
-                            {
-                                /* handled in parse_seqspec_track() */
-                            }
-                            else if (is_proptag(seqspec))
-                            {
-                                (void) set_error_dump
-                                (
-                                    "Unknown Seq66 SeqSpec, skipping",
-                                    seqspec
-                                );
-                            }
-                            else
-                            {
-                                /* will skip all other SeqSpecs */
-                            }
-                            skip(len);                  /* eat it           */
-                            break;
+
+                            bool ok = e.append_meta_data(mtype, bt, 3);
+                            if (ok)
+                                s.append_event(e);
+                        }
+                    }
+                    else
+                        skip(len);                  /* eat it           */
+                    break;
+
+                case EVENT_META_TIME_SIGNATURE: /* FF 58 04 n d c b */
+
+                    if (! checklen(len, mtype))
+                        return trackstatus::fatal;
+
+                    if ((len == 4) && ! timesig_set)
+                    {
+                        int bpb = int(read_byte());         // nn
+                        int logbase2 = int(read_byte());    // dd
+                        int cc = read_byte();               // cc
+                        int bb = read_byte();               // bb
+                        int bw = beat_power_of_2(logbase2);
+
+#if defined SEQ66_USE_TRACK_0_AS_GLOBAL_TIME_SIG
 
                         /*
-                         * Handled above: EVENT_META_TRACK_NAME
+                         * Could use c_perf_bp_mes and c_perf_bw
+                         * instead.
                          */
 
-                        case EVENT_META_TEXT_EVENT:      /* FF 01 len text  */
-                        case EVENT_META_COPYRIGHT:       /* FF 02 ...       */
-                        case EVENT_META_INSTRUMENT:      /* FF 04 ...       */
-                        case EVENT_META_LYRIC:           /* FF 05 ...       */
-                        case EVENT_META_MARKER:          /* FF 06 ...       */
-                        case EVENT_META_CUE_POINT:       /* FF 07 ...       */
+                        if (track == 0)
+                        {
+                            info.beats_per_bar = bpb;
+                            info.beat_width = bw;
+                            info.clocks_per_metronome = cc;
+                            info.thirtyseconds = bb;
+                        }
+#endif
 
-                            if (checklen(len, mtype))
-                            {
-                                int count = 0;
-                                midibyte mt[c_meta_text_limit];
-                                for (int i = 0; i < int(len); ++i)
-                                {
-                                    char ch = char(read_byte());
-                                    if (count < int(c_meta_text_limit))
-                                    {
-                                        mt[count] = ch;
-                                        ++count;
-                                    }
-                                }
-                                mt[count] = '\0';
+                        midibyte bt[4];
+                        bt[0] = midibyte(bpb);
+                        bt[1] = midibyte(logbase2);
+                        bt[2] = midibyte(cc);
+                        bt[3] = midibyte(bb);
 
-                                bool ok = e.append_meta_data(mtype, mt, count);
-                                if (ok)
-                                {
-                                    s.append_event(e);
-                                    bool get_song_info =
-                                        track == 0 &&
-                                        mtype == EVENT_META_TEXT_EVENT &&
-                                        ! got_song_info;
-
-                                    if (get_song_info)
-                                    {
-                                        got_song_info = true;
-                                        p.song_info(e.get_text());
-                                    }
-                                }
-                            }
-                            else
-                                return false;
+                        bool ok = e.append_meta_data(mtype, bt, 4);
+                        if (ok)
+                        {
+                            /*
+                             * Consolidate the settings for
+                             * integrity's sake.
+                             *
+                             * s.set_beats_per_bar(bpb);
+                             * s.set_beat_width(bw);
+                             */
 
-                            break;
+                            s.set_time_signature(bpb, bw);
+                            s.clocks_per_metronome(cc);
+                            s.set_32nds_per_quarter(bb);
+                            s.append_event(e);
+                            timesig_set = true;
+                        }
+                    }
+                    else
+                        skip(len);                  /* eat it           */
+                    break;
+
+                case EVENT_META_KEY_SIGNATURE:      /* FF 59 02 ss kk   */
 
-                        case EVENT_META_MIDI_CHANNEL:   /* FF 20 01 cc      */
-                        case EVENT_META_MIDI_PORT:      /* FF 21 01 pp      */
-                        case EVENT_META_SMPTE_OFFSET:   /* FF 54 03 t t t   */
+                    if (len == 2)
+                    {
+                        midibyte bt[2];
+                        bt[0] = read_byte();                /* #/b no.  */
+                        bt[1] = read_byte();                /* min/maj  */
+
+                        bool ok = e.append_meta_data(mtype, bt, 2);
+                        if (ok)
+                            s.append_event(e);
+                    }
+                    else
+                        skip(len);                  /* eat it           */
+                    break;
+
+                case EVENT_META_SEQSPEC:          /* FF F7 = SeqSpec    */
+
+                    if (len > 4)                  /* FF 7F len data     */
+                    {
+                        seqspec = read_long();
+                        len -= 4;
+                    }
+                    else if (! checklen(len, mtype))
+                        return trackstatus::fatal;
+
+                    if (seqspec == c_midibus)
+                    {
+                        (void) s.set_midi_bus(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_midichannel)
+                    {
+                        midibyte channel = read_byte();
+                        tentative_channel = channel;
+                        --len;
+                        if (is_smf0)
+                            m_smf0_splitter.increment(channel);
+                    }
+                    else if (seqspec == c_timesig)
+                    {
+                        /*
+                         * This can override an early time-signature.
+                         */
+
+                        int bpb = int(read_byte());
+                        int bw = int(read_byte());
+                        s.set_beats_per_bar(bpb);
+                        s.set_beat_width(bw);
+                        timesig_set = true;
+                        len -= 2;
+                    }
+                    else if (seqspec == c_triggers)
+                    {
+                        int sz = trigger::datasize(c_triggers);
+                        int num_triggers = len / sz;
+                        for (int i = 0; i < num_triggers; ++i)
+                        {
+                            add_old_trigger(s);
+                            len -= sz;
+                        }
+                    }
+                    else if (seqspec == c_triggers_ex)
+                    {
+                        int sz = trigger::datasize(c_triggers_ex);
+                        int num_triggers = len / sz;
+                        midishort p = scaled() ? file_ppqn() : 0 ;
+                        for (int i = 0; i < num_triggers; ++i)
+                        {
+                            add_trigger(s, p, false);
+                            len -= sz;
+                        }
+                    }
+                    else if (seqspec == c_trig_transpose)
+                    {
+                        int sz = trigger::datasize(c_trig_transpose);
+                        int num_triggers = len / sz;
+                        midishort p = scaled() ? file_ppqn() : 0 ;
+                        for (int i = 0; i < num_triggers; ++i)
+                        {
+                            add_trigger(s, p, true);
+                            len -= sz;
+                        }
+                    }
+                    else if (seqspec == c_musickey)
+                    {
+                        s.musical_key(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_musicscale)
+                    {
+                        s.musical_scale(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_backsequence)
+                    {
+                        s.background_sequence(int(read_long()));
+                        len -= 4;
+                    }
+                    else if (seqspec == c_transpose)
+                    {
+                        s.set_transposable(read_byte() != 0);
+                        --len;
+                    }
+                    else if (seqspec == c_seq_color)
+                    {
+                        s.set_color(read_byte());
+                        --len;
+                    }
+                    else if (seqspec == c_seq_loopcount)
+                    {
+                        s.loop_count_max(int(read_short()));
+                        len -= 2;
+                    }
+                    else if (seqspec == c_mutegroups)
+                    {
+                        /* handled in parse_seqspec_track() */
+                    }
+                    else if (is_proptag(seqspec))
+                    {
+                        (void) set_error_dump
+                        (
+                            "Unknown Seq66 SeqSpec, skipping",
+                            seqspec
+                        );
+                    }
+                    else
+                    {
+                        /* will skip all other SeqSpecs */
+                    }
+                    skip(len);                      /* eat it           */
+                    break;
 
-                            (void) read_meta_data(s, e, mtype, len);
-                            break;
+                /*
+                 * Handled above: EVENT_META_TRACK_NAME
+                 */
 
-                        default:
+                case EVENT_META_TEXT_EVENT:          /* FF 01 len text  */
+                case EVENT_META_COPYRIGHT:           /* FF 02 ...       */
+                case EVENT_META_INSTRUMENT:          /* FF 04 ...       */
+                case EVENT_META_LYRIC:               /* FF 05 ...       */
+                case EVENT_META_MARKER:              /* FF 06 ...       */
+                case EVENT_META_CUE_POINT:           /* FF 07 ...       */
 
-                            if (rc().verbose())
+                    if (checklen(len, mtype))
+                    {
+                        int count = 0;
+                        midibyte mt[c_meta_text_limit];
+                        for (int i = 0; i < int(len); ++i)
+                        {
+                            char ch = char(read_byte());
+                            if (count < int(c_meta_text_limit))
                             {
-                                std::string m = "Illegal meta value skipped";
-                                (void) set_error_dump(m);
+                                mt[count] = ch;
+                                ++count;
                             }
-                            break;
                         }
-                    }
-                    else if (status == EVENT_MIDI_SYSEX)    /* 0xF0 */
-                    {
-                        /*
-                         * Some files do not properly encode SysEx messages;
-                         * see the function banner for notes.
-                         */
+                        mt[count] = '\0';
 
-                        midibyte check = read_byte();
-                        if (is_sysex_special_id(check))
-                        {
-                            /*
-                             * TMI: "SysEx ID byte = 7D to 7F");
-                             */
-                        }
-                        else                            /* handle normally  */
+                        bool ok = e.append_meta_data(mtype, mt, count);
+                        if (ok)
                         {
-                            --m_pos;                    /* put byte back    */
-                            len = read_varinum();       /* sysex            */
-#if defined SEQ66_USE_SYSEX_PROCESSING
-                            int bcount = 0;
-                            while (len--)
-                            {
-                                midibyte b = read_byte();
-                                ++bcount;
-                                if (! e.append_sysex_byte(b)) /* end byte?  */
-                                    break;
-                            }
-                            skip(len);                  /* eat it           */
-#else
-                            skip(len);                  /* eat it           */
-                            if (m_data[m_pos-1] != 0xF7)
+                            s.append_event(e);
+                            bool get_song_info =
+                                track == 0 &&
+                                mtype == EVENT_META_TEXT_EVENT &&
+                                ! got_song_info;
+
+                            if (get_song_info)
                             {
-                                std::string m = "SysEx terminator F7 not found";
-                                (void) set_error_dump(m);
+                                got_song_info = true;
+                                info.has_song_info = true;
+                                info.song_info = e.get_text();
                             }
-#endif
                         }
                     }
                     else
-                    {
-                        (void) set_error_dump
-                        (
-                            "Unexpected meta code", midilong(status)
-                        );
-                    }
+                        return trackstatus::fatal;
+
+                    break;
+
+                case EVENT_META_MIDI_CHANNEL:       /* FF 20 01 cc      */
+                case EVENT_META_MIDI_PORT:          /* FF 21 01 pp      */
+                case EVENT_META_SMPTE_OFFSET:       /* FF 54 03 t t t   */
+
+                    (void) read_meta_data(s, e, mtype, len);
                     break;
 
                 default:
 
+                    if (rc().verbose())
+                    {
+                        std::string m = "Illegal meta value skipped";
+                        (void) set_error_dump(m);
+                    }
+                    break;
+                }
+            }
+            else if (status == EVENT_MIDI_SYSEX)        /* 0xF0 */
+            {
+                /*
+                 * Some files do not properly encode SysEx messages;
+                 * see the function banner for notes.
+                 */
+
+                midibyte check = read_byte();
+                if (is_sysex_special_id(check))
+                {
                     /*
-                     * Some files (e.g. 2rock.mid, which has "00 24 40"
-                     * hanging out there all alone at offset 0xba) have junk
-                     * in them.
+                     * TMI: "SysEx ID byte = 7D to 7F");
                      */
-
-                    (void) set_error_dump
-                    (
-                        "Unsupported MIDI event", midilong(status)
-                    );
-                    return true;        /* allow further processing */
-                    break;
                 }
-            }                          /* while not done loading Trk chunk */
+                else                                /* handle normally  */
+                {
+                    --m_pos;                        /* put byte back    */
+                    len = read_varinum();           /* sysex            */
+#if defined SEQ66_USE_SYSEX_PROCESSING
+                    int bcount = 0;
+                    while (len--)
+                    {
+                        midibyte b = read_byte();
+                        ++bcount;
+                        if (! e.append_sysex_byte(b)) /* end byte?  */
+                            break;
+                    }
+                    skip(len);                      /* eat it           */
+#else
+                    skip(len);                      /* eat it           */
+                    if (m_data[m_pos-1] != 0xF7)
+                    {
+                        std::string m = "SysEx terminator F7 not found";
+                        (void) set_error_dump(m);
+                    }
+#endif
+                }
+            }
+            else
+            {
+                (void) set_error_dump
+                (
+                    "Unexpected meta code", midilong(status)
+                );
+            }
+            break;
+
+        default:
 
             /*
-             * Sequence has been filled, add it to the performance or SMF 0
-             * splitter.  If there was no sequence number embedded in the
-             * track, use the for-loop track number.  It's not fool-proof.
-             * "If the ID numbers are omitted, the sequences' locations in
-             * order in the file are used as defaults."
+             * Some files (e.g. 2rock.mid, which has "00 24 40"
+             * hanging out there all alone at offset 0xba) have junk
+             * in them.
              */
 
-            if (seqnum == c_midishort_max)
-                seqnum = track;
+            (void) set_error_dump
+            (
+                "Unsupported MIDI event", midilong(status)
+            );
+            return trackstatus::stop;      /* no further processing   */
+            break;
+        }
+    }                          /* while not done loading Trk chunk */
 
-            if (seqnum < c_prop_seq_number)
-            {
-                s.set_midi_channel(tentative_channel);
-                if (! is_null_buss(buss_override))
-                    (void) s.set_midi_bus(buss_override);
+    /*
+     * If there was no sequence number embedded in the track, use the
+     * track number.  It's not fool-proof.  "If the ID numbers are omitted,
+     * the sequences' locations in order in the file are used as defaults."
+     */
 
-                if (is_smf0)
-                    (void) m_smf0_splitter.log_main_sequence(s, seqnum);
-                else
-                    finalize_sequence(p, s, seqnum, screenset);
-            }
-        }
+    if (seqnum == c_midishort_max)
+        seqnum = track;
+
+    info.seqnum = seqnum;
+    info.channel = tentative_channel;
+    return trackstatus::ok;
+}
+
+/**
+ *  Gives the performer the tempo, time signature, and song information that
+ *  parse_track() recorded for track 0.  Called on the thread that owns the
+ *  performer, after the parse, in track order.
+ */
+
+void
+midifile::apply_track (performer & p, const trackinfo & info)
+{
+    if (info.bpm > 0.0)
+    {
+        p.set_beats_per_minute(info.bpm);
+        p.us_per_quarter_note(info.us_per_qn);
+    }
+#if defined SEQ66_USE_TRACK_0_AS_GLOBAL_TIME_SIG
+    if (info.beats_per_bar > 0)
+    {
+        p.set_beats_per_bar(info.beats_per_bar);
+        p.set_beat_width(info.beat_width);
+        p.clocks_per_metronome(info.clocks_per_metronome);
+        p.set_32nds_per_quarter(info.thirtyseconds);
+    }
+#endif
+    if (info.has_song_info)
+        p.song_info(info.song_info);
+}
+
+/**
+ *  Sequence has been filled, add it to the performance or SMF 0 splitter.
+ *  A sequence with a number in the proprietary range is not installed, and
+ *  is deleted.
+ */
+
+void
+midifile::install_track
+(
+    performer & p, trackinfo & info,
+    int screenset, bool is_smf0, midibyte buss_override
+)
+{
+    sequence & s = *info.seq;
+    if (info.seqnum < c_prop_seq_number)
+    {
+        s.set_midi_channel(info.channel);
+        if (! is_null_buss(buss_override))
+            (void) s.set_midi_bus(buss_override);
+
+        if (is_smf0)
+            (void) m_smf0_splitter.log_main_sequence(s, info.seqnum);
         else
-        {
-            if (track > 0)                              /* non-fatal later  */
-            {
-                (void) set_error_dump("Unknown MIDI track ID, skipping...", ID);
-            }
-            else                                        /* fatal in 1st one */
-            {
-                result = set_error_dump("First track unsupported track ID", ID);
-                break;
-            }
-            skip(TrackLength);
-        }
-    }                                                   /* for each track   */
-    return result;
+            (void) finalize_sequence(p, s, info.seqnum, screenset);
+    }
+    else
+    {
+        delete info.seq;
+        info.seq = nullptr;
+    }
 }
 
 sequence *
@@ -2636,8 +2979,91 @@ midifile::write_track (const midi_vector & lst)
     midilong tracksize = midilong(lst.size());
     write_long(c_mtrk_tag);                 /* magic number 'MTrk'          */
     write_long(tracksize);
-    while (! lst.done())                    /* write the track data         */
-        write_byte(lst.get());
+    m_file_bytes.insert                      /* write the track data         */
+    (
+        m_file_bytes.end(), lst.data(), lst.data() + tracksize
+    );
+}
+
+/**
+ *  Writes the output buffer to the file in one call.  The data goes to a
+ *  temporary file in the same directory, which is flushed to the disk and
+ *  then renamed over the destination, after which the directory is synced
+ *  as well.  The rename is atomic (on Windows, MoveFileEx() is used), so a
+ *  crash or a full disk during a save (or an autosave) never leaves a
+ *  half-written MIDI file; the old file stays intact.  The buffer is cleared
+ *  in any case.
+ *
+ *  If the MIDI file is a symbolic link, the file it points to is replaced,
+ *  not the link, and the new file gets the permissions (and, if allowed,
+ *  the owner) of the old one.  If the rename fails and the destination is
+ *  somehow gone, the temporary file is kept, and its name is reported.
+ *
+ * \param errmsg
+ *      The message to use if the file cannot be opened.
+ *
+ * \return
+ *      Returns true if the file was written and renamed into place.
+ */
+
+bool
+midifile::write_file (const std::string & errmsg)
+{
+    std::string target = get_full_path(m_name);     /* follow a symlink     */
+    if (target.empty())
+        target = m_name;                            /* a brand-new file     */
+
+    std::string tmpname = target + ".tmp";
+    bool keeptemp = false;
+    bool result = false;
+    std::FILE * file = file_create_for_write(tmpname);
+    if (not_nullptr(file))
+    {
+        std::size_t count = m_file_bytes.size();
+        result = std::fwrite(m_file_bytes.data(), 1, count, file) == count;
+        if (result)
+            result = file_sync(file, tmpname);      /* data on disk first   */
+
+        if (! file_close(file, tmpname))
+            result = false;
+
+        if (result)
+        {
+            bool existed = file_exists(target);
+            if (existed)
+                (void) file_copy_mode(target, tmpname);
+
+            result = file_replace(tmpname, target);
+            if (result)
+            {
+                std::string path;
+                std::string base;
+                (void) filename_split(target, path, base);
+                (void) directory_sync(path);        /* make rename durable  */
+            }
+            else if (existed && ! file_exists(target))
+            {
+                m_error_message =
+                    "Failed to rename MIDI file into place; the new data is "
+                    "in " + tmpname;
+
+                keeptemp = true;                    /* do not delete it!    */
+            }
+            else
+                m_error_message = "Failed to rename MIDI file into place.";
+        }
+        else
+            m_error_message = "Error writing MIDI file.";
+
+        if (! result && ! keeptemp)
+            (void) file_delete(tmpname);
+    }
+    else
+        m_error_message = errmsg;
+
+    m_file_bytes.clear();
+    m_file_bytes.shrink_to_fit();            /* don't hold a large buffer    */
+    return result;
 }
 
 /**
@@ -2711,11 +3137,20 @@ midifile::write (performer & p, bool doseqspec)
         {
             infoprintf("Highest track is %d", sequencehigh - 1);
         }
+        std::size_t estimate = c_minimum_midi_file_size + c_bytes_per_track;
         for (int i = 0; i < sequencehigh; ++i)
         {
             if (p.is_seq_active(i))
+            {
+                seq::pointer s = p.get_sequence(i);
                 ++numtracks;             /* count number of active tracks   */
+                if (s)
+                    estimate += c_bytes_per_track +
+                        c_bytes_per_event * std::size_t(s->event_count());
+            }
         }
+        m_file_bytes.clear();
+        m_file_bytes.reserve(estimate);
         result = numtracks > 0;
         if (result)
         {
@@ -2777,33 +3212,8 @@ midifile::write (performer & p, bool doseqspec)
             m_error_message = "Could not write SeqSpec track.";
     }
     if (result)
-    {
-        std::ofstream file
-        (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
-        );
-        if (file.is_open())
-        {
-            char file_buffer[c_midi_line_max];      /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-            for (auto c : m_char_list)              /* list of midibytes    */
-            {
-                char kc = char(c);
-                file.write(&kc, 1);
-                if (file.fail())
-                {
-                    m_error_message = "Error writing byte.";
-                    result = false;
-                }
-            }
-            m_char_list.clear();
-        }
-        else
-        {
-            m_error_message = "Failed to open MIDI file for writing.";
-            result = false;
-        }
-    }
+        result = write_file("Failed to open MIDI file for writing.");
+
     if (result)
         p.unmodify();               /* it worked, tell performer about it   */
 
@@ -2873,6 +3283,7 @@ midifile::write_song (performer & p)
     int numtracks = p.count_exportable();
     bool result = numtracks > 0;
     m_error_message.clear();
+    m_file_bytes.clear();
     if (result)
     {
         int midiformat = p.smf_format();
@@ -2935,29 +3346,132 @@ midifile::write_song (performer & p)
             }
         }
     }
+    if (result)
+        result = write_file("Failed to open MIDI file for export.");
+
+    return result;
+}
+
+/**
+ *  Writes the output of an offline render, performer::render_song(), as a
+ *  plain SMF 1 file that any sequencer can play.  Unlike write_song(), the
+ *  events are those that actually went out during playback, so that mutes,
+ *  transposed triggers, and the like are already applied.
+ *
+ *  Track 0 holds the tempo map of the song.  Then each output buss that got
+ *  events gets a track, named after the buss, holding the events in the
+ *  order they were played.  A temporary sequence is used to hold each track,
+ *  so that the usual midi_vector code writes it out; no SeqSpec data is
+ *  written.
+ *
+ * \param p
+ *      Provides the performer, for the tempo map and the buss names.
+ *
+ * \param cl
+ *      Provides the captured events, stamped with their song position.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.  If false is returned,
+ *      then m_error_message will contain a description of the error.
+ */
+
+bool
+midifile::write_render
+(
+    performer & p,
+    const mastermidibase::capturelist & cl
+)
+{
+    automutex locker(m_mutex);
+    bool result = ! cl.empty();
+    m_error_message.clear();
+    m_file_bytes.clear();
     if (result)
     {
-        std::ofstream file
+        midipulse endtick = 0;
+        std::vector<bool> busused(c_busscount_max, false);
+        for (const auto & c : cl)
+        {
+            if (c.cp_event.timestamp() > endtick)
+                endtick = c.cp_event.timestamp();
+
+            if (c.cp_bus < c_busscount_max)
+                busused[c.cp_bus] = true;
+        }
+
+        int numtracks = 1;                          /* the tempo track      */
+        for (bool used : busused)
+        {
+            if (used)
+                ++numtracks;
+        }
+        msgprintf
         (
-            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+            msglevel::status, "Rendering song to SMF 1, %d ppqn, %d tracks",
+            m_ppqn, numtracks
         );
-        if (file.is_open())
+        result = write_header(numtracks, 1);
+        if (result)
         {
-            char file_buffer[c_midi_line_max];      /* enable bufferization */
-            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
-            for (auto c : m_char_list)
+            tempomap::pointer tmap = p.tempo_map();
+            sequence tempotrack(m_ppqn);
+            tempotrack.set_name("Tempo");
+            tempotrack.append_event(create_tempo_event(0, tmap->base_bpm()));
+            for (const auto & tc : tmap->get_changes())
             {
-                char kc = char(c);
-                file.write(&kc, 1);
+                if (tc.tc_tick <= endtick)
+                    (void) tempotrack.append_event
+                    (
+                        create_tempo_event(tc.tc_tick, tc.tc_bpm)
+                    );
             }
-            m_char_list.clear();
+            tempotrack.sort_events();
+            (void) tempotrack.set_length(endtick, false, false);
+
+            midi_vector tlst(tempotrack);
+            tlst.fill(0, p, false);
+            write_track(tlst);
         }
-        else
+
+        int track = 1;
+        for (int bus = 0; result && bus < c_busscount_max; ++bus)
         {
-            m_error_message = "Failed to open MIDI file for export.";
-            result = false;
+            if (busused[bus])
+            {
+                sequence seq(m_ppqn);
+                std::string name = p.master_bus()->get_midi_bus_name
+                (
+                    bussbyte(bus), midibase::io::output
+                );
+                seq.set_name(name.empty() ? "Bus " + std::to_string(bus) : name);
+                (void) seq.set_midi_channel(null_channel());
+                for (const auto & c : cl)
+                {
+                    if (c.cp_bus == bussbyte(bus))
+                    {
+                        event e = c.cp_event;
+                        if (e.has_channel() && ! is_null_channel(c.cp_channel))
+                            e.set_channel(c.cp_channel);
+
+                        (void) seq.append_event(e);
+                    }
+                }
+                seq.sort_events();
+                (void) seq.set_length(endtick, false, false);
+
+                midi_vector lst(seq);
+                lst.fill(track++, p, false);
+                write_track(lst);
+            }
         }
     }
+    else
+    {
+        m_error_message = "The song rendered no events to write.";
+    }
+    if (result)
+        result = write_file("Failed to open MIDI file for render.");
+
     return result;
 }
 
@@ -3344,6 +3858,14 @@ midifile::set_error_dump (const std::string & msg, unsigned long value)
  * \param [out] errmsg
  *      If the function fails, this string is filled with the error message.
  *
+ * \param addtorecent
+ *      If true, the file is added to the recent-files list.
+ *
+ * \param preloaded
+ *      If not null, and not empty, this is the content of the file, already
+ *      read into memory, and it is parsed instead of opening the file.  The
+ *      buffer is consumed.
+ *
  * \return
  *      Returns true if reading the MIDI/WRK file succeeded. As a side-effect,
  *      the usrsettings::file_ppqn() is set to return the final PPQN to be
@@ -3357,7 +3879,8 @@ read_midi_file
     const std::string & fn,
     int ppqn,                                   /* might get altered        */
     std::string & errmsg,
-    bool addtorecent
+    bool addtorecent,
+    midibytes * preloaded
 )
 {
     bool result = file_readable(fn);            /* how to disable Save?     */
@@ -3377,7 +3900,12 @@ read_midi_file
         p.clear_all();                          /* see banner notes         */
         result = bool(f);
         if (result)
+        {
+            if (not_nullptr(preloaded) && ! preloaded->empty())
+                f->preload(*preloaded);
+
             result = f->parse(p, 0);
+        }
 
         if (result)
         {
@@ -3417,6 +3945,49 @@ read_midi_file
     return result;
 }
 
+/**
+ *  Reads a whole MIDI/WRK file into memory, without parsing it.  This is
+ *  the I/O part of read_midi_file(), usable from a background thread, since
+ *  it touches neither the performer nor the settings.
+ *
+ * \param fn
+ *      The full path specification for the file to be read.
+ *
+ * \param [out] data
+ *      The destination for the file data.  Cleared if the read fails.
+ *
+ * \return
+ *      Returns true if the whole file was read.
+ */
+
+bool
+read_midi_bytes (const std::string & fn, midibytes & data)
+{
+    bool result = false;
+    std::ifstream file(fn, std::ios::in | std::ios::binary | std::ios::ate);
+    data.clear();
+    if (file.is_open())
+    {
+        std::streamoff len = file.tellg();
+        if (len > 0)
+        {
+            try
+            {
+                data.resize(size_t(len));
+                file.seekg(0, std::ios::beg);
+                result = bool(file.read((char *)(data.data()), len));
+            }
+            catch (const std::bad_alloc &)
+            {
+                result = false;
+            }
+        }
+        if (! result)
+            data.clear();
+    }
+    return result;
+}
+
 bool
 write_midi_file
 (
@@ -0,0 +1,261 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempomap.cpp
+ *
+ *  This module defines the tempo map used for converting between pulses,
+ *  microseconds, and JACK frames when the song changes tempo.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  Formerly, tempo changes were applied only as a side-effect of playing the
+ *  Set Tempo events, so that any conversion of a pulse to a time used the
+ *  tempo currently in force, which is wrong for any position before or after
+ *  the next tempo change.
+ */
+
+#include <algorithm>                    /* std::upper_bound()               */
+
+#include "midi/tempomap.hpp"            /* seq66::tempomap class            */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  The default constructor creates a map at 120 BPM and 192 PPQN, good only
+ *  as a placeholder.
+ */
+
+tempomap::tempomap () : tempomap (192, 4, 120.0)
+{
+    // no code
+}
+
+/**
+ *  Creates a map with only the base tempo.
+ *
+ * \param ppqn
+ *      The resolution of the song.  If not valid, 192 is used.
+ *
+ * \param beatwidth
+ *      The beat width of the song.  If not valid, 4 is used.
+ *
+ * \param basebpm
+ *      The tempo at the start of the song, before the first tempo change.
+ */
+
+tempomap::tempomap (int ppqn, int beatwidth, midibpm basebpm) :
+    m_segments      (),
+    m_ppqn          (ppqn > 0 ? ppqn : 192),
+    m_beat_width    (beatwidth > 0 ? beatwidth : 4)
+{
+    segment s;
+    s.ts_tick = 0;
+    s.ts_bpm = basebpm > 0.0 ? basebpm : 120.0 ;
+    s.ts_us = 0.0;
+    s.ts_us_per_tick = us_per_tick(s.ts_bpm);
+    m_segments.push_back(s);
+}
+
+/**
+ *  Replaces the tempo changes of the map.  Only the segments from the first
+ *  change that differs from the existing map are recomputed, so that editing
+ *  a tempo event near the end of a long song does not rework the whole map.
+ *
+ * \param tc
+ *      The tempo changes, sorted by tick.  Changes at the same tick are kept
+ *      in order, and the last one wins, as in playback.
+ *
+ * \return
+ *      Returns true if the map changed.
+ */
+
+bool
+tempomap::assign (const changes & tc)
+{
+    std::size_t keep = 1;                           /* the base segment     */
+    while (keep < m_segments.size() && keep <= tc.size())
+    {
+        const segment & s = m_segments[keep];
+        const change & c = tc[keep - 1];
+        if (s.ts_tick == c.tc_tick && s.ts_bpm == c.tc_bpm)
+            ++keep;
+        else
+            break;
+    }
+    bool result = keep != m_segments.size() || keep != tc.size() + 1;
+    if (result)
+    {
+        m_segments.resize(keep);
+        for (auto ci = tc.cbegin() + (keep - 1); ci != tc.cend(); ++ci)
+            append(ci->tc_tick, ci->tc_bpm);
+    }
+    return result;
+}
+
+/**
+ *  Adds a segment after the last one.  A change with a bad tempo keeps the
+ *  tempo of the previous segment, so that the segments still line up with
+ *  the list of changes.
+ */
+
+void
+tempomap::append (midipulse tick, midibpm bpm)
+{
+    const segment & last = m_segments.back();
+    segment s;
+    if (tick < last.ts_tick)
+        tick = last.ts_tick;                        /* not sorted, clamp    */
+
+    s.ts_tick = tick;
+    s.ts_bpm = bpm > 0.0 ? bpm : last.ts_bpm ;
+    s.ts_us = last.ts_us + double(tick - last.ts_tick) * last.ts_us_per_tick;
+    s.ts_us_per_tick = us_per_tick(s.ts_bpm);
+    m_segments.push_back(s);
+}
+
+/**
+ *  The length of a pulse, scaled by the beat width as in output_func().
+ */
+
+double
+tempomap::us_per_tick (midibpm bpm) const
+{
+    return 60000000.0 * m_beat_width / (4.0 * bpm * m_ppqn);
+}
+
+/**
+ *  Finds the segment holding the given pulse, O(log n).
+ */
+
+const tempomap::segment &
+tempomap::find_tick (midipulse tick) const
+{
+    auto it = std::upper_bound
+    (
+        m_segments.cbegin() + 1, m_segments.cend(), tick,
+        [] (midipulse t, const segment & s) { return t < s.ts_tick; }
+    );
+    return *(it - 1);
+}
+
+/**
+ *  Finds the segment holding the given elapsed time, O(log n).
+ */
+
+const tempomap::segment &
+tempomap::find_us (double us) const
+{
+    auto it = std::upper_bound
+    (
+        m_segments.cbegin() + 1, m_segments.cend(), us,
+        [] (double u, const segment & s) { return u < s.ts_us; }
+    );
+    return *(it - 1);
+}
+
+/**
+ * \return
+ *      Returns the tempo changes of the map, without the base tempo, for
+ *      writing them out as Set Tempo events.
+ */
+
+tempomap::changes
+tempomap::get_changes () const
+{
+    changes result;
+    for (auto si = m_segments.cbegin() + 1; si != m_segments.cend(); ++si)
+        result.emplace_back(si->ts_tick, si->ts_bpm);
+
+    return result;
+}
+
+/**
+ * \return
+ *      Returns the tick of the first tempo change after the given tick, or
+ *      c_null_midipulse if there is none.
+ */
+
+midipulse
+tempomap::next_change (midipulse tick) const
+{
+    auto it = std::upper_bound
+    (
+        m_segments.cbegin() + 1, m_segments.cend(), tick,
+        [] (midipulse t, const segment & s) { return t < s.ts_tick; }
+    );
+    return it != m_segments.cend() ? it->ts_tick : c_null_midipulse ;
+}
+
+/**
+ *  Converts a song position to the time elapsed since the start of the song.
+ */
+
+double
+tempomap::tick_to_us (midipulse tick) const
+{
+    if (tick <= 0)
+        return 0.0;
+
+    const segment & s = find_tick(tick);
+    return s.ts_us + double(tick - s.ts_tick) * s.ts_us_per_tick;
+}
+
+/**
+ *  Converts the time elapsed since the start of the song to a song position.
+ */
+
+midipulse
+tempomap::us_to_tick (double us) const
+{
+    if (us <= 0.0)
+        return 0;
+
+    const segment & s = find_us(us);
+    return s.ts_tick + midipulse((us - s.ts_us) / s.ts_us_per_tick);
+}
+
+double
+tempomap::tick_to_frame (midipulse tick, double framerate) const
+{
+    return tick_to_us(tick) * framerate / 1000000.0;
+}
+
+midipulse
+tempomap::frame_to_tick (double frame, double framerate) const
+{
+    return framerate > 0.0 ? us_to_tick(frame * 1000000.0 / framerate) : 0 ;
+}
+
+}           // namespace seq66
+
+/*
+ * tempomap.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
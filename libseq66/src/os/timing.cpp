@@ -177,6 +177,36 @@ microsleep (int us)
     return result;
 }
 
+/**
+ *  Sleeps until the given absolute time, as measured by microtime() (i.e.
+ *  CLOCK_MONOTONIC).  Unlike microsleep(), lateness in waking up does not
+ *  carry over into the next sleep when the caller advances the deadline by
+ *  a fixed amount, so a periodic loop does not drift.  A signal interruption
+ *  restarts the wait for the same deadline.
+ *
+ * \param us
+ *      Provides the absolute wake-up time in microseconds.
+ *
+ * \return
+ *      Returns true if the deadline was reached, including the case where it
+ *      had already passed.
+ */
+
+bool
+microsleep_until (long us)
+{
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    int rc;
+    do
+    {
+        rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+    while (rc == EINTR);
+    return rc == 0;
+}
+
 #elif defined SEQ66_PLATFORM_WINDOWS
 
 /**
@@ -214,6 +244,24 @@ microsleep (int us)
     return result;
 }
 
+/**
+ *  Windows has no absolute-time sleep on the microtime() clock, so this
+ *  version converts the deadline to a relative microsleep().
+ *
+ * \param us
+ *      Provides the absolute wake-up time in microseconds.
+ *
+ * \return
+ *      Returns true if the deadline was reached.
+ */
+
+bool
+microsleep_until (long us)
+{
+    long remaining = us - microtime();
+    return remaining > 0 ? microsleep(int(remaining)) : true ;
+}
+
 #endif
 
 /*
@@ -302,6 +302,15 @@ static const int c_delay_stop_ms = 100;
 
 static const int c_long_path_max = 56;
 
+/**
+ *  The number of notifications that can wait for the consumer.  Since the
+ *  consumer drops the duplicates, this needs to cover only the distinct
+ *  notifications raised in a few GUI frames.  If the queue fills, the
+ *  notification is delivered directly, as in older versions.
+ */
+
+static const int c_notice_queue_size = 1024;
+
 /**
  *  Principal constructor.
  */
@@ -351,6 +360,7 @@ performer::performer (int ppqn, int rows, int columns) :
     m_is_running            (false),
     m_is_pattern_playing    (false),
     m_needs_update          (true),
+    m_change_generation     (0),
     m_is_busy               (false),            /* try this flag for now    */
     m_looping               (false),
     m_song_recording        (false),
@@ -361,6 +371,14 @@ performer::performer (int ppqn, int rows, int columns) :
     m_file_ppqn             (0),
     m_bpm                   (usr().midi_beats_per_minute()),
     m_resolution_change     (true),
+    m_tempo_map
+    (
+        std::make_shared<tempomap>(m_ppqn, usr().midi_beat_width(), m_bpm)
+    ),
+    m_tempo_map_mutex       (),
+    m_retired_tempo_maps    (),
+    m_tempo_map_stale       (false),
+    m_tempo_map_base        (0.0),
     m_current_beats         (0),
     m_delta_us              (0),
     m_base_time_ms          (0),
@@ -404,6 +422,10 @@ performer::performer (int ppqn, int rows, int columns) :
     m_have_redo             (false),
     m_redo_vect             (),
     m_notify                (),
+    m_notices               (c_notice_queue_size),
+    m_notice_batch          (),
+    m_notice_index          (),
+    m_notify_thread         (std::this_thread::get_id()),
     m_signalled_changes     (! usr().app_is_headless()),
     m_seq_edit_pending      (false),
     m_event_edit_pending    (false),
@@ -615,11 +637,199 @@ performer::modified () const
     return result;
 }
 
+/**
+ *  Hands a notification to the callbacks.  If raised by the thread that
+ *  owns the callbacks, any queued notifications are delivered first, to
+ *  keep the order, and then this one is delivered at once.  Otherwise it is
+ *  queued for deliver_notifications(), so that the output and input threads
+ *  never run GUI or control-output code.  If the queue is full, it is
+ *  delivered directly, as before, rather than lost.  Either way, the change
+ *  generation is bumped, so that the views repaint on their next frame.
+ */
+
+void
+performer::post_notice (const notice & n)
+{
+    redraw_needed();
+    if (std::this_thread::get_id() == m_notify_thread)
+    {
+        (void) deliver_notifications();
+        dispatch_notice(n);
+    }
+    else if (! m_notices.push(n))
+        dispatch_notice(n);
+}
+
+/**
+ *  Delivers the notifications queued by the other threads.  Meant to be
+ *  called once per GUI frame (or poll cycle in seq66cli), only on the thread
+ *  that created the performer.  The notifications raised since the last
+ *  call are coalesced:  when the same kind of notification for the same
+ *  pattern (or set, etc.), with the same flag and playlist action, was
+ *  raised more than once, only the last one is delivered, in the position of
+ *  the last one.  Song changes and group-learn notices are never coalesced.  If an earlier one asked for
+ *  the user-interface to be recreated, or marked a change while the last one
+ *  did not, the last one inherits that change value, so that it is not lost.
+ *  Likewise, if any of them asked for an announcement to the control
+ *  surface, the last one makes it.
+ *
+ *  The batch is coalesced in one pass, keeping in m_notice_index the
+ *  position of the latest notice for each key, and marking the ones it
+ *  supersedes, followed by one compacting pass.
+ *
+ *  A callback can raise another notification, which calls back here, so the
+ *  batch is taken out of m_notice_batch while it is delivered.
+ *
+ * \return
+ *      Returns the number of notifications delivered.
+ */
+
+int
+performer::deliver_notifications ()
+{
+    notice n;
+    std::vector<notice> batch;
+    batch.swap(m_notice_batch);                 /* reuse its storage        */
+    batch.clear();
+    std::size_t superseded = 0;
+    m_notice_index.clear();
+    while (m_notices.pop(n))
+    {
+        if (n.coalescable())
+        {
+            auto slot = m_notice_index.emplace(n.key(), batch.size());
+            if (! slot.second)
+            {
+                notice & prior = batch[slot.first->second];
+                prior.n_superseded = true;      /* keep the latest position */
+                ++superseded;
+                if (prior.n_mod == change::recreate || n.n_mod == change::no)
+                    n.n_mod = prior.n_mod;
+
+                if (prior.n_announce)
+                    n.n_announce = true;
+
+                slot.first->second = batch.size();
+            }
+        }
+        batch.push_back(n);
+    }
+    if (superseded > 0)
+    {
+        batch.erase
+        (
+            std::remove_if
+            (
+                batch.begin(), batch.end(),
+                [] (const notice & x) { return x.n_superseded; }
+            ),
+            batch.end()
+        );
+    }
+
+    if (m_tempo_map_stale.exchange(false))
+        (void) update_tempo_map(m_tempo_map_base.exchange(0.0));
+
+    int result = int(batch.size());
+    for (const auto & nb : batch)
+        dispatch_notice(nb);
+
+    batch.clear();
+    m_notice_batch.swap(batch);
+    return result;
+}
+
+/**
+ *  Calls the callbacks for one notification.  Runs on the consumer thread,
+ *  so this is also where control output for trigger changes is sent.
+ */
+
+void
+performer::dispatch_notice (const notice & n)
+{
+    using index = callbacks::index;
+    switch (n.n_kind)
+    {
+    case index::group_learn:
+
+        for (auto notify : m_notify)
+            (void) notify->on_group_learn(n.n_flag);
+        break;
+
+    case index::mutes_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_mutes_change(n.n_number, n.n_mod);
+        break;
+
+    case index::set_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_set_change(n.n_number, n.n_mod);
+        break;
+
+    case index::sequence_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_sequence_change(n.n_number, n.n_mod);
+        break;
+
+    case index::automation_change:
+
+        for (auto notify : m_notify)
+        {
+            (void) notify->on_automation_change
+            (
+                static_cast<automation::slot>(n.n_number)
+            );
+        }
+        break;
+
+    case index::ui_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_ui_change(n.n_number);
+        break;
+
+    case index::trigger_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_trigger_change(n.n_number);
+
+        if (n.n_announce)
+        {
+            seq::number seqno = n.n_number;
+            if (seq_in_playing_screen(seqno))
+            {
+                const seq::pointer s = get_sequence(seqno);
+                seqno %= screenset_size();
+                announce_sequence(s, seqno);
+            }
+        }
+        break;
+
+    case index::resolution_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_resolution_change(n.n_number, n.n_bpm, n.n_mod);
+        break;
+
+    case index::song_change:
+
+        for (auto notify : m_notify)
+            (void) notify->on_song_action(n.n_flag, n.n_action);
+        break;
+
+    default:                                    /* group_learn_complete     */
+
+        break;
+    }
+}
+
 void
 performer::notify_automation_change (automation::slot s)
 {
-    for (auto notify : m_notify)
-        (void) notify->on_automation_change(s);
+    post_notice(notice(callbacks::index::automation_change, int(s)));
 }
 
 /*
@@ -635,18 +845,16 @@ performer::notify_set_change (screenset::number setno, change mod)
     if (changed(mod))
         modify();
 
-    for (auto notify : m_notify)
-        (void) notify->on_set_change(setno, mod);
+    post_notice(notice(callbacks::index::set_change, int(setno), mod));
 }
 
 void
 performer::notify_mutes_change (mutegroup::number mutesno, change mod)
 {
-    for (auto notify : m_notify)
-        (void) notify->on_mutes_change(mutesno, mod);
-
     if (mod == change::yes)
         modify();
+
+    post_notice(notice(callbacks::index::mutes_change, int(mutesno), mod));
 }
 
 /**
@@ -662,8 +870,10 @@ performer::notify_sequence_change (seq::number seqno, change mod)
     if (mod == change::yes || redo)
         modify();
 
-    for (auto notify : m_notify)
-        (void) notify->on_sequence_change(seqno, mod);
+    if (seqno == rc().tempo_track_number())
+        refresh_tempo_map();
+
+    post_notice(notice(callbacks::index::sequence_change, int(seqno), mod));
 }
 
 /**
@@ -673,29 +883,24 @@ performer::notify_sequence_change (seq::number seqno, change mod)
 void
 performer::notify_ui_change (seq::number seqno, change /*mod*/)
 {
-    for (auto notify : m_notify)
-        (void) notify->on_ui_change(seqno);
+    post_notice(notice(callbacks::index::ui_change, int(seqno)));
 }
 
 void
 performer::notify_trigger_change (seq::number seqno, change mod)
 {
-    for (auto notify : m_notify)
-        (void) notify->on_trigger_change(seqno);
+    bool tempotrack =
+        seqno == rc().tempo_track_number() || seqno == seq::all();
+
+    if (tempotrack)
+        refresh_tempo_map();
 
     if (mod == change::yes)
-    {
         modify();
-    }
-    else if (mod == change::no)
-    {
-        if (seq_in_playing_screen(seqno))
-        {
-            const seq::pointer s = get_sequence(seqno);
-            seqno %= screenset_size();
-            announce_sequence(s, seqno);
-        }
-    }
+
+    notice n(callbacks::index::trigger_change, int(seqno), mod);
+    n.n_announce = mod == change::no;           /* e.g. from output thread  */
+    post_notice(n);
 }
 
 /**
@@ -706,12 +911,13 @@ performer::notify_trigger_change (seq::number seqno, change mod)
 void
 performer::notify_resolution_change (int ppqn, midibpm bpm, change mod)
 {
+    notice n(callbacks::index::resolution_change, ppqn, mod);
+    n.n_bpm = bpm;
     m_resolution_change = true;
-    for (auto notify : m_notify)
-        (void) notify->on_resolution_change(ppqn, bpm, mod);
-
     if (mod == change::yes)
         modify();
+
+    post_notice(n);
 }
 
 /**
@@ -724,8 +930,10 @@ performer::notify_resolution_change (int ppqn, midibpm bpm, change mod)
 void
 performer::notify_song_action (bool signalit, playlist::action act)
 {
-    for (auto notify : m_notify)
-        (void) notify->on_song_action(signalit, act);
+    notice n(callbacks::index::song_change);
+    n.n_flag = signalit;
+    n.n_action = act;
+    post_notice(n);
 }
 
 /*
@@ -809,6 +1017,8 @@ performer::get_settings (const rcsettings & rcs, const usrsettings & usrs)
     if (micount == 0 && kcount > 0)
         m_midi_control_in.add_blank_controls(m_key_controls);
 
+    m_midi_control_in.compile(m_operations);    /* flat table for input     */
+
     m_midi_control_out = rcs.midi_control_out();
 
     if (rc().mute_group_file_active())
@@ -1540,9 +1750,20 @@ performer::pulses_to_measure_string (midipulse tick) const
     return seq66::pulses_to_measurestring(tick, mt);
 }
 
+/**
+ *  In Song mode, the time is looked up in the tempo map, so that the time
+ *  shown accounts for the tempo changes before the tick.
+ */
+
 std::string
 performer::pulses_to_time_string (midipulse tick) const
 {
+    if (song_mode())
+    {
+        tempomap::pointer tmap = tempo_map();
+        if (! tmap->empty())
+            return seq66::microseconds_to_time_string(tmap->tick_to_us(tick));
+    }
     return seq66::pulses_to_time_string(tick, bpm(), ppqn());
 }
 
@@ -2300,6 +2521,7 @@ performer::change_ppqn (int p)
 
             notify_resolution_change(ppqn(), get_beats_per_minute(), ch);
         }
+        refresh_tempo_map();
     }
     return result;
 }
@@ -2580,6 +2802,12 @@ bool
 performer::set_beats_per_minute (midibpm bp, bool user_change)
 {
     bool result = usr().bpm_is_valid(bp);
+    if (result && (user_change || ! is_running()))
+    {
+        midibpm basebpm = fix_tempo(bp);            /* the song's own tempo */
+        if (basebpm != tempo_map()->base_bpm())
+            refresh_tempo_map(basebpm);
+    }
     if (result)
         result = bp != get_beats_per_minute();
 
@@ -2799,11 +3027,171 @@ performer::log_current_tempo ()
                 s->set_length(tick);
 
             modify();   /* notify_sequence_change(seqno) too problematic    */
+            refresh_tempo_map();
+        }
+    }
+    return result;
+}
+
+/**
+ *  Rebuilds the tempo map from the Set Tempo events of the tempo track.  In
+ *  Song mode the tempo track plays only inside its triggers, so each tempo
+ *  event is placed at every song position where a trigger plays it:  the
+ *  event timestamp, plus the trigger offset, plus a multiple of the pattern
+ *  length.  If the tempo track has no triggers, the map holds no changes.
+ *
+ *  Only the part of the map after the first differing change is recomputed,
+ *  and the new map is published only if it differs from the old one.
+ *
+ * \param basebpm
+ *      The tempo before the first tempo change.  If 0 (the default), the
+ *      base tempo of the current map is kept.
+ *
+ * \return
+ *      Returns true if a new map was published.
+ */
+
+bool
+performer::update_tempo_map (midibpm basebpm)
+{
+    tempomap::changes tc;
+    seq::pointer s = get_sequence(rc().tempo_track_number());
+    if (s)
+    {
+        sequence::snapshot evs = s->play_events();
+        midipulse len = s->get_length();
+        if (evs && len > 0)
+        {
+            auto trigs = s->get_triggers();         /* a copy, under lock   */
+            for (const auto & t : trigs)
+            {
+                midipulse start = t.tick_start();
+                midipulse end = t.tick_end();
+                midipulse phase = (start - t.offset()) % len;
+                if (phase < 0)
+                    phase += len;
+
+                for (midipulse base = start - phase; base <= end; base += len)
+                {
+                    for (const auto & e : *evs)
+                    {
+                        if (e.is_tempo())
+                        {
+                            midipulse tick = base + e.timestamp();
+                            if (tick > end)
+                                break;
+
+                            midibpm bp = evs->tempo(e);
+                            if (tick >= start && usr().bpm_is_valid(bp))
+                                tc.emplace_back(tick, bp);
+                        }
+                    }
+                }
+            }
+            std::stable_sort(tc.begin(), tc.end());
         }
     }
+
+    /*
+     * The sequence is not locked while the map lock is held, so that the
+     * tempo track, which calls here from flush_events() while locked, cannot
+     * deadlock with us.  The replaced maps are freed here, on the GUI
+     * thread, once no reader holds them.
+     */
+
+    automutex locker(m_tempo_map_mutex);
+    tempomap::pointer current = tempo_map();
+    if (basebpm <= 0.0)
+        basebpm = current->base_bpm();
+
+    bool rebase =
+        current->ppqn() != ppqn() ||
+        current->beat_width() != get_beat_width() ||
+        current->base_bpm() != basebpm;
+
+    std::shared_ptr<tempomap> tmap = rebase ?
+        std::make_shared<tempomap>(ppqn(), get_beat_width(), basebpm) :
+        std::make_shared<tempomap>(*current) ;
+
+    bool result = tmap->assign(tc) || rebase;
+    if (result)
+    {
+        tempomap::pointer cp = tmap;
+        std::atomic_store(&m_tempo_map, cp);
+        m_retired_tempo_maps.push_back(current);
+    }
+    current.reset();
+    m_retired_tempo_maps.erase
+    (
+        std::remove_if
+        (
+            m_retired_tempo_maps.begin(), m_retired_tempo_maps.end(),
+            [] (const tempomap::pointer & tp) { return tp.use_count() == 1; }
+        ),
+        m_retired_tempo_maps.end()
+    );
+    return result;
+}
+
+/**
+ *  Called when the events or triggers of the tempo track change, or the base
+ *  tempo changes.  On the thread that owns the callbacks (the GUI thread),
+ *  the tempo map is rebuilt at once.  On any other thread, such as the MIDI
+ *  input thread while recording, or a JACK callback, the map is only marked
+ *  as stale, and deliver_notifications() rebuilds it, so that the output and
+ *  JACK threads never build a map, nor lock the tempo track to get its
+ *  triggers.
+ *
+ * \param basebpm
+ *      The new base tempo, or 0 (the default) to keep the current one.
+ */
+
+void
+performer::refresh_tempo_map (midibpm basebpm)
+{
+    if (std::this_thread::get_id() == m_notify_thread)
+    {
+        (void) update_tempo_map(basebpm);
+    }
+    else
+    {
+        if (basebpm > 0.0)
+            m_tempo_map_base = basebpm;
+
+        m_tempo_map_stale = true;
+    }
+}
+
+/**
+ *  The tempo map drives the tempo only in Song mode, and only if this
+ *  performer keeps the time:  not when following MIDI clock, and not when
+ *  JACK transport is rolling under another Master.
+ */
+
+bool
+performer::tempo_map_active () const
+{
+    bool result = song_mode() && ! m_usemidiclock;
+    if (result)
+        result = ! (is_jack_running() && ! is_jack_master());
+
+    if (result)
+        result = ! tempo_map()->empty();
+
     return result;
 }
 
+/**
+ *  Used by sequence::play() to skip the Set Tempo events that the output
+ *  thread already applies from the tempo map.
+ */
+
+bool
+performer::tempo_map_owns (seq::number seqno) const
+{
+    return seqno == rc().tempo_track_number() && tempo_map_active();
+}
+
 /**
  *  Also calls mapper().set_playscreen(), and notifies any performer::callbacks
  *  subscribers. Note that the setsmode values of normal and autoarm indicate
@@ -3491,6 +3879,7 @@ performer::set_beat_width (int bw, bool user_change)
                 return result;
             }
         );
+        refresh_tempo_map();
     }
     return result;
 }
@@ -3626,6 +4015,9 @@ performer::finish ()
         m_io_active = false;                /* set done() for predicate     */
         m_is_running = false;               /* set is_running() off         */
         cv().signal();                      /* signal the end of play       */
+        if (m_master_bus)
+            m_master_bus->wake_input();     /* unblock the input thread     */
+
         if (m_out_thread_launched && m_out_thread.joinable())
         {
             m_out_thread.join();
@@ -4228,6 +4620,22 @@ performer::jack_reposition (midipulse tick, midipulse stoptick)
  *
  *          if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
  *
+ *      That relative sleep has been replaced by microsleep_until() with an
+ *      absolute deadline:  the previous deadline plus the trigger width, or
+ *      the time the next MIDI clock is due, whichever is sooner.  The tick is
+ *      computed from the start time of the current tempo segment (which is
+ *      closed whenever m_resolution_change is raised), so late wake-ups no
+ *      longer accumulate.
+ *
+ * Tempo map:
+ *
+ *      In Song mode, the tempo changes of the tempo track are applied from
+ *      the tempo map, not by sequence::play() when it passes a Set Tempo
+ *      event.  Playback starts (and loops back) with the tempo in force at
+ *      that tick, and when a cycle crosses a tempo change, the tempo segment
+ *      is closed at the time the change was reached, rather than at the
+ *      time of the wake-up that noticed it.
+ *
  * Stazed code (when ready):
  *
  *      If we reposition key-p, FF, rewind, adjust delta_tick for change then
@@ -4288,6 +4696,20 @@ performer::output_func ()
         pad().set_current_tick(startpoint);
         set_last_ticks(startpoint);
 
+        /*
+         * In Song mode, start with the tempo in force at the start point,
+         * rather than whatever tempo was last played.  See "Tempo map" in
+         * the function banner.  The map is kept up to date by the GUI
+         * thread; it is not rebuilt here.
+         */
+
+        tempomap::pointer tmap;
+        if (tempo_map_active())
+        {
+            tmap = tempo_map();
+            (void) set_beats_per_minute(tmap->bpm(startpoint));
+        }
+
         /*
          * We still need to make sure the BPM and PPQN changes are airtight!
          * Check jack_set_beats_per_minute() and change_ppqn()
@@ -4298,37 +4720,74 @@ performer::output_func ()
         int ppqn = m_master_bus->get_ppqn();
         int bpm_times_ppqn = bpmfactor * ppqn;
         double dct = double_ticks_from_ppqn(ppqn);
-        double pus = pulse_length_us(bpmfactor, ppqn);
-        long current;                           /* current time             */
-        long elapsed_us, delta_us;              /* current - last           */
-        long last = microtime();                /* beginning time           */
+        long anchor_us = microtime();           /* start of tempo segment   */
+        long long anchor_num = 0;               /* ticks x 60000000 at it   */
+        long long ticks_done = 0;               /* whole ticks handed out   */
+        long deadline = anchor_us;              /* absolute wake-up time    */
         m_resolution_change = false;            /* BPM/PPQN                 */
         while (is_running())
         {
+            long current = microtime();
+            if (tmap)
+                tmap = tempo_map();             /* pick up tempo edits      */
+
             if (m_resolution_change)            /* an atomic boolean        */
             {
+                anchor_num += (long long)(bpm_times_ppqn) *
+                    (current - anchor_us);      /* close the old segment    */
+
+                anchor_us = current;
                 bwdenom = 4.0 / get_beat_width();
                 bpmfactor = m_master_bus->get_beats_per_minute() * bwdenom;
                 ppqn = m_master_bus->get_ppqn();
                 bpm_times_ppqn = bpmfactor * ppqn;
                 dct = double_ticks_from_ppqn(ppqn);
-                pus = pulse_length_us(bpmfactor, ppqn);
                 m_resolution_change = false;
             }
 
             /**
-             *  See note 2 and the microsleep() note in the function banner.
-             *  See note 3 in the function banner.
+             *  See note 2 in the function banner.  The tick position is
+             *  derived from the start of the current tempo segment, not
+             *  accumulated from wake-up to wake-up, so it cannot drift.
              */
 
-            current = microtime();
-            delta_us = elapsed_us = current - last;
+            long long num = anchor_num +
+                (long long)(bpm_times_ppqn) * (current - anchor_us);
 
-            long long delta_tick_num = bpm_times_ppqn * delta_us +
-                pad().js_delta_tick_frac;
+            long long ticks = num / 60000000LL;
+            long delta_tick = long(ticks - ticks_done);
+            if (tmap && ! is_jack_running())
+            {
+                /*
+                 * If this cycle crosses tempo changes, close the segment at
+                 * the exact time each change is reached, and count the rest
+                 * of the cycle at the new tempo.
+                 */
 
-            long delta_tick = long(delta_tick_num / 60000000LL);
-            pad().js_delta_tick_frac = long(delta_tick_num % 60000000LL);
+                midipulse here = midipulse(pad().js_current_tick);
+                midipulse tc = tmap->next_change(here);
+                while
+                (
+                    ! is_null_midipulse(tc) && bpm_times_ppqn > 0 &&
+                    here + delta_tick >= tc
+                )
+                {
+                    long long tcnum = (ticks_done + (tc - here)) * 60000000LL;
+                    anchor_us += long((tcnum - anchor_num) / bpm_times_ppqn);
+                    anchor_num = tcnum;
+                    (void) set_beats_per_minute(tmap->bpm(tc));
+                    bpmfactor = m_master_bus->get_beats_per_minute() * bwdenom;
+                    bpm_times_ppqn = bpmfactor * ppqn;
+                    m_resolution_change = false;
+                    num = anchor_num +
+                        (long long)(bpm_times_ppqn) * (current - anchor_us);
+
+                    ticks = num / 60000000LL;
+                    delta_tick = long(ticks - ticks_done);
+                    tc = tmap->next_change(tc);
+                }
+            }
+            ticks_done = ticks;
             if (m_usemidiclock)
             {
                 delta_tick = m_midiclocktick;       /* int to long          */
@@ -4344,7 +4803,17 @@ performer::output_func ()
             bool jackrunning = jack_output(pad());
             if (jackrunning)
             {
-                // No additional code needed besides the output() call above.
+                /*
+                 * JACK moves the tick; as Master, we follow the tempo map
+                 * at that tick.
+                 */
+
+                if (tmap)
+                {
+                    midibpm bp = tmap->bpm(midipulse(pad().js_current_tick));
+                    if (bp != get_beats_per_minute())
+                        (void) set_beats_per_minute(bp);
+                }
             }
             else
                 pad().add_delta_tick(delta_tick);   /* add to current ticks */
@@ -4388,6 +4857,8 @@ performer::output_func ()
                         midipulse ltick = get_left_tick();
                         set_last_ticks(ltick);
                         pad().js_current_tick = double(ltick) + leftover_tick;
+                        if (tmap)
+                            (void) set_beats_per_minute(tmap->bpm(ltick));
                     }
                     else
                         jack_position_once = false;
@@ -4413,23 +4884,36 @@ performer::output_func ()
             }
 
             /*
-             *  See "microsleep() call" in banner.  Code is similar to line
-             *  3096 above.
+             *  See "microsleep() call" in banner.  The next wake-up is an
+             *  absolute deadline one trigger-width after the previous one,
+             *  or the time of the next MIDI clock if that comes sooner.  If
+             *  we are already past the deadline, we note the underrun and
+             *  start a new series of deadlines from now, instead of trying
+             *  to catch up with a burst of short cycles.
              */
 
-            last = current;
-            current = microtime();
-            elapsed_us = current - last;
-            delta_us = c_thread_trigger_width_us - elapsed_us;
+            deadline += c_thread_trigger_width_us;
+            if (bpm_times_ppqn > 0)
+            {
+                double clocks = pad().js_clock_tick / dct;
+                double toclock = (std::floor(clocks) + 1.0) * dct -
+                    pad().js_clock_tick;        /* ticks to the next clock  */
+
+                long long clocknum = num +
+                    (long long)(toclock * 60000000.0);
 
-            double next_clock_delta = dct - 1;
-            double next_clock_delta_us = next_clock_delta * pus;
-            if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
-                delta_us = long(next_clock_delta_us);
+                long clock_us = anchor_us +
+                    long((clocknum - anchor_num) / bpm_times_ppqn);
+
+                if (clock_us < deadline)
+                    deadline = clock_us;
+            }
 
+            current = microtime();
+            long delta_us = deadline - current;
             if (delta_us > 0)
             {
-                (void) microsleep(int(delta_us));           /* timing.hpp   */
+                (void) microsleep_until(deadline);      /* timing.hpp       */
                 m_delta_us = 0;
             }
             else
@@ -4446,6 +4930,7 @@ performer::output_func ()
                 }
 #endif
                 m_delta_us = delta_us;
+                deadline = current;
             }
             if (pad().js_jack_stopped)
                 inner_stop();
@@ -4614,6 +5099,8 @@ performer::poll_cycle ()
                 }
             }
         } while (m_master_bus->is_more_input());
+        if (m_master_bus->is_dumping())
+            m_master_bus->merge_recorded_input();   /* see stream_event()   */
     }
     return result;
 }
@@ -4937,8 +5424,7 @@ performer::start_playing ()
 
     start_jack();
     start();
-    for (auto notify : m_notify)
-        (void) notify->on_automation_change(automation::slot::start);
+    notify_automation_change(automation::slot::start);
 }
 
 void
@@ -4951,8 +5437,7 @@ performer::play_count_in ()
     }
     start_jack();
     start();
-    for (auto notify : m_notify)
-        (void) notify->on_automation_change(automation::slot::start);
+    notify_automation_change(automation::slot::start);
 }
 
 /**
@@ -5025,8 +5510,14 @@ performer::stop_playing (bool rewind)
         if (rewind)
             set_tick(0);                                /* ca 2022-09-25    */
 
-        for (auto notify : m_notify)
-            (void) notify->on_automation_change(automation::slot::stop);
+        if (rc().verbose())
+        {
+            int hanging = hanging_notes();
+            if (hanging > 0)
+                infoprintf("Stop: %d notes still on; use panic", hanging);
+        }
+
+        notify_automation_change(automation::slot::stop);
     }
 }
 
@@ -5177,6 +5668,95 @@ performer::play (midipulse tick)
     }
 }
 
+/**
+ *  Renders the song offline, writing what would be played to a standard MIDI
+ *  file.  This drives the same play() code used by output_func(), but from a
+ *  virtual clock that advances one pulse per cycle as fast as the CPU allows,
+ *  rather than waiting on the tempo.  The output busses are diverted into a
+ *  list by mastermidibase::capture_output(), so nothing goes out the ports.
+ *  The events keep the song position at which they were played, so the
+ *  result does not depend on the speed of the machine, and the time taken
+ *  makes a repeatable measure of the throughput of the playback engine.
+ *
+ *  The song is rendered from the start to the end of the last trigger.
+ *  Playback must be stopped; the playback mode, position, and tempo are
+ *  restored afterward.
+ *
+ * \param fn
+ *      The name of the MIDI file to write.
+ *
+ * \param [out] errmsg
+ *      Holds the reason for failure, if any.
+ *
+ * \return
+ *      Returns true if the song was rendered and written.
+ */
+
+bool
+performer::render_song (const std::string & fn, std::string & errmsg)
+{
+    midipulse endtick = get_max_trigger();
+    bool result = false;
+    if (fn.empty())
+        errmsg = "No file-name to render to";
+    else if (is_running() || is_pattern_playing())
+        errmsg = "Cannot render while playing";
+    else if (! m_master_bus)
+        errmsg = "No master bus to render from";
+    else if (endtick <= 0)
+        errmsg = "The song has no triggers to render";
+    else
+        result = true;
+
+    if (! result)
+        return false;
+
+    sequence::playback oldmode = song_start_mode();
+    midipulse oldtick = get_tick();
+    midibpm oldbpm = get_beats_per_minute();
+    mastermidibase::capturelist cl;
+    song_start_mode(sequence::playback::song);
+    m_max_extent = 0;                               /* no auto_stop() here  */
+    refresh_tempo_map();
+    off_sequences();
+    set_last_ticks(0);
+    m_master_bus->capture_output(&cl);
+
+    long starttime = microtime();
+    for (midipulse tick = 0; tick <= endtick; ++tick)
+        play(tick);
+
+    reset_sequences();                              /* the final Note Offs  */
+    long elapsed = microtime() - starttime;
+    m_master_bus->capture_output(nullptr);
+    song_start_mode(oldmode);
+    set_tick(oldtick);
+    set_last_ticks(oldtick);
+    (void) set_beats_per_minute(oldbpm);
+
+    double songus = tempo_map()->tick_to_us(endtick);
+    double ratio = elapsed > 0 ? songus / double(elapsed) : 0.0 ;
+    msgprintf
+    (
+        msglevel::status,
+        "Rendered %ld pulses, %d events, in %ld us (%.1fx real time)",
+        long(endtick), int(cl.size()), elapsed, ratio
+    );
+
+    midifile f(fn, ppqn());
+    result = f.write_render(*this, cl);
+    if (result)
+    {
+        file_message("Rendered MIDI file", fn);
+    }
+    else
+    {
+        errmsg = f.error_message();
+        file_error("Render failed", fn);
+    }
+    return result;
+}
+
 void
 performer::play_all_sets (midipulse tick)
 {
@@ -5340,7 +5920,9 @@ performer::all_notes_off ()
 
 /**
  *  Similar to all_notes_off(), but also sends Note Off events directly to the
- *  active busses.  Adapted from Oli Kester's Kepler34 project.
+ *  active busses.  Adapted from Oli Kester's Kepler34 project.  In verbose
+ *  mode, the notes still on after stopping, which the panic turns off, are
+ *  reported.
  */
 
 bool
@@ -5349,6 +5931,11 @@ performer::panic ()
     bool result = bool(m_master_bus);
     stop_playing();
     inner_stop();                                   /* force inner stop     */
+
+    int hanging = hanging_notes();
+    if (hanging > 0 && rc().verbose())
+        infoprintf("Panic: %d hanging notes turned off", hanging);
+
     mapper().panic();
     if (result)
     {
@@ -5363,6 +5950,18 @@ performer::panic ()
     return result;
 }
 
+/**
+ *  Gets the number of notes that the output busses have turned on and not
+ *  yet turned off.  When stopped, these are hanging notes, which panic()
+ *  will turn off.  Reported by stop_playing() and panic() in verbose mode.
+ */
+
+int
+performer::hanging_notes () const
+{
+    return m_master_bus ? m_master_bus->active_note_count() : 0 ;
+}
+
 /**
  *  Toggles the m_hidden flag and sets m_show_hide_pending.  The latter will
  *  be toggled off by the qt5nsmanager, which is the only class that cares
@@ -6469,8 +7068,10 @@ performer::group_learn (bool learning)
     (void) set_ctrl_status(a, automation::ctrlstatus::learn);
     mutes().group_learn(learning);
     midi_control_out().send_learning(learning);
-    for (auto notify : m_notify)
-        (void) notify->on_group_learn(learning);
+
+    notice n(callbacks::index::group_learn);
+    n.n_flag = learning;
+    post_notice(n);
 }
 
 /**
@@ -6492,7 +7093,7 @@ void
 performer::group_learn_complete (const keystroke & k, bool good)
 {
     group_learn(false);
-    for (auto notify : m_notify)
+    for (auto notify : m_notify)                /* keyboard, GUI thread     */
         (void) notify->on_group_learn_complete(k, good);
 
     notify_mutes_change(0, change::yes);
@@ -6976,6 +7577,9 @@ performer::midi_control_keystroke (const keystroke & k)
 
 /**
  *  Looks up the MIDI event and calls the corresponding function, if any.
+ *  The lookup is one access to the flat [status][d0] table that
+ *  midicontrolin::compile() builds from the 'ctrl' setup and the
+ *  operations; it is rebuilt here only if the setup has changed.
  *
  * Note:
  *
@@ -7008,34 +7612,32 @@ performer::midi_control_event (const event & ev, bool recording)
 
     if (result)
     {
-        midicontrol::key k(ev);
-        const midicontrol & incoming = m_midi_control_in.control(k);
-        bool good = incoming.is_usable();
+        if (! m_midi_control_in.compiled())
+            m_midi_control_in.compile(m_operations);
+
+        const midicontrolin::dispatch * incoming =
+            m_midi_control_in.lookup(ev);
+
+        bool good = not_nullptr(incoming);
         if (good)
         {
-            automation::slot s = incoming.slot_number();
-            const midioperation & mop = m_operations.operation(s);
-            if (mop.is_usable())
+            bool process_the_action = incoming->in_range(ev.d1());
+            if (recording)
             {
-                bool process_the_action = incoming.in_range(ev.d1());
-                if (recording)
-                {
-                    /*
-                     * See Note above.
-                     */
-                }
-                if (process_the_action)
-                {
-                    automation::action a = incoming.action_code();
-                    bool invert = incoming.inverse_active();
-                    int d0 = incoming.d0();
-                    int d1 = incoming.d1();
-                    int index = incoming.control_code(); /* in lieu of d1() */
-                    good = mop.call(a, d0, d1, index, invert);
-                }
-                else
-                    good = false;
+                /*
+                 * See Note above.
+                 */
             }
+            if (process_the_action)
+            {
+                good = incoming->dp_operation->call
+                (
+                    incoming->dp_action, incoming->dp_d0, incoming->dp_d1,
+                    incoming->dp_index, incoming->dp_inverse
+                );
+            }
+            else
+                good = false;
         }
         /*
          *  This warning can be misleading, as often the release of a control
@@ -8454,6 +9056,13 @@ performer::automation_playlist
  * \param [out] errmsg
  *      Provides the destination for an error message, if any.
  *
+ * \param addtorecent
+ *      If true (the default), the file is added to the recent-files list.
+ *
+ * \param preloaded
+ *      If not null, provides the file's data, already read into memory by the
+ *      play-list.  See seq66::read_midi_file().
+ *
  * \return
  *      Returns true if the function succeeded.  If false is returned, there
  *      should be an errmsg to display.
@@ -8464,7 +9073,8 @@ performer::read_midi_file
 (
     const std::string & fn,
     std::string & errmsg,
-    bool addtorecent
+    bool addtorecent,
+    midibytes * preloaded
 )
 {
     errmsg.clear();
@@ -8476,9 +9086,13 @@ performer::read_midi_file
     usr().clear_global_seq_features();
     m_song_info.clear();
 
-    bool result = seq66::read_midi_file(*this, fn, ppqn(), errmsg, addtorecent);
+    bool result = seq66::read_midi_file
+    (
+        *this, fn, ppqn(), errmsg, addtorecent, preloaded
+    );
     if (result)
     {
+        refresh_tempo_map(bpm());               /* the file's base tempo    */
         next_song_mode();
         announce_mutes();                       /* cannot forget this one!  */
         notify_mutes_change(0, change::no);
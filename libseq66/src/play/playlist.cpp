@@ -31,6 +31,7 @@
  *  See the playlistfile class for information on the file format.
  */
 
+#include <algorithm>                    /* std::find()                      */
 #include <cctype>                       /* std::toupper() function          */
 #include <iostream>                     /* std::cout                        */
 #include <utility>                      /* std::make_pair()                 */
@@ -88,7 +89,8 @@ playlist::playlist
     m_current_song              (sm_dummy.end()),   // song-list iterator
     m_auto_arm                  (false),
     m_midi_base_directory       (rc().midi_base_directory()),
-    m_show_on_stdout            (show_on_stdout)
+    m_show_on_stdout            (show_on_stdout),
+    m_song_prefetch                ()
 {
     // No code
 }
@@ -160,6 +162,10 @@ playlist::check_song_list (const play_list_t & plist)
  *  Remember that clear_all() will fail if it detects a sequence being edited.
  *  In that case, this function will fail as well.
  *
+ *  If the bytes of the song file were prefetched, they are parsed from
+ *  memory, and the file is not touched again.  Only the disk read is saved;
+ *  the song is still stopped, cleared, and parsed here.
+ *
  * \param fname
  *      The full path to the file to be opened.  If this parameter is empty,
  *      no load is attempted, but playback is stopped and the song is cleared.
@@ -185,7 +191,14 @@ playlist::open_song (const std::string & fname, bool verifymode)
     if (result)
     {
         std::string errmsg_dummy;
-        result = m_performer->read_midi_file(fname, errmsg_dummy, false);
+        midibytes data;
+        bool fetched = ! verifymode && m_song_prefetch &&
+            m_song_prefetch->take(fname, data);
+
+        result = m_performer->read_midi_file
+        (
+            fname, errmsg_dummy, false, fetched ? &data : nullptr
+        );
         if (result && verifymode)
         {
             /* nothing to do yet */
@@ -461,7 +474,11 @@ playlist::open_current_song ()
                 if (! fname.empty())
                 {
                     result = open_song(fname);
-                    if (! result)
+                    if (result)
+                    {
+                        prefetch_neighbors();
+                    }
+                    else
                     {
                         (void) set_file_error_message
                         (
@@ -552,6 +569,41 @@ playlist::open_previous_song (bool opensong)
     return result;
 }
 
+/**
+ *  Asks the song prefetcher to read the file bytes of the next and previous
+ *  songs of the current play-list, as next_song() and previous_song() would
+ *  select them, so that the usual song changes parse from memory.
+ */
+
+void
+playlist::prefetch_neighbors ()
+{
+    if (m_current_list == m_play_lists.end())
+        return;
+
+    song_list & slist = m_current_list->second.ls_song_list;
+    if (m_current_song == slist.end() || slist.size() < 2)
+        return;
+
+    auto nextsong = std::next(m_current_song);
+    if (nextsong == slist.end())
+        nextsong = slist.begin();
+
+    auto prevsong = m_current_song == slist.begin() ?
+        std::prev(slist.end()) : std::prev(m_current_song) ;
+
+    std::vector<std::string> fnames;
+    fnames.push_back(song_filepath(nextsong->second));
+    if (prevsong != nextsong)
+        fnames.push_back(song_filepath(prevsong->second));
+
+    if (! m_song_prefetch)
+        m_song_prefetch.reset(new (std::nothrow) songprefetch());
+
+    if (m_song_prefetch)
+        m_song_prefetch->request(fnames);
+}
+
 /**
  *  Makes a file-error message.
  */
@@ -1710,6 +1762,146 @@ playlist::test ()
      */
 }
 
+/*
+ * --------------------------------------------------------------------------
+ *  playlist::songprefetch
+ * --------------------------------------------------------------------------
+ */
+
+playlist::songprefetch::songprefetch () :
+    synchronizer    (),
+    m_mutex         (),
+    m_wanted        (),
+    m_songs         (),
+    m_pending       (false),
+    m_done          (false),
+    m_thread        ()
+{
+    // no code
+}
+
+/**
+ *  Tells the reading thread to exit, and waits for it.  A file read in
+ *  progress is finished first.
+ */
+
+playlist::songprefetch::~songprefetch ()
+{
+    m_done = true;
+    signal();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+/**
+ *  Replaces the list of songs to keep in memory.  Songs already read are
+ *  kept if still wanted, and dropped otherwise.  Starts the reading thread
+ *  the first time.
+ *
+ * \param fnames
+ *      The full paths of the songs to read ahead.
+ */
+
+void
+playlist::songprefetch::request (const std::vector<std::string> & fnames)
+{
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_wanted = fnames;
+    }
+    if (! m_thread.joinable())
+        m_thread = std::thread(&playlist::songprefetch::run, this);
+
+    m_pending = true;
+    signal();
+}
+
+/**
+ *  Hands over the data of a song, if it has been read.  The data is
+ *  checked against the current size of the file, in case the file was
+ *  rewritten after it was read.
+ *
+ * \param fname
+ *      The full path to the song.
+ *
+ * \param [out] data
+ *      The destination for the song's data.
+ *
+ * \return
+ *      Returns true if the data was available and is still current.
+ */
+
+bool
+playlist::songprefetch::take (const std::string & fname, midibytes & data)
+{
+    bool result = false;
+    std::lock_guard<std::mutex> locker(m_mutex);
+    auto si = m_songs.find(fname);
+    if (si != m_songs.end())
+    {
+        result = si->second.size() == file_size(fname);
+        if (result)
+            data.swap(si->second);
+
+        m_songs.erase(si);
+    }
+    return result;
+}
+
+/**
+ *  The body of the reading thread.  It waits for a request, drops songs that
+ *  are no longer wanted, and reads the ones not yet in memory.  The file
+ *  reads are done without holding the mutex, so that take() never waits on
+ *  the disk.  A newer request abandons the current list.
+ */
+
+void
+playlist::songprefetch::run ()
+{
+    while (! m_done)
+    {
+        (void) wait();
+        if (m_done)
+            break;
+
+        m_pending = false;
+
+        std::vector<std::string> wanted;
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            wanted = m_wanted;
+            for (auto si = m_songs.begin(); si != m_songs.end(); /* ++si */)
+            {
+                auto wi = std::find(wanted.begin(), wanted.end(), si->first);
+                if (wi == wanted.end())
+                    si = m_songs.erase(si);
+                else
+                    ++si;
+            }
+        }
+        for (const auto & fname : wanted)
+        {
+            if (m_pending || m_done)
+                break;
+
+            bool have;
+            {
+                std::lock_guard<std::mutex> locker(m_mutex);
+                have = m_songs.find(fname) != m_songs.end();
+            }
+            if (! have)
+            {
+                midibytes data;
+                if (read_midi_bytes(fname, data))
+                {
+                    std::lock_guard<std::mutex> locker(m_mutex);
+                    m_songs[fname].swap(data);
+                }
+            }
+        }
+    }
+}
+
 }           // namespace seq66
 
 /*
@@ -48,6 +48,7 @@
  *      point, and add better locking coverage if necessary.
  */
 
+#include <algorithm>                    /* std::upper_bound(), std::sort()  */
 #include <cstring>                      /* std::memset()                    */
 #include <cmath>                        /* std::trunc()                     */
 
@@ -140,6 +141,9 @@ sequence::note_info::show () const
 sequence::sequence (int ppqn) :
     m_parent                    (nullptr),      /* set when seq installed   */
     m_events                    (),
+    m_play_events               (std::make_shared<eventpack>()),
+    m_record_events             (),
+    m_record_pending            (false),
     m_triggers                  (*this),
 #if defined SEQ66_TIME_SIG_DRAWING
     m_time_signatures           (),
@@ -148,7 +152,10 @@ sequence::sequence (int ppqn) :
     m_have_undo                 (false),
     m_have_redo                 (false),
     m_events_undo               (),
-    m_events_redo               (),
+    m_undo_range_valid          (false),
+    m_undo_lo                   (0),
+    m_undo_hi                   (-1),
+    m_undo_tracking             (0),
     m_channel_match             (false),
     m_midi_channel              (0),            /* null_channel() better?   */
     m_free_channel              (false),
@@ -185,6 +192,8 @@ sequence::sequence (int ppqn) :
     m_dirty_edit                (true),
     m_dirty_perf                (true),
     m_dirty_names               (true),
+    m_draw_generation           (0),
+    m_trigger_generation        (0),
     m_is_modified               (false),
     m_seq_in_edit               (false),
     m_status                    (0),
@@ -193,6 +202,10 @@ sequence::sequence (int ppqn) :
     m_last_tick                 (0),
     m_queued_tick               (0),
     m_trigger_offset            (0),
+    m_play_index                (0),
+    m_play_base                 (0),
+    m_play_next                 (c_null_midipulse),
+    m_play_length               (0),
     m_maxbeats                  (c_maxbeats),
     m_ppqn                      (choose_ppqn(ppqn)),
     m_seq_number                (unassigned()),
@@ -212,10 +225,12 @@ sequence::sequence (int ppqn) :
     m_musical_key               (usr().seqedit_key()),
     m_musical_scale             (usr().seqedit_scale()),
     m_background_sequence       (usr().seqedit_bgsequence()),
-    m_mutex                     ()
+    m_mutex                     (),
+    m_play_mutex                (),
+    m_edit_depth                (0),
+    m_publish_pending           (false)
 {
-    sm_preserve_velocity = usr().preserve_velocity();
-    sm_fingerprint_size = usr().fingerprint_size();
+    load_defaults();
     m_events.set_length(m_length);
     m_triggers.set_ppqn(int(m_ppqn));
     m_triggers.set_length(m_length);
@@ -223,6 +238,25 @@ sequence::sequence (int ppqn) :
         p = 0;
 }
 
+/**
+ *  Copies the user-settings defaults shared by all sequences into the static
+ *  members.  They are written only if changed, so that once this function
+ *  has been called, sequences can be constructed on several threads (see
+ *  midifile::parse_tracks()) without racing on the statics.
+ */
+
+void
+sequence::load_defaults ()
+{
+    short velocity = usr().preserve_velocity();
+    int fpsize = usr().fingerprint_size();
+    if (sm_preserve_velocity != velocity)
+        sm_preserve_velocity = velocity;
+
+    if (sm_fingerprint_size != fpsize)
+        sm_fingerprint_size = fpsize;
+}
+
 /**
  *  A rote destructor.
  */
@@ -259,6 +293,10 @@ sequence::~sequence ()
  *  we will rebuild it if its configuration is changed on the fly. So
  *  no flag-raising needed.
  *
+ *  This function is for changes to the events: it also publishes them for
+ *  playback.  Changes to the settings of the pattern call mark_modified(),
+ *  and changes to the triggers call mark_trigger_modified().
+ *
  * \param notifychange
  *      If true (the default), then notification is done (via a
  *      performer::callbacks function).
@@ -266,6 +304,24 @@ sequence::~sequence ()
 
 void
 sequence::modify (bool notifychange)
+{
+    publish_events();
+    mark_modified(notifychange);
+}
+
+/**
+ *  Does what modify() does, except for publishing the events.  Used by the
+ *  setters of pattern settings, such as the color, the key, or the channel,
+ *  that do not change the events, so that the playback snapshot is not
+ *  rebuilt for nothing.  Trigger changes use mark_trigger_modified().
+ *
+ * \param notifychange
+ *      If true (the default), then notification is done (via a
+ *      performer::callbacks function).
+ */
+
+void
+sequence::mark_modified (bool notifychange)
 {
     if (is_normal_seq())                /* currently, a seq-number < 1024   */
     {
@@ -290,7 +346,7 @@ sequence::partial_assign (const sequence & rhs, bool toclipboard)
 {
     if (this != &rhs)
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         m_parent                    = rhs.m_parent;         /* a pointer    */
         m_events                    = rhs.m_events;         /* container!   */
         m_triggers                  = rhs.m_triggers;       /* 2021-07-27   */
@@ -303,7 +359,6 @@ sequence::partial_assign (const sequence & rhs, bool toclipboard)
          *  m_have_undo
          *  m_have_redo
          *  m_events_undo
-         *  m_events_redo
          */
 
         m_channel_match             = rhs.m_channel_match;
@@ -378,6 +433,7 @@ sequence::partial_assign (const sequence & rhs, bool toclipboard)
             p = 0;
 
         m_last_tick = 0;                            /* reset to tick 0      */
+        m_play_next = c_null_midipulse;             /* re-seat play cursor  */
         verify_and_link();                          /* NoteOn <---> NoteOff */
         if (! toclipboard)
             modify();
@@ -421,7 +477,7 @@ sequence::musical_key (int key, bool user_change)
         {
             m_musical_key = midibyte(key);
             if (user_change)
-                modify();
+                mark_modified();
         }
     }
 }
@@ -436,7 +492,7 @@ sequence::musical_scale (int scale, bool user_change)
         {
             m_musical_scale = midibyte(scale);
             if (user_change)
-                modify();
+                mark_modified();
         }
     }
 }
@@ -452,7 +508,7 @@ sequence::background_sequence (int bs, bool user_change)
         {
             m_background_sequence = short(bs);
             if (user_change)
-                modify();
+                mark_modified();
         }
     }
     return result;
@@ -478,7 +534,7 @@ sequence::background_sequence (int bs, bool user_change)
 bool
 sequence::set_color (int c, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     if (c >= 0 || c == c_seq_color_none)
     {
@@ -487,7 +543,7 @@ sequence::set_color (int c, bool user_change)
             m_seq_color = colorbyte(c);
             result = true;
             if (user_change)
-                modify();                   /* no easy way to undo this     */
+                mark_modified();            /* no easy way to undo this     */
         }
     }
     return result;
@@ -496,7 +552,7 @@ sequence::set_color (int c, bool user_change)
 bool
 sequence::loop_count_max (int m, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     if (m >= 0 && m != m_loop_count_max)
     {
@@ -506,7 +562,7 @@ sequence::loop_count_max (int m, bool user_change)
 
     }
     if (result)
-        modify();                               /* have pending changes */
+        mark_modified();                        /* have pending changes */
 
     return result;
 }
@@ -537,28 +593,28 @@ sequence::empty_coloring ()
 int
 sequence::event_count () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.count();
 }
 
 int
 sequence::note_count () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.note_count();
 }
 
 int
 sequence::playable_count () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.playable_count();
 }
 
 bool
 sequence::is_playable () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.is_playable();
 }
 
@@ -711,6 +767,9 @@ sequence::measure_number (midipulse p)
 
 /**
  *  Pushes the event-list into the undo-list or the upcoming undo-hold-list.
+ *  Only the events changed since the last undo action are stored.  The
+ *  journal's limit is refreshed from usr().undo_limit() here, so that a
+ *  change in the 'usr' file applies to every pattern.
  *
  * \threadsafe
  *
@@ -723,15 +782,96 @@ sequence::measure_number (midipulse p)
 void
 sequence::push_undo (bool hold)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (hold)
-        m_events_undo.push(m_events_undo_hold);     /* stazed   */
+    {
+        m_events_undo.limit(usr().undo_limit_bytes());
+        undo_hint();
+        m_events_undo.push(m_events.events(), m_events_undo_hold.events());
+    }
     else
-        m_events_undo.push(m_events);
+        push_events_undo();
 
     set_have_undo();                                /* stazed   */
 }
 
+/**
+ *  Saves the events in the undo journal, without locking.  Used by the
+ *  editing functions that lock for the whole operation.
+ */
+
+void
+sequence::push_events_undo ()
+{
+    m_events_undo.limit(usr().undo_limit_bytes());
+    undo_hint();
+    m_events_undo.push(m_events.events());
+}
+
+/**
+ *  Called just before each undo-journal action.  If the undo range is
+ *  valid, tells the journal how many events before and after it are
+ *  unchanged, found by binary search, since the events are sorted.  Then
+ *  starts a new, empty range, as the journal action brings its copy of the
+ *  events up to date.
+ */
+
+void
+sequence::undo_hint ()
+{
+    if (m_undo_range_valid)
+    {
+        const event::buffer & evs = m_events.events();
+        std::size_t head = evs.size();
+        std::size_t tail = 0;
+        if (m_undo_lo <= m_undo_hi)
+        {
+            midipulse lo = m_undo_lo;
+            midipulse hi = m_undo_hi;
+            auto first = std::lower_bound
+            (
+                evs.begin(), evs.end(), lo,
+                [] (const event & e, midipulse t) { return e.timestamp() < t; }
+            );
+            auto last = std::upper_bound
+            (
+                first, evs.end(), hi,
+                [] (midipulse t, const event & e) { return t < e.timestamp(); }
+            );
+            head = std::size_t(first - evs.begin());
+            tail = std::size_t(evs.end() - last);
+        }
+        m_events_undo.hint(head, tail);
+    }
+    m_undo_range_valid = true;
+    m_undo_lo = 0;
+    m_undo_hi = -1;                                 /* empty range          */
+}
+
+/**
+ *  Adds ticks to the undo range.  Called by the editing functions, inside
+ *  an undotracker, for every event they add, remove, or change, at both its
+ *  old and its new time.
+ */
+
+void
+sequence::touch_undo_range (midipulse lo, midipulse hi)
+{
+    if (m_undo_lo > m_undo_hi)
+    {
+        m_undo_lo = lo;
+        m_undo_hi = hi;
+    }
+    else
+    {
+        if (lo < m_undo_lo)
+            m_undo_lo = lo;
+
+        if (hi > m_undo_hi)
+            m_undo_hi = hi;
+    }
+}
+
 /**
  *  Do not modify the performer here!  First, just because we push-undo does
  *  not mean a change will occur.  Second, we are now checking for changed
@@ -742,13 +882,15 @@ sequence::push_undo (bool hold)
 void
 sequence::set_have_undo ()
 {
-    m_have_undo = m_events_undo.size() > 0;     // if (m_have_undo) modify();
+    m_have_undo = m_events_undo.have_undo();    // if (m_have_undo) modify();
 }
 
 /**
  *  If there are items on the undo list, this function pushes the event-list
  *  into the redo-list, puts the top of the undo-list into the event-list, pops
  *  from the undo-list, calls verify_and_link(), and then calls unselect().
+ *  With the undo journal, only the changed range of events is replaced, so
+ *  the meta-event flags are rescanned.
  *
  *  We would like to be able to set performer's modify flag to false here, but
  *  other sequences might still be in a modified state.  We could add a modify
@@ -760,12 +902,12 @@ sequence::set_have_undo ()
 void
 sequence::pop_undo ()
 {
-    automutex locker(m_mutex);
-    if (! m_events_undo.empty())                // stazed: m_list_undo
+    editlock locker(*this);
+    undo_hint();
+    if (m_events_undo.undo(m_events.events()))  // stazed: m_list_undo
     {
-        m_events_redo.push(m_events);
-        m_events = m_events_undo.top();
-        m_events_undo.pop();
+        undotracker tracker(*this);             /* relinking moves nothing  */
+        m_events.scan_meta_events();
         verify_and_link();
         unselect();
     }
@@ -785,12 +927,12 @@ sequence::pop_undo ()
 void
 sequence::pop_redo ()
 {
-    automutex locker(m_mutex);
-    if (! m_events_redo.empty())                // move to triggers module?
+    editlock locker(*this);
+    undo_hint();
+    if (m_events_undo.redo(m_events.events()))  // move to triggers module?
     {
-        m_events_undo.push(m_events);
-        m_events = m_events_redo.top();
-        m_events_redo.pop();
+        undotracker tracker(*this);             /* relinking moves nothing  */
+        m_events.scan_meta_events();
         verify_and_link();
         unselect();
     }
@@ -807,7 +949,8 @@ sequence::pop_redo ()
 void
 sequence::push_trigger_undo ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.push_undo(); // todo:  see how stazed's sequence function works
 }
 
@@ -820,7 +963,8 @@ sequence::push_trigger_undo ()
 void
 sequence::pop_trigger_undo ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.pop_undo();
 }
 
@@ -833,7 +977,8 @@ sequence::pop_trigger_undo ()
 void
 sequence::pop_trigger_redo ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.pop_redo();
 }
 
@@ -852,7 +997,7 @@ sequence::pop_trigger_redo ()
 bool
 sequence::set_master_midi_bus (const mastermidibus * mmb)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_master_bus = const_cast<mastermidibus *>(mmb);
     return not_nullptr(mmb);
 }
@@ -873,7 +1018,7 @@ sequence::set_master_midi_bus (const mastermidibus * mmb)
 void
 sequence::set_beats_per_bar (int bpb, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modded = false;
     if (bpb != int(m_time_beats_per_measure))
     {
@@ -889,7 +1034,7 @@ sequence::set_beats_per_bar (int bpb, bool user_change)
                 modded = true;
         }
         if (modded)
-            modify();
+            mark_modified();
     }
 }
 
@@ -909,7 +1054,7 @@ sequence::set_beats_per_bar (int bpb, bool user_change)
 void
 sequence::set_beat_width (int bw, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modded = false;
     if (bw != int(m_time_beat_width))
     {
@@ -925,7 +1070,7 @@ sequence::set_beat_width (int bw, bool user_change)
                 modded = true;
         }
         if (modded)
-            modify();
+            mark_modified();
     }
 }
 
@@ -963,7 +1108,7 @@ sequence::set_time_signature (int bpb, int bw)
 midipulse
 sequence::unit_measure (bool reset) const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (m_unit_measure == 0 || reset)
         m_unit_measure = measures_to_ticks();       /* length of 1 measure  */
 
@@ -975,7 +1120,7 @@ sequence::set_measures (int measures)
 {
     bool modded = set_length(measures * unit_measure(true));
     if (modded)
-        modify();
+        mark_modified();
 }
 
 /**
@@ -1100,7 +1245,7 @@ sequence::get_measures () const
 void
 sequence::set_rec_vol (int recvol)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool valid = recvol > 0 && recvol <= usr().max_note_on_velocity();
     if (! valid)
         valid = recvol == usr().preserve_velocity();
@@ -1206,7 +1351,7 @@ sequence::toggle_song_mute ()
 bool
 sequence::toggle_queued ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     set_dirty_mp();
     m_queued = ! m_queued;
 
@@ -1220,6 +1365,124 @@ sequence::toggle_queued ()
     return true;
 }
 
+/**
+ *  Gets the event at which play() or live_play() should start examining the
+ *  event list, and sets m_play_base to the loop-pass base (in global pulses)
+ *  that goes with that event.  Event "stamps" are the event timestamp plus
+ *  this base.
+ *
+ *  If the frame starts where the previous frame left off, the cursor saved
+ *  by park_play_cursor() is used after checking its neighbors; otherwise
+ *  (loop-count restart, relocation, a new trigger offset, or an edit that
+ *  moved events around the cursor) the cursor is re-seated by a binary
+ *  search of the sorted event list.  In steady-state playback this makes
+ *  the cost of play() proportional to the number of events actually
+ *  emitted, rather than to the number of events ahead of the playhead.
+ *
+ *  The caller must hold the playback mutex.
+ *
+ * \param evs
+ *      The playback snapshot of the events.  See play_events().
+ *
+ * \param startstamp
+ *      The start of the frame, already offset in the same way as the event
+ *      stamps.
+ *
+ * \param length
+ *      The non-zero length of the pattern, used for wrapping.
+ *
+ * \return
+ *      Returns the iterator for the first event with a stamp at or after the
+ *      start of the frame.  Returns end() only if the event list is empty.
+ */
+
+eventpack::const_iterator
+sequence::play_cursor
+(
+    const eventpack & evs,
+    midipulse startstamp, midipulse length
+)
+{
+    std::size_t count = evs.size();
+    if (count == 0)
+        return evs.cend();
+
+    bool valid = startstamp == m_play_next &&
+        length == m_play_length && m_play_index < count;
+
+    if (valid)
+    {
+        /*
+         * The cursor is still the lower bound if the event before it
+         * (cyclically) is before the frame, and the event at it is not.
+         */
+
+        auto e = evs.cbegin() + m_play_index;
+        midipulse prevstamp = m_play_index > 0 ?
+            (e - 1)->timestamp() + m_play_base :
+            evs.back().timestamp() + m_play_base - length ;
+
+        valid = prevstamp < startstamp &&
+            e->timestamp() + m_play_base >= startstamp;
+
+        if (valid)
+            return e;
+    }
+
+    midipulse base = (startstamp / length) * length;
+    if (base > startstamp)                          /* negative frame start */
+        base -= length;
+
+    auto e = evs.lower_bound(startstamp - base);
+    if (e == evs.cend())                            /* start in next pass   */
+    {
+        e = evs.cbegin();
+        base += length;
+    }
+    m_play_base = base;
+    return e;
+}
+
+/**
+ *  Saves the playback cursor at the end of play() or live_play(), so that
+ *  the next frame can pick up where this one stopped.
+ *
+ * \param evs
+ *      The playback snapshot that was played.
+ *
+ * \param e
+ *      The first event not yet played, or end() if nothing was played.
+ *
+ * \param base
+ *      The loop-pass base that applies to that event.
+ *
+ * \param nextstamp
+ *      The offset start of the frame expected to come next.
+ *
+ * \param length
+ *      The pattern length used in this frame.
+ */
+
+void
+sequence::park_play_cursor
+(
+    const eventpack & evs, eventpack::const_iterator e,
+    midipulse base, midipulse nextstamp, midipulse length
+)
+{
+    if (e == evs.cend())
+    {
+        m_play_next = c_null_midipulse;
+    }
+    else
+    {
+        m_play_index = std::size_t(e - evs.cbegin());
+        m_play_base = base;
+        m_play_next = nextstamp;
+        m_play_length = length;
+    }
+}
+
 /**
  *  The play() function dumps notes starting from the given tick, and it
  *  pre-buffers ahead.  This function is called by the sequencer thread in
@@ -1274,6 +1537,10 @@ sequence::toggle_queued ()
  *      A song-recording parameter.
  *
  * \threadsafe
+ *      The events are played from the snapshot published by the editing
+ *      functions, and only the playback mutex is locked, so that an edit
+ *      or a redraw cannot stall the output thread.  The trigger
+ *      notification for song recording is made after that lock is released.
  */
 
 void
@@ -1284,7 +1551,28 @@ sequence::play
     bool resumenoteons
 )
 {
-    automutex locker(m_mutex);
+    if (play_frame(tick, playback_mode, resumenoteons))
+        notify_trigger();
+}
+
+/**
+ *  The guts of play(), done under the playback mutex.
+ *
+ * \return
+ *      Returns true if song recording grew a trigger, so that the caller can
+ *      notify the subscribers.
+ */
+
+bool
+sequence::play_frame
+(
+    midipulse tick,
+    bool playback_mode,
+    bool resumenoteons
+)
+{
+    automutex locker(m_play_mutex);
+    bool trigger_added = false;
     bool trigger_turning_off = false;       /* turn off after in-frame play */
     int trigtranspose = 0;                  /* used with c_trig_transpose   */
     midipulse start_tick = m_last_tick;     /* modified in triggers::play() */
@@ -1314,9 +1602,7 @@ sequence::play
         {
             (void) m_parent->calculate_snap(tick);  /* issue #44 redux      */
 
-            bool added = grow_trigger(song_record_tick(), tick);
-            if (added)
-                notify_trigger();
+            trigger_added = grow_trigger(song_record_tick(), tick);
         }
         if (playback_mode)                          /* song mode: triggers  */
         {
@@ -1331,7 +1617,6 @@ sequence::play
         midipulse offset = length - m_trigger_offset;
         midipulse start_tick_offset = start_tick + offset;
         midipulse end_tick_offset = tick + offset;
-        midipulse offset_base = times_played * length;
         if (loop_count_max() > 0)
         {
             if (times_played >= loop_count_max())
@@ -1340,7 +1625,7 @@ sequence::play
                 if (is_metro_seq())                 /* count-in is complete */
                     m_parent->finish_count_in();
 #endif
-                return;
+                return trigger_added;
             }
         }
 
@@ -1348,39 +1633,33 @@ sequence::play
         if (transpose == 0)
             transpose = transposable() ? perf()->get_transpose() : 0 ;
 
-        auto e = m_events.begin();
-        while (e != m_events.end())
+        snapshot evs = play_events();
+        auto e = play_cursor(*evs, start_tick_offset, length);
+        midipulse offset_base = m_play_base;
+        while (e != evs->cend())
         {
-            event & er = eventlist::dref(e);
+            const eventpack::record & er = *e;
             midipulse ts = er.timestamp();
             midipulse stamp = ts + offset_base;
             if (stamp >= start_tick_offset && stamp <= end_tick_offset)
             {
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
+                if (er.is_tempo())
                 {
-                    event trans_event = er;         /* assign ALL members   */
-                    trans_event.transpose_note(transpose);
-                    put_event_on_bus(trans_event);
+                    if (! perf()->tempo_map_owns(seq_number()))
+                        perf()->set_beats_per_minute(evs->tempo(er));
                 }
-                else
+                else if (! er.is_ex_data())         /* transposes notes     */
                 {
-                    if (er.is_tempo())
-                    {
-                        perf()->set_beats_per_minute(er.tempo());
-                    }
-                    else if (! er.is_ex_data())
-                    {
-                        put_event_on_bus(er);       /* frame still going    */
-                    }
+                    put_event_on_bus(*evs, er, stamp - offset, transpose);
                 }
             }
             else if (stamp > end_tick_offset)
                 break;                              /* frame is done        */
 
             ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+            if (e == evs->cend())                   /* did we hit the end ? */
             {
-                e = m_events.begin();               /* yes, start over      */
+                e = evs->cbegin();                  /* yes, start over      */
                 offset_base += length;              /* for another go at it */
 
                 /*
@@ -1393,11 +1672,12 @@ sequence::play
                 (void) microsleep(1);
             }
         }
+        park_play_cursor(*evs, e, offset_base, end_tick_offset + 1, length);
     }
     else
     {
         if (loop_count_max() > 0 && times_played >= loop_count_max())
-            return;                                 /* issue #103           */
+            return trigger_added;                   /* issue #103           */
     }
     if (trigger_turning_off)                        /* triggers: "turn off" */
     {
@@ -1415,6 +1695,8 @@ sequence::play
      *  if (get_queued())
      *      perf()->announce_pattern(seq_number()); // for issue #89        //
      */
+
+    return trigger_added;
 }
 
 /**
@@ -1431,7 +1713,7 @@ sequence::play
 void
 sequence::live_play (midipulse tick)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     midipulse start_tick = m_last_tick;     /* modified in triggers::play() */
     midipulse end_tick = tick;              /* ditto                        */
     if (m_song_mute)
@@ -1443,7 +1725,6 @@ sequence::live_play (midipulse tick)
         midipulse start_tick_offset = start_tick + length;
         midipulse end_tick_offset = end_tick + length;
         midipulse times_played = m_last_tick / length;
-        midipulse offset_base = times_played * length;
         if (loop_count_max() > 0)
         {
             if (times_played >= loop_count_max())
@@ -1456,36 +1737,103 @@ sequence::live_play (midipulse tick)
             }
         }
 
-        auto e = m_events.begin();
-        while (e != m_events.end())
+        snapshot evs = play_events();
+        auto e = play_cursor(*evs, start_tick_offset, length);
+        midipulse offset_base = m_play_base;
+        while (e != evs->cend())
         {
-            event & er = eventlist::dref(e);
+            const eventpack::record & er = *e;
             midipulse stamp = er.timestamp() + offset_base;
             if (stamp >= start_tick_offset && stamp <= end_tick_offset)
             {
 #if defined SUPPORT_TEMPO_IN_LIVE_PLAY
                 if (er.is_tempo())
                 {
-                    perf()->set_beats_per_minute(er.tempo());
+                    perf()->set_beats_per_minute(evs->tempo(er));
                 }
 #endif
-                put_event_on_bus(er);               /* frame still going    */
+                put_event_on_bus(*evs, er, stamp - length); /* still going  */
             }
             else if (stamp > end_tick_offset)
                 break;                              /* frame is done        */
 
             ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+            if (e == evs->cend())                   /* did we hit the end ? */
             {
-                e = m_events.begin();               /* yes, start over      */
+                e = evs->cbegin();                  /* yes, start over      */
                 offset_base += length;              /* for another go at it */
                 (void) microsleep(1);
             }
         }
+        park_play_cursor(*evs, e, offset_base, end_tick_offset + 1, length);
     }
     m_last_tick = end_tick + 1;                     /* for next frame       */
 }
 
+/**
+ *  Marks the sequence as modified due to a trigger change.  The events are
+ *  not published, and the draw generation of the pattern is left alone, so
+ *  that the pattern editors and the grid thumbnail do not redraw; the
+ *  trigger generation and the change generation of the performer are
+ *  bumped instead, for the song editor.  Takes no lock, so the
+ *  song-recording code that runs under the playback mutex can call it.
+ */
+
+void
+sequence::mark_trigger_modified ()
+{
+    if (is_normal_seq())
+    {
+        m_is_modified = true;
+        m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    }
+    ++m_trigger_generation;
+    if (not_nullptr(m_parent))
+        m_parent->redraw_needed();
+}
+
+/**
+ *  Marks the events as changed, so that a new playback snapshot is built.
+ *  Called by modify(), and by the functions that change events without
+ *  calling modify().  User-interface code that assigns to events() directly
+ *  must call this function as well.
+ *
+ *  The snapshot is not built here, but when the outermost editlock is
+ *  released (see flush_events()), so that an operation that calls modify()
+ *  many times, or calls verify_and_link() and then modify(), copies the
+ *  events only once.  Called with no lock held, the editlock here is the
+ *  outermost one, and the snapshot is built before returning.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::publish_events ()
+{
+    editlock locker(*this);
+    m_publish_pending = true;
+    if (m_undo_tracking == 0)
+        m_undo_range_valid = false;             /* an untracked change      */
+}
+
+/**
+ *  Publishes a packed copy of the current events as the playback snapshot.
+ *  The new snapshot is swapped in atomically; the output thread keeps the
+ *  previous one alive until it is done with it.  Called only by the
+ *  editlock destructor, with m_mutex still held.
+ */
+
+void
+sequence::flush_events ()
+{
+    m_publish_pending = false;
+    snapshot evs = std::make_shared<eventpack>(m_events.events());
+    std::atomic_store(&m_play_events, evs);
+    redraw_needed();
+    if (not_nullptr(perf()) && seq_number() == rc().tempo_track_number())
+        perf()->refresh_tempo_map();
+}
+
 /**
  *  This function verifies state: all note-ons have a note-off, and it links
  *  note-offs with their note-ons.
@@ -1500,8 +1848,13 @@ sequence::live_play (midipulse tick)
 void
 sequence::verify_and_link (bool wrap)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    std::size_t count = m_events.events().size();
     m_events.verify_and_link(get_length(), wrap);
+    if (m_events.events().size() != count)
+        m_undo_range_valid = false;             /* pruned, where untracked  */
+
+    publish_events();
 }
 
 /**
@@ -1513,8 +1866,8 @@ sequence::verify_and_link (bool wrap)
 bool
 sequence::edge_fix ()
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);                   /* push_undo(), no lock */
+    editlock locker(*this);
+    push_events_undo();                             /* push_undo(), no lock */
     bool result = m_events.edge_fix(snap(), get_length());
     if (result)
         modify();
@@ -1529,8 +1882,8 @@ sequence::edge_fix ()
 bool
 sequence::remove_unlinked_notes ()
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);                   /* push_undo(), no lock */
+    editlock locker(*this);
+    push_events_undo();                             /* push_undo(), no lock */
     bool result = m_events.remove_unlinked_notes();
     if (result)
         modify();
@@ -1617,8 +1970,12 @@ sequence::remove (event & e)
 bool
 sequence::remove_first_match (const event & e, midipulse starttick)
 {
-    automutex locker(m_mutex);
-    return m_events.remove_first_match(e, starttick);
+    editlock locker(*this);
+    bool result = m_events.remove_first_match(e, starttick);
+    if (result)
+        publish_events();
+
+    return result;
 }
 
 /**
@@ -1628,9 +1985,11 @@ sequence::remove_first_match (const event & e, midipulse starttick)
 void
 sequence::remove_all ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     int count = m_events.count();
     m_events.clear();
+    m_record_events.clear();
+    m_record_pending = false;
     if (count > 0)
         modify();                       /* issue #90 */
 }
@@ -1649,7 +2008,7 @@ sequence::remove_all ()
 bool
 sequence::remove_marked ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (auto & e : m_events)
     {
         if (e.is_marked() && e.is_note_on())
@@ -1675,7 +2034,7 @@ sequence::remove_marked ()
 bool
 sequence::mark_selected ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.mark_selected();
 }
 
@@ -1691,8 +2050,8 @@ sequence::mark_selected ()
 bool
 sequence::remove_selected ()
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo() without lock */
+    editlock locker(*this);
+    push_events_undo();                         /* push_undo() without lock */
 
     bool result = m_events.remove_selected();
     if (result)
@@ -1710,7 +2069,7 @@ sequence::remove_selected ()
 void
 sequence::unpaint_all ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.unpaint_all();
 }
 
@@ -1741,7 +2100,7 @@ sequence::selected_box
     midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     tick_s = m_maxbeats * m_ppqn;
     tick_f = note_h = 0;
@@ -1798,7 +2157,7 @@ sequence::onsets_selected_box
     midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     tick_s = m_maxbeats * m_ppqn;
     tick_f = note_h = 0;
@@ -1861,7 +2220,7 @@ sequence::clipboard_box
     midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     tick_s = m_maxbeats * m_ppqn;
     tick_f = 0;
@@ -1906,7 +2265,7 @@ sequence::clipboard_box
 int
 sequence::get_num_selected_notes () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.count_selected_notes();
 }
 
@@ -1930,7 +2289,7 @@ sequence::get_num_selected_notes () const
 int
 sequence::get_num_selected_events (midibyte status, midibyte cc) const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.count_selected_events(status, cc);
 }
 
@@ -1975,7 +2334,8 @@ sequence::select_note_events
     midipulse tick_f, int note_l, eventlist::select action
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    redraw_needed();
     return m_events.select_note_events(tick_s, note_h, tick_f, note_l, action);
 }
 
@@ -2015,7 +2375,8 @@ sequence::select_events
     midibyte status, midibyte cc, eventlist::select action
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    redraw_needed();
     return m_events.select_events(tick_s, tick_f, status, cc, action);
 }
 
@@ -2046,8 +2407,9 @@ sequence::select_events
 int
 sequence::select_events (midibyte status, midibyte cc, bool inverse)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     midibyte d0, d1;
+    redraw_needed();
     for (auto & er : m_events)
     {
         er.get_data(d0, d1);
@@ -2083,8 +2445,9 @@ sequence::select_events (midibyte status, midibyte cc, bool inverse)
 void
 sequence::select_all ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.select_all();
+    redraw_needed();
 }
 
 void
@@ -2092,8 +2455,9 @@ sequence::select_by_channel (int channel)
 {
     if (is_good_channel(midibyte(channel)))
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         m_events.select_by_channel(channel);
+        redraw_needed();
     }
 }
 
@@ -2102,8 +2466,9 @@ sequence::select_notes_by_channel (int channel)
 {
     if (is_good_channel(midibyte(channel)))
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         m_events.select_notes_by_channel(channel);
+        redraw_needed();
     }
 }
 
@@ -2116,8 +2481,9 @@ sequence::select_notes_by_channel (int channel)
 void
 sequence::unselect ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.unselect_all();
+    redraw_needed();
 }
 
 /**
@@ -2167,8 +2533,8 @@ sequence::unselect ()
 bool
 sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);                  /* push_undo(), no lock */
+    editlock locker(*this);
+    push_events_undo();                            /* push_undo(), no lock */
     bool result = m_events.move_selected_notes(delta_tick, delta_note);
     if (result)
         modify();
@@ -2179,8 +2545,8 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 bool
 sequence::move_selected_events (midipulse delta_tick)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);                  /* push_undo(), no lock */
+    editlock locker(*this);
+    push_events_undo();                            /* push_undo(), no lock */
     bool result = m_events.move_selected_events(delta_tick);
     if (result)
         modify();
@@ -2202,8 +2568,8 @@ sequence::move_selected_events (midipulse delta_tick)
 bool
 sequence::stretch_selected (midipulse delta_tick)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);           /* push_undo(), no lock  */
+    editlock locker(*this);
+    push_events_undo();                     /* push_undo(), no lock  */
     bool result = m_events.stretch_selected(delta_tick);
     if (result)
         modify();
@@ -2255,8 +2621,8 @@ sequence::stretch_selected (midipulse delta_tick)
 bool
 sequence::grow_selected (midipulse delta)
 {
-    automutex locker(m_mutex);                  /* lock it again, dude  */
-    m_events_undo.push(m_events);               /* push_undo(), no lock */
+    editlock locker(*this);                     /* lock it again, dude  */
+    push_events_undo();                         /* push_undo(), no lock */
 
     bool result = m_events.grow_selected(delta, snap());
     if (result)
@@ -2283,8 +2649,8 @@ sequence::grow_selected (midipulse delta)
 bool
 sequence::randomize_selected (midibyte status, int plus_minus)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock  */
+    editlock locker(*this);
+    push_events_undo();                         /* push_undo(), no lock  */
 
     bool result = m_events.randomize_selected(status, plus_minus);
     if (result)
@@ -2296,8 +2662,8 @@ sequence::randomize_selected (midibyte status, int plus_minus)
 bool
 sequence::randomize_selected_notes (int jitter, int range)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock  */
+    editlock locker(*this);
+    push_events_undo();                         /* push_undo(), no lock  */
 
     bool result = m_events.randomize_selected_notes(jitter, range);
     if (result)
@@ -2313,8 +2679,8 @@ sequence::randomize_selected_notes (int jitter, int range)
 bool
 sequence::jitter_notes (int jitter)
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);               /* push_undo(), no lock  */
+    editlock locker(*this);
+    push_events_undo();                         /* push_undo(), no lock  */
 
     bool result = m_events.jitter_notes(jitter);
     if (result)
@@ -2336,7 +2702,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte data[2];
     midibyte datitem;
     int dataindex = event::is_two_byte_msg(status) ? 1 : 0 ;
-    automutex locker(m_mutex);
+    editlock locker(*this);
     for (auto & e : m_events)
     {
         if (e.is_selected_status(status))
@@ -2379,7 +2745,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modded = false;
     for (auto & e : m_events)
     {
@@ -2427,7 +2793,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modded = false;
     for (auto & e : m_events)
     {
@@ -2452,7 +2818,7 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 bool
 sequence::repitch (const notemapper & nmap, bool all)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     push_undo();
     for (auto & e : m_events)
@@ -2503,7 +2869,7 @@ sequence::repitch (const notemapper & nmap, bool all)
 bool
 sequence::copy_selected ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     eventlist clipbd;
     bool result = m_events.copy_selected(clipbd);
     if (result)
@@ -2593,7 +2959,7 @@ sequence::cut_selected (bool copyevents)
 bool
 sequence::paste_selected (midipulse tick, int note)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     eventlist clipbd = sm_clipboard;            /* copy the clipboard   */
     push_undo();                                /* push undo, no lock   */
     bool result = m_events.paste_selected(clipbd, tick, note);
@@ -2616,7 +2982,7 @@ sequence::merge_events (const sequence & source)
     int bw = source.get_beat_width();
     int bpb = source.get_beats_per_bar();
     midipulse len = source.get_length();
-    automutex locker(m_mutex);
+    editlock locker(*this);
     set_beat_width(bw);
     set_beats_per_bar(bpb);
 
@@ -2694,7 +3060,7 @@ sequence::change_event_data_range
     int data_s, int data_f, bool finalize
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     bool haveselection = any_selected_events(status, cc);
     for (auto & er : m_events)
@@ -2780,7 +3146,7 @@ sequence::change_event_data_relative
     int newval, bool finalize
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     bool haveselection = any_selected_events(status, cc);
     for (auto & er : m_events)
@@ -2877,7 +3243,7 @@ sequence::change_event_data_lfo
     waveform w, midibyte status, midibyte cc, bool usemeasure
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modified = false;
     double dlength = double(get_length());
     bool noselection = ! any_selected_events(status, cc);
@@ -2887,7 +3253,7 @@ sequence::change_event_data_lfo
     if (usemeasure)
         dlength = double(measures_to_ticks());
 
-    m_events_undo.push(m_events);           /* experimental, seems to work  */
+    push_events_undo();                     /* experimental, seems to work  */
     for (auto & er : m_events)
     {
         bool match = false;
@@ -3006,7 +3372,7 @@ sequence::trunc_measures (double measures)
 bool
 sequence::fix_pattern (fixparameters & params)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     double newmeasures = params.fp_measures;
     double newscalefactor = params.fp_scale_factor;
     bool result = valid_scale_factor(newscalefactor) &&
@@ -3187,7 +3553,7 @@ sequence::add_painted_note
     bool ignore = false;
     if (repaint)                                    /* see banner above     */
     {
-        automutex locker(m_mutex);
+        editlock locker(*this);
         ignore = remove_duplicate_events(tick, note);
     }
     if (ignore)
@@ -3272,8 +3638,17 @@ sequence::push_add_note
     bool repaint, int velocity
 )
 {
-    m_events_undo.push(m_events);                   /* push_undo(), no lock */
-    return add_painted_note(tick, len, note, repaint, velocity);
+    editlock locker(*this);
+    push_events_undo();                             /* push_undo(), no lock */
+
+    undotracker tracker(*this);
+    touch_undo_range(tick, tick + len);
+
+    bool result = add_painted_note(tick, len, note, repaint, velocity);
+    if (! result)
+        m_undo_range_valid = false;                 /* might be unsorted    */
+
+    return result;
 }
 
 bool
@@ -3283,8 +3658,17 @@ sequence::push_add_chord
     int note, int velocity
 )
 {
-    m_events_undo.push(m_events);                   /* push_undo(), no lock */
-    return add_chord(chord, tick, len, note, velocity);
+    editlock locker(*this);
+    push_events_undo();                             /* push_undo(), no lock */
+
+    undotracker tracker(*this);
+    touch_undo_range(tick, tick + len);
+
+    bool result = add_chord(chord, tick, len, note, velocity);
+    if (! result)
+        m_undo_range_valid = false;                 /* might be unsorted    */
+
+    return result;
 }
 
 /**
@@ -3344,7 +3728,7 @@ sequence::add_chord
 bool
 sequence::add_tempo (midipulse tick, midibpm tempo, bool repaint)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool valid = tempo >= usr().midi_bpm_minimum() &&
         tempo <= usr().midi_bpm_maximum();
 
@@ -3386,11 +3770,11 @@ sequence::add_tempo (midipulse tick, midibpm tempo, bool repaint)
 bool
 sequence::add_time_signature (midipulse tick, int beats, int bw)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = beats > 0 && is_power_of_2(bw);
     if (result)
     {
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        push_events_undo();                         /* push_undo(), no lock */
         event e (tick, EVENT_MIDI_META);
         midibyte bt[4];
         bw = beat_log2(bw);                                 /* log2(bw)     */
@@ -3527,7 +3911,7 @@ sequence::detect_time_signature
 bool
 sequence::add_event (const event & er)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = m_events.append(er);  /* no-sort insertion of event       */
     if (result)
     {
@@ -3557,21 +3941,46 @@ sequence::add_event (const event & er)
 bool
 sequence::append_event (const event & er)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.append(er);     /* does *not* sort, too time-consuming  */
 }
 
 void
 sequence::sort_events ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_events.sort();
+    publish_events();
+}
+
+/**
+ *  Merges the events recorded by stream_event() since the last call into
+ *  the pattern, relinking only the notes from the first recorded event on,
+ *  and publishes the result.  Called by the input thread after each burst of
+ *  incoming events (see mastermidibase::merge_recorded_input()), so the
+ *  output thread never waits on it, and the cost of merging and publishing
+ *  is paid per burst rather than per incoming event.  Also called when
+ *  playback stops or pauses.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::merge_recorded ()
+{
+    if (m_record_pending)
+    {
+        editlock locker(*this);
+        m_record_pending = false;
+        if (m_events.merge_sorted(m_record_events))
+            modify(false);              /* do not call notify_change()      */
+    }
 }
 
 event
 sequence::find_event (const event & e, bool nextmatch)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     static event s_null_result{0, 0, 0};
     event::iterator evi = nextmatch ?
         m_events.find_next_match(e) : m_events.find_first_match(e) ;
@@ -3582,7 +3991,7 @@ sequence::find_event (const event & e, bool nextmatch)
 bool
 sequence::remove_duplicate_events (midipulse tick, int note)
 {
-    automutex locker(m_mutex);                  /* ca 2023-04-29    */
+    editlock locker(*this);                     /* ca 2023-04-29    */
     bool ignore = false;
     for (auto & er : m_events)
     {
@@ -3594,9 +4003,12 @@ sequence::remove_duplicate_events (midipulse tick, int note)
                 break;
             }
             er.mark();
+            touch_undo_range(er.timestamp(), er.timestamp());
             if (er.is_linked())
+            {
                 er.link()->mark();
-
+                touch_undo_range(er.link()->timestamp(), er.link()->timestamp());
+            }
             set_dirty();
         }
     }
@@ -3639,7 +4051,7 @@ sequence::add_event
     midibyte d0, midibyte d1, bool repaint
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = tick >= 0;
     if (result)
     {
@@ -3740,7 +4152,7 @@ sequence::check_loop_reset ()
 bool
 sequence::stream_event (event & ev)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = channels_match(ev);           /* set if channel matches   */
     if (result)
     {
@@ -3774,6 +4186,7 @@ sequence::stream_event (event & ev)
         else
             ev.mod_timestamp(get_length());             /* adjust tick      */
 
+        bool staged = false;
         if (recording())
         {
             if (perf()->is_pattern_playing())
@@ -3781,7 +4194,22 @@ sequence::stream_event (event & ev)
                 if (ev.is_note_on() && m_rec_vol > usr().preserve_velocity())
                     ev.note_velocity(m_rec_vol);        /* modify incoming  */
 
-                add_event(ev);                          /* locks and sorts  */
+                /*
+                 * Quantizing needs the new note in the list right away.
+                 * Otherwise, stage it; the input thread merges it once the
+                 * current burst of input is read.
+                 */
+
+                if (quantizing_or_tightening())
+                {
+                    add_event(ev);                      /* locks and sorts  */
+                }
+                else
+                {
+                    m_record_events.push_back(ev);
+                    m_record_pending = true;
+                    staged = true;
+                }
             }
             else
             {
@@ -3851,13 +4279,16 @@ sequence::stream_event (event & ev)
             }
         }
         if (m_thru)
+        {
+            automutex playlocker(m_play_mutex);     /* m_playing_notes      */
             put_event_on_bus(ev);
+        }
 
         /*
          * We don't need to link note events until a note-off comes in.
          */
 
-        if (ev.is_note_off())
+        if (ev.is_note_off() && ! staged)
             link_new();
 
         if (quantizing_or_tightening() && perf()->is_pattern_playing())
@@ -3897,6 +4328,21 @@ void
 sequence::set_dirty_mp ()
 {
     m_dirty_names = m_dirty_main = m_dirty_perf = true;
+    redraw_needed();
+}
+
+/**
+ *  Bumps the draw generation of this pattern, and the change generation of
+ *  the performer, so that both the pattern editors and the views of the
+ *  whole song (the grid and the song editor) see that something changed.
+ */
+
+void
+sequence::redraw_needed () const
+{
+    ++m_draw_generation;
+    if (not_nullptr(m_parent))
+        m_parent->redraw_needed();
 }
 
 /**
@@ -4004,7 +4450,7 @@ sequence::is_dirty_edit () const
 void
 sequence::play_note_on (int note)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     event e(0, EVENT_NOTE_ON, midibyte(note), midibyte(m_note_on_velocity));
     master_bus()->play_and_flush(m_true_bus, &e, midi_channel(e));
 }
@@ -4023,7 +4469,7 @@ sequence::play_note_on (int note)
 void
 sequence::play_note_off (int note)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     event e(0, EVENT_NOTE_OFF, midibyte(note), midibyte(m_note_on_velocity));
     master_bus()->play_and_flush(m_true_bus, &e, midi_channel(e));
 }
@@ -4036,12 +4482,13 @@ sequence::play_note_off (int note)
 bool
 sequence::clear_triggers ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     int count = m_triggers.count();
     bool result = count > 0;
     m_triggers.clear();
     if (result)
-        modify(false);                  /* issue #90 flag change w/o notify */
+        mark_trigger_modified();        /* issue #90 flag change w/o notify */
 
     return result;
 }
@@ -4049,7 +4496,8 @@ sequence::clear_triggers ()
 void
 sequence::print_triggers () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.print(m_name);
 }
 
@@ -4079,9 +4527,10 @@ sequence::add_trigger
     midibyte tpose, bool fixoffset
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.add(tick, len, offset, tpose, fixoffset);
-    modify(false);                      /* issue #90 flag change w/o notify */
+    mark_trigger_modified();            /* issue #90 flag change w/o notify */
     return true;
 }
 
@@ -4116,14 +4565,16 @@ sequence::intersect_triggers
     midipulse position, midipulse & start, midipulse & ender
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.intersect(position, start, ender);
 }
 
 bool
 sequence::intersect_triggers (midipulse position)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.intersect(position);
 }
 
@@ -4165,7 +4616,7 @@ sequence::intersect_notes
     midipulse & start, midipulse & ender, int & note
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     auto on = m_events.begin();
     auto off = m_events.begin();
     while (on != m_events.end())
@@ -4243,7 +4694,7 @@ sequence::intersect_events
     midibyte status, midipulse & start
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     midipulse poslength = posend - posstart;
     for (auto & eon : m_events)
     {
@@ -4284,10 +4735,9 @@ sequence::intersect_events
 bool
 sequence::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     m_triggers.grow_trigger(tickfrom, tickto, len);
-    modify(false);                      /* issue #90 flag change w/o notify */
-    set_dirty_mp();                     /* force redraw                     */
+    mark_trigger_modified();            /* issue #90 flag change w/o notify */
     return true;
 }
 
@@ -4298,17 +4748,17 @@ sequence::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 bool
 sequence::grow_trigger (midipulse tickfrom, midipulse tickto)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     m_triggers.grow_trigger(tickfrom, tickto, c_song_record_incr);
-    modify(false);                      /* issue #90 flag change w/o notify */
-    set_dirty_mp();                     /* force redraw                     */
+    mark_trigger_modified();            /* issue #90 flag change w/o notify */
     return true;
 }
 
 const trigger &
 sequence::find_trigger (midipulse tick) const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.find_trigger(tick);
 }
 
@@ -4325,10 +4775,11 @@ sequence::find_trigger (midipulse tick) const
 bool
 sequence::delete_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result = m_triggers.remove(tick);
     if (result)
-        modify(false);                  /* issue #90 flag change w/o notify */
+        mark_trigger_modified();        /* issue #90 flag change w/o notify */
 
     return result;
 }
@@ -4346,7 +4797,7 @@ sequence::delete_trigger (midipulse tick)
 void
 sequence::set_trigger_offset (midipulse trigger_offset)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     if (get_length() > 0)
     {
         m_trigger_offset = trigger_offset % get_length();
@@ -4372,10 +4823,11 @@ sequence::set_trigger_offset (midipulse trigger_offset)
 bool
 sequence::split_trigger (midipulse splittick, trigger::splitpoint splittype)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result =  m_triggers.split(splittick, splittype);
     if (result)
-        modify(false);                  /* issue #90 flag change w/o notify */
+        mark_trigger_modified();        /* issue #90 flag change w/o notify */
 
     return result;
 }
@@ -4395,7 +4847,8 @@ sequence::split_trigger (midipulse splittick, trigger::splitpoint splittype)
 void
 sequence::adjust_trigger_offsets_to_length (midipulse newlength)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.adjust_offsets_to_length(newlength);
 }
 
@@ -4415,7 +4868,8 @@ sequence::adjust_trigger_offsets_to_length (midipulse newlength)
 void
 sequence::copy_triggers (midipulse starttick, midipulse distance)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.copy(starttick, distance);
 }
 
@@ -4425,7 +4879,8 @@ sequence::selected_trigger
     midipulse droptick, midipulse & tick0, midipulse & tick1
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result = m_triggers.select(droptick);
     tick0 = m_triggers.get_selected_start();
     tick1 = m_triggers.get_selected_end();
@@ -4445,7 +4900,8 @@ sequence::selected_trigger
 midipulse
 sequence::selected_trigger_start ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.get_selected_start();
 }
 
@@ -4462,7 +4918,8 @@ sequence::selected_trigger_start ()
 midipulse
 sequence::selected_trigger_end ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.get_selected_end();
 }
 
@@ -4499,9 +4956,10 @@ sequence::move_triggers
     bool direction, bool single
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.move(starttick, distance, direction, single);
-    modify(false);                      /* issue #90 flag change w/o notify */
+    mark_trigger_modified();            /* issue #90 flag change w/o notify */
     return true;
 }
 
@@ -4542,10 +5000,11 @@ sequence::move_triggers
     midipulse tick, bool adjustoffset, triggers::grow which
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result =  m_triggers.move_selected(tick, adjustoffset, which);
     if (result)
-        modify(false);                  /* issue #90 flag change w/o notify */
+        mark_trigger_modified();        /* issue #90 flag change w/o notify */
 
     return result;
 }
@@ -4557,7 +5016,8 @@ sequence::move_triggers
 void
 sequence::offset_triggers (midipulse tick, triggers::grow editmode)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.offset_selected(tick, editmode);
 }
 
@@ -4573,31 +5033,34 @@ sequence::offset_triggers (midipulse tick, triggers::grow editmode)
 midipulse
 sequence::get_max_trigger () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.get_maximum();
 }
 
 midipulse
 sequence::get_max_timestamp () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return m_events.get_max_timestamp();
 }
 
 bool
 sequence::get_trigger_state (midipulse tick) const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.get_state(tick);
 }
 
 bool
 sequence::transpose_trigger (midipulse tick, int transposition)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result = m_triggers.transpose(tick, transposition);
     if (result)
-        modify(false);                          /* no easy way to undo this */
+        mark_trigger_modified();                /* no easy way to undo this */
 
     return result;
 }
@@ -4613,7 +5076,7 @@ sequence::transpose_trigger (midipulse tick, int transposition)
 triggers::container
 sequence::get_triggers () const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     return triggerlist();
 }
 
@@ -4633,7 +5096,8 @@ sequence::get_triggers () const
 bool
 sequence::select_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.select(tick);
 }
 
@@ -4647,7 +5111,8 @@ sequence::select_trigger (midipulse tick)
 bool
 sequence::unselect_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.unselect(tick);
 }
 
@@ -4661,7 +5126,8 @@ sequence::unselect_trigger (midipulse tick)
 bool
 sequence::unselect_triggers ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     return m_triggers.unselect();
 }
 
@@ -4675,10 +5141,11 @@ sequence::unselect_triggers ()
 bool
 sequence::delete_selected_triggers ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result = m_triggers.remove_selected();
     if (result)
-        modify(false);                  /* issue #90 flag change w/o notify */
+        mark_trigger_modified();        /* issue #90 flag change w/o notify */
 
     return result;
 }
@@ -4693,7 +5160,8 @@ sequence::delete_selected_triggers ()
 bool
 sequence::cut_selected_triggers ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     copy_selected_triggers();                   /* locks itself (recursive) */
     return m_triggers.remove_selected();
 }
@@ -4706,7 +5174,8 @@ sequence::cut_selected_triggers ()
 bool
 sequence::copy_selected_triggers ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     set_trigger_paste_tick(c_no_paste_trigger);
     m_triggers.copy_selected();
     return true;
@@ -4728,7 +5197,8 @@ sequence::copy_selected_triggers ()
 bool
 sequence::paste_trigger (midipulse paste_tick)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.paste(paste_tick);
     return true;
 }
@@ -4759,6 +5229,7 @@ sequence::stop (bool songmode)
     bool state = armed();
     off_playing_notes();
     zero_markers();                         /* sets the "last-tick" value   */
+    merge_recorded();                       /* flush staged recording       */
     if (recording())                        /* ca 2023-04-25                */
         verify_and_link();
 
@@ -4785,6 +5256,7 @@ sequence::pause (bool song_mode)
     if (! song_mode)
         set_armed(state);
 
+    merge_recorded();                       /* flush staged recording       */
     if (recording())                        /* ca 2023-04-25                */
         verify_and_link();
 }
@@ -4798,7 +5270,8 @@ sequence::pause (bool song_mode)
 void
 sequence::reset_draw_trigger_marker ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     m_triggers.reset_draw_trigger_marker();
 }
 
@@ -4830,7 +5303,7 @@ sequence::reset_draw_trigger_marker ()
 bool
 sequence::minmax_notes (int & lowest, int & highest) // const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     int low = int(max_midi_value());
     int high = -1;
@@ -4896,7 +5369,7 @@ sequence::get_next_note
     event::buffer::const_iterator & evi
 ) const
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     while (evi != m_events.cend())
     {
         if (m_events.action_in_progress())      /* atomic boolean check     */
@@ -4977,6 +5450,193 @@ sequence::get_note_info
     return draw::none;
 }
 
+/**
+ *  Creates an empty, invalid note index.  The first refresh() fills it.
+ */
+
+sequence::noteindex::noteindex () :
+    nx_notes        (),
+    nx_kinds        (),
+    nx_reach        (),
+    nx_extras       (),
+    nx_generation   (0),
+    nx_valid        (false),
+    nx_sorted       (true)
+{
+    // no code
+}
+
+/**
+ *  Rebuilds the index if the draw generation of the sequence has changed
+ *  since the last build.  The whole event list is copied under one lock,
+ *  instead of one lock per note as with get_next_note().
+ *
+ *  Besides the note information, we keep, for each entry, the running
+ *  maximum of the "reach" of the entries so far.  The reach of a linked,
+ *  unwrapped note is its note-off time; the reach of an unlinked note-on or
+ *  note-off is its own time stamp.  Wrapped notes, which also extend from
+ *  the start of the pattern to their note-off, and tempo events, which are
+ *  always drawn, are listed separately and do not add to the reach.  If an
+ *  action is in progress, the index is left invalid, and the caller should
+ *  try again later.
+ *
+ * \param s
+ *      The sequence to index.
+ *
+ * \return
+ *      Returns true if the index was rebuilt (or invalidated), meaning that
+ *      anything drawn from the previous contents is out-of-date.
+ */
+
+bool
+sequence::noteindex::refresh (const sequence & s)
+{
+    unsigned generation = s.draw_generation();
+    if (nx_valid && generation == nx_generation)
+        return false;
+
+    automutex locker(s.m_mutex);
+    nx_notes.clear();
+    nx_kinds.clear();
+    nx_reach.clear();
+    nx_extras.clear();
+    nx_generation = generation;
+    nx_sorted = true;
+    nx_valid = ! s.m_events.action_in_progress();
+    if (nx_valid)
+    {
+        midipulse reach = 0;
+        midipulse last = 0;
+        for (auto evi = s.m_events.cbegin(); evi != s.m_events.cend(); ++evi)
+        {
+            note_info ni;
+            draw dt = s.get_note_info(ni, evi);
+            if (dt == draw::none)
+                continue;
+
+            if (ni.start() < last)
+                nx_sorted = false;                  /* e.g. while recording */
+
+            last = ni.start();
+            if (extra(dt, ni))
+                nx_extras.push_back(count());
+            else if (dt == draw::linked)
+                reach = std::max(reach, ni.finish());
+            else
+                reach = std::max(reach, ni.start());
+
+            nx_notes.push_back(ni);
+            nx_kinds.push_back(dt);
+            nx_reach.push_back(reach);
+        }
+    }
+    return true;
+}
+
+/**
+ *  Indicates an entry that is kept in the extras list: a tempo event or a
+ *  linked note that wraps around the end of the pattern.
+ */
+
+bool
+sequence::noteindex::extra (draw dt, const note_info & ni)
+{
+    return dt == draw::tempo ||
+        (dt == draw::linked && ni.finish() < ni.start());
+}
+
+/**
+ *  Indicates if an entry intersects the given range of ticks.  A linked note
+ *  covers its start to its finish; a wrapped note covers its start to the
+ *  end of the pattern, plus the start of the pattern to its finish; an
+ *  unlinked event is a point.  The caller widens the range to allow for the
+ *  drawn width of points.  Tempo events are always drawn.
+ */
+
+bool
+sequence::noteindex::in_range (int i, midipulse tick_s, midipulse tick_f) const
+{
+    const note_info & ni = nx_notes[i];
+    draw dt = nx_kinds[i];
+    if (dt == draw::tempo)
+        return true;
+    else if (dt == draw::linked)
+    {
+        if (ni.finish() >= ni.start())
+            return ni.start() <= tick_f && ni.finish() >= tick_s;
+        else
+            return ni.start() <= tick_f || ni.finish() >= tick_s;
+    }
+    else
+        return ni.start() >= tick_s && ni.start() <= tick_f;
+}
+
+/**
+ *  Gets the indices, in event order, of the entries that need drawing in
+ *  the given range of ticks.  A binary search on the start times gives the
+ *  last candidate, and one on the running maximum of the reaches gives the
+ *  first candidate; the separately-listed wrapped notes and tempo events
+ *  are then merged in.  If the events were not in time order, every entry
+ *  is checked.
+ *
+ * \param tick_s
+ *      The start of the range to draw.
+ *
+ * \param tick_f
+ *      The end of the range to draw, inclusive.
+ *
+ * \param [out] indices
+ *      Provides the destination for the indices.  It is cleared first.
+ */
+
+void
+sequence::noteindex::visible
+(
+    midipulse tick_s, midipulse tick_f, std::vector<int> & indices
+) const
+{
+    indices.clear();
+    if (! nx_valid)
+        return;
+
+    int lo = 0;
+    int hi = count();
+    if (nx_sorted)
+    {
+        auto after = std::upper_bound
+        (
+            nx_notes.begin(), nx_notes.end(), tick_f,
+            [] (midipulse t, const note_info & ni)
+            {
+                return t < ni.start();
+            }
+        );
+        hi = int(after - nx_notes.begin());
+        lo = int
+        (
+            std::lower_bound(nx_reach.begin(), nx_reach.end(), tick_s) -
+                nx_reach.begin()
+        );
+    }
+    for (int i = lo; i < hi; ++i)
+    {
+        if (! extra(nx_kinds[i], nx_notes[i]) && in_range(i, tick_s, tick_f))
+            indices.push_back(i);
+    }
+
+    bool merged = false;
+    for (int i : nx_extras)
+    {
+        if (in_range(i, tick_s, tick_f))
+        {
+            indices.push_back(i);
+            merged = true;
+        }
+    }
+    if (merged)
+        std::sort(indices.begin(), indices.end());
+}
+
 /**
  *  Checks for non-terminated notes.
  *
@@ -5056,7 +5716,7 @@ sequence::get_next_event
     event::buffer::const_iterator & evi
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = evi != m_events.end();
     if (result)
     {
@@ -5113,7 +5773,7 @@ sequence::get_next_event_match
     event::buffer::const_iterator & evi
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool ismeta = event::is_meta_msg(status);
     while (evi != m_events.end())
     {
@@ -5186,7 +5846,7 @@ sequence::get_next_meta_match
     midipulse range
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (range != c_null_midipulse)
         range += start;
 
@@ -5236,11 +5896,12 @@ sequence::next_trigger (trigger & trig)
 void
 sequence::set_last_tick (midipulse tick)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     if (is_null_midipulse(tick))
         tick = m_length;
 
     m_last_tick = tick;
+    m_play_next = c_null_midipulse;             /* force a cursor re-seat   */
 }
 
 /**
@@ -5296,7 +5957,7 @@ sequence::get_last_tick () const
 bool
 sequence::set_midi_bus (bussbyte nominalbus, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = nominalbus != m_nominal_bus && is_good_buss(nominalbus);
     if (result)
     {
@@ -5312,7 +5973,7 @@ sequence::set_midi_bus (bussbyte nominalbus, bool user_change)
             m_true_bus = null_buss();       /* provides an invalid value    */
 
         if (user_change)
-            modify();                       /* no easy way to undo this     */
+            mark_modified();                /* no easy way to undo this     */
 
         notify_change(user_change);         /* more reliable than set dirty */
         set_dirty();                        /* this is for display updating */
@@ -5393,7 +6054,8 @@ sequence::set_midi_bus (bussbyte nominalbus, bool user_change)
 bool
 sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
+    automutex playlocker(m_play_mutex);
     bool result = len != m_length;
     if (result)
     {
@@ -5502,7 +6164,7 @@ sequence::apply_length (int bpb, int ppq, int bw, int measures)
 bool
 sequence::extend_length ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     midipulse len = m_events.get_max_timestamp();
     bool result = len > get_length();
     if (len > get_length())
@@ -5517,7 +6179,7 @@ sequence::extend_length ()
 bool
 sequence::double_length ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     int m = get_measures();
     bool result = m > 0;
     if (result)
@@ -5582,7 +6244,7 @@ sequence::notify_trigger ()
 bool
 sequence::set_armed (bool p)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     bool result = p != armed();
     if (result)
     {
@@ -5641,7 +6303,7 @@ sequence::set_armed (bool p)
 bool
 sequence::set_recording (bool recordon, bool toggle)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (toggle)
         recordon = ! m_recording;
 
@@ -5655,8 +6317,10 @@ sequence::set_recording (bool recordon, bool toggle)
         if (recordon)
             m_recording = true;
         else
+        {
             m_recording = m_quantized_recording = m_tightened_recording = false;
-
+            merge_recorded();                   /* flush staged recording   */
+        }
         set_dirty();
         notify_trigger();                                   /* tricky!  */
     }
@@ -5676,7 +6340,7 @@ sequence::set_recording (bool recordon, bool toggle)
 bool
 sequence::set_quantized_recording (bool qr, bool toggle)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (toggle)
         qr = ! m_quantized_recording;
 
@@ -5696,7 +6360,7 @@ sequence::set_quantized_recording (bool qr, bool toggle)
 bool
 sequence::set_tightened_recording (bool tr, bool toggle)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (toggle)
         tr = ! m_tightened_recording;
 
@@ -5720,7 +6384,7 @@ sequence::set_tightened_recording (bool tr, bool toggle)
 bool
 sequence::set_overwrite_recording (bool ovwr, bool toggle)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (toggle)
         ovwr = ! m_overwrite_recording;
 
@@ -5750,7 +6414,7 @@ sequence::set_overwrite_recording (bool ovwr, bool toggle)
 bool
 sequence::set_thru (bool thruon, bool toggle)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (toggle)
         thruon = ! m_thru;
 
@@ -5776,14 +6440,14 @@ sequence::set_thru (bool thruon, bool toggle)
 void
 sequence::snap (int st)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_snap_tick = st;
 }
 
 void
 sequence::loop_reset (bool reset)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     m_loop_reset = reset;
 }
 
@@ -5877,7 +6541,7 @@ sequence::title () const
 bool
 sequence::set_midi_channel (midibyte ch, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = ch != m_midi_channel;
     if (result)
         result = is_valid_channel(ch);      /* 0 to 15 or null_channel()    */
@@ -5888,7 +6552,7 @@ sequence::set_midi_channel (midibyte ch, bool user_change)
         m_free_channel = is_null_channel(ch);
         m_midi_channel = ch;                /* if (! m_free_channel)        */
         if (user_change)
-            modify();                       /* no easy way to undo this     */
+            mark_modified();                /* no easy way to undo this     */
 
         set_dirty();                        /* this is for display updating */
     }
@@ -5923,6 +6587,7 @@ sequence::set_channels (int channel)
         {
             m_midi_channel = c_midichannel_null;
             m_free_channel = true;
+            publish_events();
         }
     }
     return result;
@@ -5971,19 +6636,70 @@ sequence::to_string () const
  * \param ev
  *      The event to put on the buss.
  *
+ * \param tick
+ *      The playback tick at which the event is due.  The play loops pass it
+ *      so that the JACK lookahead can place the event at its exact frame.
+ *      If null (the default), the performer's current tick is used.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (const event & ev)
+sequence::put_event_on_bus (const event & ev, midipulse tick)
+{
+    event evout;
+    if (is_null_midipulse(tick))
+        tick = m_parent->get_tick();
+
+    evout.prep_for_send(tick, ev);                          /* issue #100   */
+    send_event(evout, midi_channel(ev));
+}
+
+/**
+ *  The playback version of put_event_on_bus(), which sends a record of the
+ *  playback snapshot.
+ *
+ * \param evs
+ *      The snapshot holding the record, and its SysEx or Meta payload.
+ *
+ * \param r
+ *      The record to send.
+ *
+ * \param tick
+ *      The playback tick at which the event is due.
+ *
+ * \param transpose
+ *      The transposition of notes (including Aftertouch), if any.
+ */
+
+void
+sequence::put_event_on_bus
+(
+    const eventpack & evs, const eventpack::record & r,
+    midipulse tick, int transpose
+)
+{
+    event evout;
+    evs.unpack(r, tick, evout, transpose);
+    send_event(evout, m_free_channel ? r.channel() : m_midi_channel);
+}
+
+/**
+ *  Keeps count of the notes playing, so that off_playing_notes() can turn
+ *  them off, and sends the event unless it is a Note Off for a note that is
+ *  not playing.
+ */
+
+void
+sequence::send_event (event & evout, midibyte channel)
 {
-    midibyte note = ev.get_note();
+    midibyte note = evout.get_note();
     bool skip = false;
-    if (ev.is_note_on())
+    if (evout.is_note_on())
     {
         ++m_playing_notes[note];
     }
-    else if (ev.is_note_off())
+    else if (evout.is_note_off())
     {
         if (m_playing_notes[note] == 0)
             skip = true;
@@ -5991,11 +6707,7 @@ sequence::put_event_on_bus (const event & ev)
             --m_playing_notes[note];
     }
     if (! skip)
-    {
-        event evout;
-        evout.prep_for_send(m_parent->get_tick(), ev);      /* issue #100   */
-        master_bus()->play_and_flush(m_true_bus, &evout, midi_channel(ev));
-    }
+        master_bus()->play_and_flush(m_true_bus, &evout, channel);
 }
 
 /**
@@ -6008,9 +6720,10 @@ sequence::put_event_on_bus (const event & ev)
 void
 sequence::off_playing_notes ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     int channel = free_channel() ? 0 : seq_midi_channel() ;
-    event e(0, EVENT_NOTE_OFF, channel, 0, 0);
+    midipulse tick = not_nullptr(perf()) ? perf()->get_tick() : 0 ;
+    event e(tick, EVENT_NOTE_OFF, channel, 0, 0);       /* JACK lookahead   */
     for (int x = 0; x < c_notes_count; ++x)
     {
         while (m_playing_notes[x] > 0)
@@ -6052,10 +6765,10 @@ sequence::off_playing_notes ()
 bool
 sequence::transpose_notes (int steps, int scale, int key)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     const int * transposetable;
     bool result = false;
-    m_events_undo.push(m_events);                   /* push_undo(), no lock */
+    push_events_undo();                             /* push_undo(), no lock */
     if (steps < 0)
     {
         transposetable = scales_down(scale, key);   /* 0 = chromatic scale  */
@@ -6100,10 +6813,10 @@ sequence::transpose_notes (int steps, int scale, int key)
 void
 sequence::shift_notes (midipulse ticks)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (get_length() > 0)
     {
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        push_events_undo();                         /* push_undo(), no lock */
         for (auto & er : m_events)
         {
             if (er.is_selected_note())              /* shiftable event?     */
@@ -6139,8 +6852,8 @@ sequence::apply_song_transpose ()
     int transpose = transposable() ? perf()->get_transpose() : 0 ;
     if (transpose != 0)
     {
-        automutex locker(m_mutex);
-        m_events_undo.push(m_events);               /* push_undo(), no lock */
+        editlock locker(*this);
+        push_events_undo();                         /* push_undo(), no lock */
         for (auto & er : m_events)
         {
             if (er.is_note())                       /* also aftertouch      */
@@ -6168,11 +6881,11 @@ sequence::apply_song_transpose ()
 void
 sequence::set_transposable (bool flag, bool user_change)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool modded = flag != m_transposable && user_change;
     m_transposable = flag;
     if (modded)
-        modify();
+        mark_modified();
 }
 
 /**
@@ -6214,7 +6927,7 @@ sequence::quantize_events
     midibyte status, midibyte cc, int divide, bool fixlink
 )
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     if (divide == 0)
         return false;
 
@@ -6232,7 +6945,7 @@ sequence::quantize_events
 bool
 sequence::change_ppqn (int p)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = p != m_ppqn;
     if (result)
         result = ppqn_in_range(p);
@@ -6242,10 +6955,12 @@ sequence::change_ppqn (int p)
         result = m_events.rescale(p, m_ppqn);           /* new & old PPQNs  */
         if (result)
         {
+            automutex playlocker(m_play_mutex);
             m_length = rescale_tick(m_length, p, m_ppqn);
             m_ppqn = p;
             result = apply_length(0, 0, 0);             /* use new PPQN     */
             m_triggers.change_ppqn(p);
+            publish_events();
         }
     }
     return result;
@@ -6284,8 +6999,8 @@ sequence::push_quantize
     midibyte status, midibyte cc, int divide, bool linked
 )
 {
-    automutex locker(m_mutex);
-    m_events_undo.push(m_events);
+    editlock locker(*this);
+    push_events_undo();
     return quantize_events(status, cc, divide, linked);     /* sets dirty   */
 }
 
@@ -6340,7 +7055,7 @@ sequence::show_events () const
 bool
 sequence::copy_events (const eventlist & newevents)
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     bool result = false;
     m_events.clear();
     m_events = newevents;
@@ -6525,7 +7240,7 @@ sequence::handle_size (midipulse start, midipulse finish)
 bool
 sequence::toggle_one_shot ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     set_dirty_mp();
     m_one_shot = ! m_one_shot;
     m_one_shot_tick = m_last_tick - mod_last_tick() + get_length();
@@ -6543,7 +7258,7 @@ sequence::toggle_one_shot ()
 void
 sequence::off_one_shot ()
 {
-    automutex locker(m_mutex);
+    editlock locker(*this);
     set_dirty_mp();
     m_one_shot = false;
     off_from_snap(true);
@@ -6670,18 +7385,44 @@ sequence::song_recording_stop (midipulse tick)
 void
 sequence::resume_note_ons (midipulse tick)
 {
-    automutex locker(m_mutex);                          /* better here?     */
-    if (get_length() > 0)
+    automutex locker(m_play_mutex);
+    midipulse length = get_length();
+    if (length > 0)
     {
-        for (auto & ei : m_events)
+        /*
+         * The links in the snapshot cannot be followed, so find the notes
+         * sounding at "rem" in one pass.  A linked Note On before "rem" is
+         * pending until a matching Note Off at or before "rem" is seen. A
+         * note that wraps around has its Note Off earlier in the list, so it
+         * is still pending at the end of the pass.
+         */
+
+        const eventpack::record *
+            pending[c_midichannel_max][c_notes_count] = { };
+        snapshot evs = play_events();
+        midipulse rem = tick % length;
+        for (const auto & ei : *evs)
+        {
+            midipulse ts = ei.timestamp();
+            if (ts > rem)
+                break;
+
+            int ch = int(event::mask_channel(ei.get_status()));
+            int note = int(ei.d0());
+            if (ei.is_note_on_linked())
+            {
+                if (ts < rem)
+                    pending[ch][note] = &ei;
+            }
+            else if (ei.is_note_off())
+                pending[ch][note] = nullptr;
+        }
+        for (const auto & chan : pending)
         {
-            if (ei.is_note_on_linked())                 /* note on linked   */
+            for (const eventpack::record * ep : chan)
             {
-                midipulse on = ei.timestamp();          /* see banner notes */
-                midipulse off = ei.link()->timestamp();
-                midipulse rem = tick % get_length();
-                if (on < rem && (off > rem || on > off))
-                    put_event_on_bus(ei);
+                if (not_nullptr(ep))
+                    put_event_on_bus(*evs, *ep, m_parent->get_tick());
             }
         }
     }
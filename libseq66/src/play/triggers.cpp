@@ -158,13 +158,15 @@ triggers::triggers (sequence & parent) :
     m_triggers                  (),
     m_number_selected           (0),
     m_clipboard                 (),
-    m_undo_stack                (),
-    m_redo_stack                (),
+    m_undo_journal              (),
     m_draw_iterator             (),
     m_trigger_copied            (false),
     m_paste_tick                (c_no_paste_trigger),   // stazed
     m_ppqn                      (0),
-    m_length                    (0)
+    m_length                    (0),
+    m_end_index                 (),
+    m_index_dirty               (true),
+    m_index_usable              (false)
 {
     // Empty body
 }
@@ -192,12 +194,12 @@ triggers::operator = (const triggers & rhs)
 
         m_triggers = rhs.m_triggers;
         m_clipboard = rhs.m_clipboard;
-        m_undo_stack = rhs.m_undo_stack;
-        m_redo_stack = rhs.m_redo_stack;
+        m_undo_journal = rhs.m_undo_journal;
         m_draw_iterator = rhs.m_draw_iterator;
         m_trigger_copied = rhs.m_trigger_copied;
         m_ppqn = rhs.m_ppqn;
         m_length = rhs.m_length;
+        modified();
     }
     return *this;
 }
@@ -211,6 +213,7 @@ triggers::rescale (int newppqn, int oldppqn)
         for (auto & t : m_triggers)
             t.rescale(newppqn, oldppqn);
 
+        modified();
         set_length(rescale_tick(m_length, newppqn, oldppqn));
     }
     return result;
@@ -258,32 +261,33 @@ triggers::change_ppqn (int p)
 }
 
 /**
- *  Pushes the list-trigger into the trigger undo-list, then flags each
- *  item in the undo-list as unselected.
+ *  Pushes the list-trigger into the trigger undo-list.  Only the triggers
+ *  changed since the last undo action are stored.
  */
 
 void
 triggers::push_undo ()
 {
-    m_undo_stack.push(m_triggers);
-    for (auto & t : m_undo_stack.top())
-        unselect(t, false);             /* do not count this unselection    */
+    m_undo_journal.limit(usr().undo_limit_bytes());
+    m_undo_journal.push(m_triggers);
 }
 
 /**
  *  If the trigger undo-list has any items, the list-trigger is pushed
  *  into the redo list, the top of the undo-list is coped into the
- *  list-trigger, and then pops from the undo-list.
+ *  list-trigger, and then pops from the undo-list.  As before, the restored
+ *  triggers are unselected.
  */
 
 void
 triggers::pop_undo ()
 {
-    if (m_undo_stack.size() > 0)
+    if (m_undo_journal.undo(m_triggers))
     {
-        m_redo_stack.push(m_triggers);
-        m_triggers = m_undo_stack.top();
-        m_undo_stack.pop();
+        for (auto & t : m_triggers)
+            unselect(t, false);         /* do not count this unselection    */
+
+        modified();
     }
 }
 
@@ -296,12 +300,8 @@ triggers::pop_undo ()
 void
 triggers::pop_redo ()
 {
-    if (m_redo_stack.size() > 0)
-    {
-        m_undo_stack.push(m_triggers);
-        m_triggers = m_redo_stack.top();
-        m_redo_stack.pop();
-    }
+    if (m_undo_journal.redo(m_triggers))
+        modified();
 }
 
 /**
@@ -316,6 +316,13 @@ triggers::pop_redo ()
  *  first start or end trigger that is past the end tick cause the search to
  *  end.
  *
+ *  Only the triggers near the tick range matter.  A trigger ending before
+ *  the range can be at no transition, and its state settings are overwritten
+ *  by the next trigger, so the loop starts one trigger before the first one
+ *  reaching the range, as found via the index.  The results are the same as
+ *  a walk from the beginning of the list, but playback of a long song no
+ *  longer costs more at the end than at the beginning.
+ *
  *                  -------------------------------------
  *      tick_start |                                     | tick_end
  *                  -------------------------------------
@@ -374,13 +381,18 @@ triggers::play
     midipulse trigger_offset = 0;
     midipulse trigger_tick = 0;
     int tp = 0;
+    int first = first_reaching(std::min(start_tick, end_tick));
+    if (first > 0)
+        --first;                            /* it sets the state for us     */
+
     transpose = 0;
-    for (auto & t : m_triggers)
+    for (auto ti = m_triggers.begin() + first; ti != m_triggers.end(); ++ti)
     {
         /*
          *  See the song_playback_block() function note in the banner.
          */
 
+        trigger & t = *ti;
         if (t.at_trigger_transition(start_tick, end_tick))
             m_parent.song_playback_block(false);
 
@@ -570,27 +582,21 @@ triggers::add
 bool
 triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 {
-    for (auto & ti : m_triggers)
+    int index = first_bracketing(position);
+    bool result = index >= 0;
+    if (result)
     {
-        if (ti.tick_start() <= position && position <= ti.tick_end())
-        {
-            start = ti.tick_start();        /* return by reference */
-            ender = ti.tick_end();          /* ditto               */
-            return true;
-        }
+        const trigger & t = m_triggers[index];
+        start = t.tick_start();             /* return by reference */
+        ender = t.tick_end();               /* ditto               */
     }
-    return false;
+    return result;
 }
 
 bool
 triggers::intersect (midipulse position)
 {
-    for (auto & ti : m_triggers)
-    {
-        if (ti.tick_start() <= position && position <= ti.tick_end())
-            return true;
-    }
-    return false;
+    return first_bracketing(position) >= 0;
 }
 
 /**
@@ -616,29 +622,26 @@ triggers::intersect (midipulse position)
 bool
 triggers::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 {
-    bool result = false;
-    for (auto & t : m_triggers)
+    int index = first_bracketing(tickfrom);
+    bool result = index >= 0;
+    if (result)
     {
+        const trigger & t = m_triggers[index];
         midipulse start = t.tick_start();
         midipulse ender = t.tick_end();
-        if (start <= tickfrom && tickfrom <= ender)
-        {
-            midipulse calcend = tickto + len - 1;
-            if (tickto < start)
-                start = tickto;
+        midipulse calcend = tickto + len - 1;
+        if (tickto < start)
+            start = tickto;
 
-            if (calcend > ender)
-            {
+        if (calcend > ender)
+        {
 #if defined SEQ66_PLATFORM_DEBUG_TMI
-                printf("Growing trigger from %ld to %ld (%ld), length %ld\n",
-                    long(tickfrom), long(tickto), long(calcend), long(len));
+            printf("Growing trigger from %ld to %ld (%ld), length %ld\n",
+                long(tickfrom), long(tickto), long(calcend), long(len));
 #endif
-                ender = calcend;
-            }
-            add(start, ender - start + 1, t.offset());
-            result = true;
-            break;
+            ender = calcend;
         }
+        add(start, ender - start + 1, t.offset());
     }
     return result;
 }
@@ -654,16 +657,14 @@ triggers::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 bool
 triggers::remove (midipulse tick)
 {
-    bool result = false;
-    for (auto i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    int index = first_bracketing(tick);
+    bool result = index >= 0;
+    if (result)
     {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-        {
-            unselect(*i);                       /* adjust selection count   */
-            m_triggers.erase(i);
-            result = true;
-            break;
-        }
+        auto i = m_triggers.begin() + index;
+        unselect(*i);                           /* adjust selection count   */
+        m_triggers.erase(i);
+        modified();
     }
     return result;
 }
@@ -672,6 +673,116 @@ void
 triggers::sort ()
 {
     std::sort(m_triggers.begin(), m_triggers.end());
+    modified();
+}
+
+/**
+ *  Rebuilds the running maximum of trigger ends, if the triggers have been
+ *  modified since the last rebuild.  Also notes if the list is in start
+ *  order, which the lookups require.
+ */
+
+void
+triggers::reindex () const
+{
+    if (m_index_dirty)
+    {
+        midipulse maxend = 0;
+        midipulse laststart = 0;
+        m_index_usable = true;
+        m_end_index.clear();
+        m_end_index.reserve(m_triggers.size());
+        for (const auto & t : m_triggers)
+        {
+            if (m_end_index.empty())
+            {
+                maxend = t.tick_end();
+            }
+            else
+            {
+                if (t.tick_start() < laststart)
+                    m_index_usable = false;
+
+                if (t.tick_end() > maxend)
+                    maxend = t.tick_end();
+            }
+            laststart = t.tick_start();
+            m_end_index.push_back(maxend);
+        }
+        m_index_dirty = false;
+    }
+}
+
+/**
+ *  Finds the first trigger whose end is at or after the given tick.  No
+ *  earlier trigger can contain or follow the tick.
+ *
+ * \param tick
+ *      Provides the tick of interest.
+ *
+ * \return
+ *      Returns the index of that trigger, or count() if there is none.  If
+ *      the index cannot be used, 0 is returned, so that callers scan the
+ *      whole list.
+ */
+
+int
+triggers::first_reaching (midipulse tick) const
+{
+    reindex();
+    if (m_index_usable)
+    {
+        auto i = std::lower_bound(m_end_index.begin(), m_end_index.end(), tick);
+        return int(i - m_end_index.begin());
+    }
+    return 0;
+}
+
+/**
+ *  Finds the first trigger that brackets the given tick, the same trigger
+ *  the old linear scans found.  The candidates are the triggers starting at
+ *  or before the tick; the first of them ending at or after the tick is the
+ *  one.
+ *
+ * \param tick
+ *      Provides the tick of interest.
+ *
+ * \return
+ *      Returns the index of the trigger, or -1 if no trigger brackets the
+ *      tick.
+ */
+
+int
+triggers::first_bracketing (midipulse tick) const
+{
+    reindex();
+    if (m_index_usable)
+    {
+        auto ub = std::upper_bound
+        (
+            m_triggers.begin(), m_triggers.end(), tick,
+            [] (midipulse t, const trigger & rhs)
+            {
+                return t < rhs.tick_start();
+            }
+        );
+        auto last = m_end_index.begin() + (ub - m_triggers.begin());
+        auto i = std::lower_bound(m_end_index.begin(), last, tick);
+        if (i != last)
+            return int(i - m_end_index.begin());
+    }
+    else
+    {
+        int index = 0;
+        for (const auto & t : m_triggers)
+        {
+            if (t.tick_start() <= tick && tick <= t.tick_end())
+                return index;
+
+            ++index;
+        }
+    }
+    return (-1);
 }
 
 /**
@@ -697,6 +808,7 @@ triggers::split (trigger & trig, midipulse splittick)
     midipulse len = new_tick_end - new_tick_start;
     bool result = len > 1;
     trig.tick_end(splittick - 1);
+    modified();
     if (result)
         add(new_tick_start, len + 1, trig.offset());
 
@@ -718,20 +830,18 @@ bool
 triggers::split (midipulse splittick, trigger::splitpoint splittype)
 {
     bool result = false;
-    for (auto & t : m_triggers)
+    int index = first_bracketing(splittick);
+    if (index >= 0)
     {
-        if (t.tick_start() <= splittick && splittick <= t.tick_end())
+        trigger & t = m_triggers[index];
+        midipulse tick = splittick;                 /* snap or exact    */
+        midipulse offset = 0;
+        if (splittype == trigger::splitpoint::middle)
         {
-            midipulse tick = splittick;             /* snap or exact    */
-            midipulse offset = 0;
-            if (splittype == trigger::splitpoint::middle)
-            {
-                tick = (t.tick_end() - t.tick_start() + 1) / 2;
-                offset = t.tick_start();
-            }
-            result = split(t, tick + offset);
-            break;
+            tick = (t.tick_end() - t.tick_start() + 1) / 2;
+            offset = t.tick_start();
         }
+        result = split(t, tick + offset);
     }
     return result;
 }
@@ -826,28 +936,15 @@ const trigger &
 triggers::find_trigger (midipulse tick) const
 {
     static trigger s_dummy;
-    for (auto i = m_triggers.begin(); i != m_triggers.end(); ++i)
-    {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
-            return *i;
-    }
-    return s_dummy;
+    int index = first_bracketing(tick);
+    return index >= 0 ? m_triggers[index] : s_dummy ;
 }
 
 const trigger &
 triggers::find_trigger_by_index (int index) const
 {
     static trigger s_dummy;
-    if (count() > index)
-    {
-        int counter = 0;
-        for (auto i = m_triggers.begin(); i != m_triggers.end(); ++i)
-        {
-            if (counter++ == index)
-                return *i;
-        }
-    }
-    return s_dummy;
+    return index >= 0 && index < count() ? m_triggers[index] : s_dummy ;
 }
 
 /**
@@ -892,6 +989,7 @@ triggers::move
     if (result)
     {
         int counter = 0;
+        modified();
         for (auto & t : m_triggers)                         /* ++counter    */
         {
             if (t.tick_start() >= starttick)
@@ -966,6 +1064,7 @@ triggers::move_split
 )
 {
     midipulse endtick = starttick + distance;
+    modified();
     for (auto i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->tick_start() < starttick && starttick < i->tick_end())
@@ -1084,6 +1183,7 @@ triggers::move_selected (midipulse tick, bool fixoffset, grow which)
     midipulse mintick = 0;
     midipulse maxtick = 0x7ffffff;                          /* 0x7fffffff ? */
     auto s = m_triggers.begin();
+    modified();
     for (auto i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->selected())
@@ -1151,6 +1251,7 @@ triggers::move_selected (midipulse tick, bool fixoffset, grow which)
 void
 triggers::offset_selected (midipulse tick, grow editmode)
 {
+    modified();
     for (auto & t : m_triggers)
     {
         if (t.selected())
@@ -1209,32 +1310,20 @@ triggers::get_maximum () const
 bool
 triggers::get_state (midipulse tick) const
 {
-    bool result = false;
-    for (const auto & t : m_triggers)
-    {
-        if (t.tick_start() <= tick && tick <= t.tick_end())
-        {
-            result = true;
-            break;
-        }
-    }
-    return result;
+    return first_bracketing(tick) >= 0;
 }
 
 bool
 triggers::transpose (midipulse tick, int transposition)
 {
     bool result = false;
-    for (auto & t : m_triggers)
+    int index = first_bracketing(tick);
+    if (index >= 0)
     {
-        if (t.tick_start() <= tick && tick <= t.tick_end())
-        {
-            result = transposition != t.transpose();
-            if (result)
-                t.transpose(transposition);
-
-            break;
-        }
+        trigger & t = m_triggers[index];
+        result = transposition != t.transpose();
+        if (result)
+            t.transpose(transposition);
     }
     return result;
 }
@@ -1255,12 +1344,20 @@ bool
 triggers::select (midipulse tick)
 {
     bool result = false;
-    for (auto & t : m_triggers)
+    int index = first_bracketing(tick);
+    if (index >= 0)
     {
-        if (t.tick_start() <= tick && tick <= t.tick_end())
+        for (auto i = m_triggers.begin() + index; i != m_triggers.end(); ++i)
         {
-            select(t);
-            result = true;
+            trigger & t = *i;
+            if (t.tick_start() > tick && m_index_usable)
+                break;                          /* no later one brackets it */
+
+            if (t.tick_start() <= tick && tick <= t.tick_end())
+            {
+                select(t);
+                result = true;
+            }
         }
     }
     return result;
@@ -1282,12 +1379,20 @@ bool
 triggers::unselect (midipulse tick)
 {
     bool result = false;
-    for (auto & t : m_triggers)
+    int index = first_bracketing(tick);
+    if (index >= 0)
     {
-        if (t.tick_start() <= tick && tick <= t.tick_end())
+        for (auto i = m_triggers.begin() + index; i != m_triggers.end(); ++i)
         {
-            unselect(t);
-            result = true;
+            trigger & t = *i;
+            if (t.tick_start() > tick && m_index_usable)
+                break;                          /* no later one brackets it */
+
+            if (t.tick_start() <= tick && tick <= t.tick_end())
+            {
+                unselect(t);
+                result = true;
+            }
         }
     }
     return result;
@@ -1326,6 +1431,7 @@ triggers::remove_selected ()
         {
             unselect(*i);               /* this adjusts the selection count */
             m_triggers.erase(i);
+            modified();
             result = true;
             break;
         }
@@ -269,12 +269,29 @@ clinsmanager::save_session (std::string & msg, bool ok)
 /**
  *  This function is useful in the command-line version of the application.
  *  For the Qt version, see the qt5nsmanager class.
+ *
+ *  If the "-o render=filename" option was given, this function does a batch
+ *  export instead:  it renders the song offline to that file and returns,
+ *  without waiting for the session to close.
  */
 
 bool
 clinsmanager::run ()
 {
     bool result = false;
+    const std::string & renderfile = usr().option_render();
+    if (! renderfile.empty())
+    {
+        std::string errmsg;
+        result = not_nullptr(perf());
+        if (result)
+            result = perf()->render_song(renderfile, errmsg);
+
+        if (! result)
+            file_error(errmsg.empty() ? "Render failed" : errmsg, renderfile);
+
+        return result;
+    }
     session_setup();
     while (! session_close())
     {
@@ -288,6 +305,9 @@ clinsmanager::run ()
                 file_error(msg, "CLI");
             }
         }
+        if (not_nullptr(perf()))
+            (void) perf()->deliver_notifications();
+
         millisleep(m_poll_period_ms);
     }
     return true;
@@ -92,6 +92,7 @@
 #include <dir.h>                        /* file-name info and getcwd()      */
 #include <io.h>                         /* _access_s()                      */
 #include <share.h>                      /* _SH_DENYNO                       */
+#include <windows.h>                    /* ::MoveFileExA()                  */
 
 #if defined SEQ66_PLATFORM_MSVC         /* Microsoft compiler vs MingW      */
 #define F_OK        0x00                /* existence                        */
@@ -137,6 +138,7 @@ using stat_t = struct stat;
 
 #else                                   /* non-Microsoft stuff follows      */
 
+#include <fcntl.h>                      /* open(2) flags, O_RDONLY          */
 #include <unistd.h>
 
 #define S_ACCESS    access              /* ISO/POSIX/BSD unsafe access()    */
@@ -893,6 +895,154 @@ file_close (std::FILE * filehandle, const std::string & filename)
     return result;
 }
 
+/**
+ *  Flushes the C library buffers of a file opened for writing, and then has
+ *  the kernel write the file to the disk.  Replaces fflush() plus fsync(),
+ *  or _commit() on Windows.  Used before renaming a new file into place, so
+ *  that a crash cannot leave the new name pointing to an empty file.
+ *
+ * \param filehandle
+ *      Provides the file-handle to be synced.
+ *
+ * \param filename
+ *      Provides the name of the file, used only for error reporting.
+ *
+ * \return
+ *      Returns 'true' if the data reached the disk.
+ */
+
+bool
+file_sync (std::FILE * filehandle, const std::string & filename)
+{
+    bool result = not_nullptr_assert(filehandle, "file_sync() null handle");
+    if (result)
+    {
+        result = fflush(filehandle) == 0;
+        if (result)
+        {
+#if defined SEQ66_PLATFORM_WINDOWS
+            result = _commit(_fileno(filehandle)) == 0;
+#else
+            result = fsync(fileno(filehandle)) == 0;
+#endif
+        }
+        if (! result)
+            file_error("Sync failed", filename);
+    }
+    return result;
+}
+
+/**
+ *  Has the kernel write a directory entry to the disk, so that a file just
+ *  created or renamed in that directory survives a crash.  Windows has no
+ *  equivalent, and there this function does nothing.
+ *
+ * \param path
+ *      Provides the directory.  If empty, the current directory is used.
+ *
+ * \return
+ *      Returns 'true' if the directory could be synced, or on Windows.
+ */
+
+bool
+directory_sync (const std::string & path)
+{
+#if defined SEQ66_PLATFORM_WINDOWS
+    (void) path;
+    return true;
+#else
+    std::string dir = path.empty() ? std::string(".") : path ;
+    bool result = false;
+    int fd = S_OPEN(dir.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        result = fsync(fd) == 0;
+        (void) S_CLOSE(fd);
+    }
+    if (! result)
+        file_error("Sync failed", dir);
+
+    return result;
+#endif
+}
+
+/**
+ *  Renames a file over another one, replacing it in one step, so that the
+ *  destination is never missing.  POSIX rename(2) does this.  On Windows,
+ *  rename() refuses to replace a file, and MoveFileEx() is used instead.
+ *
+ * \param source
+ *      Provides the file to be renamed, such as a temporary file.
+ *
+ * \param destination
+ *      Provides the file to be replaced.  It does not need to exist.
+ *
+ * eturn
+ *      Returns 'true' if the file was renamed.
+ */
+
+bool
+file_replace (const std::string & source, const std::string & destination)
+{
+    bool result = ! source.empty() && ! destination.empty();
+    if (result)
+    {
+#if defined SEQ66_PLATFORM_WINDOWS
+        DWORD flags = MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH;
+        result = ::MoveFileExA(source.c_str(), destination.c_str(), flags) != 0;
+#else
+        result = std::rename(source.c_str(), destination.c_str()) == 0;
+#endif
+        if (! result)
+            file_error("Rename failed", destination);
+    }
+    return result;
+}
+
+/**
+ *  Gives a file the permissions, and if possible the owner, of another file.
+ *  Used before a new file replaces an old one, so that the replacement keeps
+ *  the mode of the old file.  Changing the owner usually requires privileges,
+ *  so a failure to do so is ignored.
+ *
+ * \param source
+ *      Provides the file whose mode is copied.
+ *
+ * \param destination
+ *      Provides the file whose mode is changed.
+ *
+ * eturn
+ *      Returns 'true' if the mode was copied.
+ */
+
+bool
+file_copy_mode (const std::string & source, const std::string & destination)
+{
+    struct stat statusbuf;
+    bool result = S_STAT(source.c_str(), &statusbuf) == 0;
+    if (result)
+    {
+#if defined SEQ66_PLATFORM_WINDOWS
+        int mode = statusbuf.st_mode & (_S_IREAD | _S_IWRITE);
+        result = _chmod(destination.c_str(), mode) == 0;
+#else
+        mode_t mode = statusbuf.st_mode & 07777;
+        result = chmod(destination.c_str(), mode) == 0;
+        if (result)
+        {
+            int rc = chown
+            (
+                destination.c_str(), statusbuf.st_uid, statusbuf.st_gid
+            );
+            (void) rc;                          /* only root can give away  */
+        }
+#endif
+        if (! result)
+            file_error("Mode change failed", destination);
+    }
+    return result;
+}
+
 bool
 file_delete (const std::string & filespec)
 {
@@ -28,7 +28,7 @@
  * \updates       2022-09-21
  * \license       GNU GPLv2 or above
  *
- *  A lock-free ring buffer.
+ *  A lock-free (wait-free, single-producer/single-consumer) ring buffer.
  *
  *   (C) Copyright 2000 Paul Davis
  *   (C) Copyright 2003 Rohan Drape
@@ -232,7 +232,7 @@ run_ring_test ()
     {
         ring_test rt;
         sz = rb.read(rt);
-        if (sz > 0)
+        if (sz == 0)
         {
             show_error("ring_buffer::read() failed");
             result = false;
@@ -250,8 +250,8 @@ run_ring_test ()
     }
 
     /*
-     * Full buffer test. Ultimately 10 items entered. Only 8 should remain.
-     * Then we pop all items in the ring_buffer and show them.
+     * Full buffer test. Ultimately 10 items offered. Only the first 8 should
+     * be accepted. Then we pop all items in the ring_buffer and show them.
      * (Should compare counters at some point.)
      */
 
@@ -303,7 +303,7 @@ run_ring_test ()
     if (result)
     {
         /*
-         * Here, rt_a and rt_b should be dropped.
+         * Here, rt_i and rt_j should be rejected.
          */
 
         rb.push_back(rt_i);
@@ -313,7 +313,7 @@ run_ring_test ()
         std::size_t wspace = rb.write_space();
         if (rb.count() != 8 || rspace != 8 || wspace != 0)
         {
-            show_error("objects not overwritten");
+            show_error("objects not rejected");
             result = false;
         }
         if (rb.dropped() != 2)
@@ -329,7 +329,7 @@ run_ring_test ()
                 ring_test::cref item = rb.front();
                 std::string values = item.to_string();
                 printf("[%d] %s\n", i, values.c_str());
-                if (item.test_counter() != (i + 3))
+                if (item.test_counter() != (i + 1))
                     result = false;
 
                 rb.pop_front();
@@ -339,7 +339,7 @@ run_ring_test ()
 
             if (rb.empty())
             {
-                show_message("Should see rt_c through rt_j values");
+                show_message("Should see rt_a through rt_h values");
             }
             else
             {
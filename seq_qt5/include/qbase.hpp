@@ -115,6 +115,13 @@ private:
 
     mutable bool m_is_initialized;
 
+    /**
+     *  The change generation of the performer when this view last checked
+     *  it.  See generation_changed().
+     */
+
+    mutable unsigned m_perf_generation;
+
 public:
 
     qbase (performer & p, int zoom);
@@ -188,6 +195,8 @@ public:
         return result;
     }
 
+    bool generation_changed () const;
+
     virtual bool change_ppqn (int ppqn) = 0;
 
     virtual bool change_bpm (midibpm /*bpm*/)
@@ -34,6 +34,7 @@
  */
 
 #include <QFont>
+#include <QPixmap>
 
 #include "qslotbutton.hpp"              /* seq66::qslotbutton base class    */
 
@@ -210,6 +211,16 @@ private:
     progbox m_event_box;
     bool m_use_gradient;
 
+    /**
+     *  The notes of the pattern as drawn in the event box, redrawn only when
+     *  the draw generation of the pattern, or the size of the box, changes.
+     *  See draw_thumbnail().
+     */
+
+    QPixmap m_thumbnail;
+    unsigned m_thumbnail_generation;
+    bool m_thumbnail_valid;
+
 public:
 
     qloopbutton
@@ -241,6 +252,9 @@ public:
     }
 
     virtual void setup () override;
+    virtual void draw_slot (QPainter & painter) override;
+    virtual void draw_slot_progress (QPainter & painter) override;
+    virtual QRect progress_rect () const override;
     virtual void reupdate (bool all = true) override;
     virtual void set_checked (bool flag) override;
     virtual bool toggle_enabled () override;
@@ -251,6 +265,8 @@ protected:
     void draw_progress (QPainter & p, midipulse tick, bool tiny = false);
     void draw_progress_box (QPainter & painter);
     void draw_pattern (QPainter & painter);
+    void draw_thumbnail (QPainter & painter);
+    void draw_labels (QPainter & painter);
     void initialize_fingerprint ();
 
 private:
@@ -35,7 +35,9 @@
  *  performance/song editor.
  */
 
+#include <QPixmap>
 #include <QWidget>
+#include <vector>                       /* std::vector<> layer keys         */
 
 #include "qperfbase.hpp"                /* seq66::qperfbase base class      */
 
@@ -45,7 +47,6 @@
 
 class QKeyEvent;
 class QMouseEvent;
-class QTimer;
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -98,6 +99,8 @@ private:
     bool move_by_key (bool forward, bool single = true);
     void draw_grid (QPainter & painter, const QRect & r);
     void draw_triggers (QPainter & painter, const QRect & r);
+    bool layers_current (const QRect & r);
+    void draw_layers (const QRect & r);
 
     void resize ()
     {
@@ -168,7 +171,6 @@ private:
 
     qperfnames * m_perf_names;
 
-    QTimer * m_timer;
     QFont m_font;
     int m_prog_thickness;
     int m_trigger_transpose;
@@ -184,6 +186,22 @@ private:
     bool m_grow_direction;
     bool m_adding_pressed;
 
+    /**
+     *  Caches the grid and the triggers of the exposed rectangle, so that a
+     *  paint for the motion of the progress bar is a blit of this pixmap
+     *  plus the bar.  See layers_current().
+     */
+
+    QPixmap m_layers;
+
+    /**
+     *  The view settings and change generation that m_layers was drawn
+     *  with, and the rectangle of the view it holds.
+     */
+
+    std::vector<midipulse> m_layers_key;
+    QRect m_layers_rect;
+
 };          // class qperfroll
 
 }           // namespace seq66
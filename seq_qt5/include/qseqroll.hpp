@@ -37,7 +37,9 @@
  *  progress bar during playback.  See the qseqbase::m_progress_follow member.
  */
 
+#include <QPixmap>
 #include <QWidget>
+#include <vector>                       /* std::vector<> layer keys         */
 
 #include "cfg/scales.hpp"               /* seq66::scales enum class         */
 #include "play/sequence.hpp"            /* sequence::editmode mode          */
@@ -48,8 +50,6 @@
  */
 
 class QMessageBox;
-class QPixmap;
-class QTimer;
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -177,6 +177,9 @@ private:
     void draw_drum_notes (QPainter & painter, const QRect & r, bool background);
     void draw_drum_note (QPainter & painter, int x, int y);
     void call_draw_notes (QPainter & painter, const QRect & view);
+    sequence * background_track ();
+    bool layers_current (const QRect & r);
+    void draw_layers (const QRect & r);
 #if defined SEQ66_SHOW_TEMPO_IN_PIANO_ROLL
     void draw_tempo (QPainter & painter, int x, int y, int velocity);
 #endif
@@ -204,17 +207,21 @@ private:
     qseqkeys * m_seqkeys_wid;
 
     /**
-     *  Screen update timer.
+     *  The width, in pixels, of the progress-bar/playhead.  Usually 1 or 2
+     *  pixels.
      */
 
-    QTimer * m_timer;
+    int m_progbar_width;
 
     /**
-     *  The width, in pixels, of the progress-bar/playhead.  Usually 1 or 2
-     *  pixels.
+     *  The draw generations of the pattern, and of the background pattern
+     *  (if drawn), when this roll last checked them.  Only a change of these
+     *  patterns repaints the whole roll; the change generation of the
+     *  performer also moves for every other pattern.
      */
 
-    int m_progbar_width;
+    unsigned m_draw_generation;
+    unsigned m_backseq_generation;
 
     /**
      *  Indicates the musical scale in force for this sequence.
@@ -333,6 +340,51 @@ private:
 
     bool m_link_wraparound;
 
+    /**
+     *  Time-ordered note indices for the pattern and for the background
+     *  pattern.  They are rebuilt only when the draw generation of the
+     *  sequence changes, and let a paint draw only the notes in the exposed
+     *  rectangle.
+     */
+
+    sequence::noteindex m_note_index;
+    sequence::noteindex m_backseq_index;
+
+    /**
+     *  Scratch list of the note-index entries to draw, kept to avoid an
+     *  allocation on each paint.
+     */
+
+    std::vector<int> m_visible_notes;
+
+    /**
+     *  Caches the background, grid, and note layers of the exposed
+     *  rectangle.  While the notes and the view settings are unchanged, a
+     *  paint (for example, a move of the progress bar) is just a blit of
+     *  this pixmap plus the progress bar and selection boxes.
+     */
+
+    QPixmap m_layers;
+
+    /**
+     *  The view settings that m_layers was drawn with.  See
+     *  layers_current().
+     */
+
+    std::vector<midipulse> m_layers_key;
+
+    /**
+     *  The rectangle of the view that m_layers holds.
+     */
+
+    QRect m_layers_rect;
+
+    /**
+     *  Cleared by set_dirty() to force a redraw of m_layers.
+     */
+
+    bool m_layers_valid;
+
 signals:
 
 public slots:
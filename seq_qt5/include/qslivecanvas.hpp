@@ -0,0 +1,142 @@
+#if ! defined SEQ66_QSLIVECANVAS_HPP
+#define SEQ66_QSLIVECANVAS_HPP
+
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          qslivecanvas.hpp
+ *
+ *  This module declares a single widget that draws all of the slots of the
+ *  live grid.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  With the "grid-canvas" option, qslivegrid still creates a qslotbutton or
+ *  qloopbutton for each slot, to hold its state and to do its drawing, but
+ *  the buttons are never shown.  Instead, this canvas draws them all into
+ *  one cached pixmap, and on each frame of playback only blits that pixmap
+ *  and draws the progress bars over it.  Like the buttons, the canvas is
+ *  transparent to the mouse, and qslivegrid handles the clicks.
+ */
+
+#include <QPixmap>
+#include <QWidget>
+#include <vector>                       /* std::vector<> of cells           */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+    class qslotbutton;
+
+/**
+ *  Draws the slot buttons of a live grid on one widget.
+ */
+
+class qslivecanvas final : public QWidget
+{
+
+private:
+
+    /**
+     *  A slot of the grid:  the button that draws it, its place in the grid,
+     *  and its rectangle on the canvas, which is laid out by layout_cells().
+     */
+
+    class cell
+    {
+    public:
+
+        qslotbutton * c_button;
+        int c_row;
+        int c_column;
+        QRect c_rect;
+    };
+
+    using cells = std::vector<cell>;
+
+    /**
+     *  The slots, in no particular order.  The buttons are owned by the
+     *  qslivegrid.
+     */
+
+    cells m_cells;
+
+    /**
+     *  The size of the grid.  Changed by set_grid() when qslivegrid recreates
+     *  its buttons.
+     */
+
+    int m_rows;
+    int m_columns;
+
+    /**
+     *  All of the slots, drawn without their progress bars.  Redrawn only
+     *  when invalidate() is called or the canvas changes size.
+     */
+
+    QPixmap m_layers;
+    bool m_layers_valid;
+
+public:
+
+    qslivecanvas (int rows, int columns, QWidget * parent = nullptr);
+    qslivecanvas (const qslivecanvas &) = delete;
+    qslivecanvas & operator = (const qslivecanvas &) = delete;
+    virtual ~qslivecanvas ()
+    {
+        // no code needed
+    }
+
+    void set_grid (int rows, int columns);
+    void clear ();
+    void add (qslotbutton * pb, int row, int column);
+    void remove (qslotbutton * pb);
+    void invalidate ();
+    void update_progress ();
+    QRect slots_rect () const;
+
+protected:
+
+    virtual void paintEvent (QPaintEvent *) override;
+    virtual void resizeEvent (QResizeEvent *) override;
+
+private:
+
+    void layout_cells ();
+    void draw_layers ();
+
+};          // class qslivecanvas
+
+}           // namespace seq66
+
+#endif      // SEQ66_QSLIVECANVAS_HPP
+
+/*
+ * qslivecanvas.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -54,7 +54,6 @@
  */
 
 class QMenu;
-class QTimer;
 class QMessageBox;
 
 /*
@@ -71,6 +70,7 @@ namespace seq66
     class keystroke;
     class performer;
     class qsmainwnd;
+    class qslivecanvas;
     class qslotbutton;
 
 /**
@@ -187,6 +187,7 @@ private:
     void populate_grid_mode ();
     void set_grid_mode ();
     void update_state ();                               /* ca 2023-04-26    */
+    void update_canvas ();
 
 signals:
 
@@ -223,9 +224,22 @@ private:
 
     Ui::qslivegrid * ui;
     QMenu * m_popup;
-    QTimer * m_timer;
     QMessageBox * m_msg_box;
 
+    /**
+     *  The change generation of the performer when the buttons were last
+     *  updated.  See conditional_update().
+     */
+
+    unsigned m_perf_generation;
+
+    /**
+     *  Set while the slot buttons are being rebuilt for a bank change, so
+     *  that conditional_update() leaves them alone.
+     */
+
+    bool m_updates_paused;
+
     /**
      *  Indicates if the buttons should (re)drawn.
      */
@@ -241,6 +255,14 @@ private:
 
     buttons m_loop_buttons;
 
+    /**
+     *  If the "grid-canvas" option is set, this widget draws all of the
+     *  slots, and the buttons in m_loop_buttons are not shown.  Otherwise it
+     *  is null.
+     */
+
+    qslivecanvas * m_canvas;
+
     /**
      *  Layout of buttons for determining sequence numbers.
      */
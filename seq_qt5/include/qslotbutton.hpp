@@ -44,6 +44,8 @@
 #include "gui_palette_qt5.hpp"          /* seq66::Color                     */
 #include "play/seq.hpp"                 /* seq66::seq sequence-plus class   */
 
+class QPainter;
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -168,6 +170,17 @@ public:
     }
 
     virtual void setup ();
+    virtual void draw_slot (QPainter & painter);
+
+    virtual void draw_slot_progress (QPainter & /*painter*/)
+    {
+        // no code, an empty slot has no progress
+    }
+
+    virtual QRect progress_rect () const
+    {
+        return QRect();                 /* an empty slot has no progress    */
+    }
 
     virtual seq::pointer loop ()
     {
@@ -309,6 +322,8 @@ protected:
         // no code, handles empty button
     }
 
+    void draw_button (QPainter & painter);
+
 protected:
 
     void label_color (Color c)
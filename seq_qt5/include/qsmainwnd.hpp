@@ -65,7 +65,6 @@ class QErrorMessage;
 class QFileDialog;
 class QMessageBox;
 class QResizeEvent;
-class QTimer;
 
 /*
  *  The Qt UI namespace.
@@ -306,7 +305,6 @@ private:
     qplaylistframe * m_playlist_frame;
     QMessageBox * m_msg_error;              /* QErrorMessage        */
     QMessageBox * m_msg_save_changes;
-    QTimer * m_timer;
     QMenu * m_menu_recent;
     QList<QAction *> m_recent_action_list;
     qsmaintime * m_beat_ind;
@@ -468,6 +466,7 @@ private slots:
     void show_qsbuildinfo ();
     void tabWidgetClicked (int newindex);
     void conditional_update ();             /* redraw certain GUI elements  */
+    void deliver_notifications ();          /* performer::callbacks queue   */
     void load_editor (int seqid);
     void load_event_editor (int seqid);
     void load_qseqedit (int seqid);
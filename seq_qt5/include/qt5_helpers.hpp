@@ -91,6 +91,8 @@ extern QTimer * qt_timer
     int redraw_factor,
     const char * slotname
 );
+extern bool qt_refresh_connect (QObject * self, const char * slotname);
+extern bool qt_refresh_disconnect (QObject * self, const char * slotname);
 extern void enable_combobox_item (QComboBox * box, int index, bool enabled);
 extern bool fill_combobox
 (
@@ -119,6 +119,7 @@ HEADERS += include/gui_palette_qt5.hpp \
  include/qsetmaster.hpp \
  include/qseventslots.hpp \
  include/qslivebase.hpp \
+ include/qslivecanvas.hpp \
  include/qslivegrid.hpp \
  include/qslotbutton.hpp \
  include/qsmaintime.hpp \
@@ -165,6 +166,7 @@ SOURCES += src/gui_palette_qt5.cpp \
  src/qsetmaster.cpp \
  src/qseventslots.cpp \
  src/qslivebase.cpp \
+ src/qslivecanvas.cpp \
  src/qslivegrid.cpp \
  src/qslotbutton.cpp \
  src/qsmaintime.cpp \
@@ -56,7 +56,8 @@ qbase::qbase (performer & p, int zoom) :
     m_initial_zoom          (zoom > 0 ? zoom : 1),
     m_zoom                  (zoom),         /* adjusted below               */
     m_is_dirty              (false),
-    m_is_initialized        (false)
+    m_is_initialized        (false),
+    m_perf_generation       (p.change_generation() - 1)   /* 1st check true */
 {
     // No code needed
 }
@@ -104,6 +105,27 @@ qbase::zoom_out ()
     return result;
 }
 
+/**
+ *  Checks the change generation of the performer against the one this view
+ *  last saw.  Unlike performer::needs_update(), this check does not reset
+ *  anything, so that each view sees every change.
+ *
+ * \return
+ *      Returns true if the performer (or any pattern) changed since the last
+ *      call.
+ */
+
+bool
+qbase::generation_changed () const
+{
+    unsigned g = perf().change_generation();
+    bool result = g != m_perf_generation;
+    if (result)
+        m_perf_generation = g;
+
+    return result;
+}
+
 /**
  *  Sets the zoom parameter, z.  If valid, then the m_zoom member is set.
  *  The new setting should be passed to the roll, time, data, and event panels.
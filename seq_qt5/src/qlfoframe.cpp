@@ -371,6 +371,7 @@ void
 qlfoframe::reset ()
 {
     track().events() = m_backup_events;
+    track().publish_events();                           /* for playback     */
     track().set_dirty();                                /* for redrawing    */
     m_seqdata.set_dirty();                              /* for redrawing    */
     m_is_modified = false;
@@ -191,7 +191,10 @@ qloopbutton::qloopbutton
     m_bottom_right          (),
     m_progress_box          (),
     m_event_box             (),
-    m_use_gradient          (gui_use_gradient_brush())
+    m_use_gradient          (gui_use_gradient_brush()),
+    m_thumbnail             (),
+    m_thumbnail_generation  (seqp ? seqp->draw_generation() : 0),
+    m_thumbnail_valid       (false)
 {
     sm_draw_progress_box = usr().progress_box_shown();
     m_text_font.setBold(usr().progress_bar_thick());
@@ -551,108 +554,12 @@ qloopbutton::paintEvent (QPaintEvent * pev)
     {
         midipulse tick = loop()->get_last_tick();
         if (initialize_text() || tick == 0)
-        {
-            QRectF box
-            (
-                m_top_left.m_x, m_top_left.m_y,
-                m_top_left.m_w, m_top_left.m_h
-            );
-            QString title(qt(m_top_left.m_label));
-            painter.setPen(label_color());      /* text issue #50   */
-            painter.setFont(m_text_font);
-
-            /*
-             * Removed the "background role color" code that was here.
-             */
-
-            if (m_draw_text)
-            {
-                painter.drawText(box, m_top_left.m_flags, title);
-                title = qt(m_top_right.m_label);
-                box.setRect
-                (
-                    m_top_right.m_x, m_top_right.m_y,
-                    m_top_right.m_w, m_top_right.m_h
-                );
-                painter.drawText(box, m_top_right.m_flags, title);
-            }
-            if (loop()->recording())
-            {
-                int radius = usr().scale_size(s_radius_record) + 2;
-                int clx = m_top_right.m_x + m_top_right.m_w - radius - 2;
-                int cly = m_top_right.m_y + m_top_right.m_h;
-                int tlx = clx + usr().scale_size(2);
-                int tly = cly + radius - usr().scale_size(2);
-                QPen pen2(drum_paint());
-                QBrush brush(drum_paint(), Qt::SolidPattern);
-                painter.save();
-                painter.setPen(pen2);
-                painter.setBrush(brush);
-                painter.drawEllipse(clx, cly, radius, radius);
-                if (loop()->quantizing_or_tightening())
-                {
-                    int fontsize = usr().scale_font_size(s_fontsize_record);
-                    QFont font;
-                    font.setPointSize(fontsize);
-                    font.setBold(true);
-                    painter.setPen(Qt::black);
-                    painter.setFont(font);
-                    if (loop()->quantizing())
-                        painter.drawText(tlx, tly, "Q");
-                    else if (loop()->tightening())
-                        painter.drawText(tlx + 2, tly, "T");
-                }
-                painter.restore();
-            }
-            if (m_draw_text)
-            {
-                title = qt(m_bottom_left.m_label);
-                box.setRect
-                (
-                    m_bottom_left.m_x, m_bottom_left.m_y,
-                    m_bottom_left.m_w, m_bottom_left.m_h
-                );
-                painter.drawText(box, m_bottom_left.m_flags, title);
-
-                title = qt(m_bottom_right.m_label);
-                box.setRect
-                (
-                    m_bottom_right.m_x, m_bottom_right.m_y,
-                    m_bottom_right.m_w, m_bottom_right.m_h
-                );
-                painter.drawText(box, m_bottom_right.m_flags, title);
-            }
+            draw_labels(painter);
 
-            set_checked(loop()->armed());   /* gets hot-key toggle to show  */
-            if (loop()->armed())
-            {
-                title = loop()->get_queued() ? "Unqueued" : "Armed" ;
-            }
-            else if (loop()->get_queued())
-                title = "Queued";
-            else if (loop()->one_shot())
-                title = "One-shot";
-            else
-                title = "Muted";
-
-            if (m_draw_text)
-            {
-                // TODO: If vertically compressed, smaller font size needed
-
-                int line2y = 2 * usr().scale_font_size(6);
-                box.setRect
-                (
-                    m_top_left.m_x, m_top_left.m_y + line2y,
-                    m_top_left.m_w, m_top_left.m_h
-                );
-                painter.drawText(box, m_top_left.m_flags, title);
-            }
-            initialize_fingerprint();
-        }
         if (sm_draw_progress_box)
             draw_progress_box(painter);
 
-        draw_pattern(painter);
+        draw_thumbnail(painter);
 
         bool tiny = ! (loop()->is_playable() && loop()->armed());
         draw_progress(painter, tick, tiny);
@@ -666,6 +573,215 @@ qloopbutton::paintEvent (QPaintEvent * pev)
     }
 }
 
+/**
+ *  Draws the title, length, status, buss/channel, and hot-key text of the
+ *  slot, and refreshes the fingerprint.
+ */
+
+void
+qloopbutton::draw_labels (QPainter & painter)
+{
+    QRectF box
+    (
+        m_top_left.m_x, m_top_left.m_y,
+        m_top_left.m_w, m_top_left.m_h
+    );
+    QString title(qt(m_top_left.m_label));
+    painter.setPen(label_color());      /* text issue #50   */
+    painter.setFont(m_text_font);
+
+    /*
+     * Removed the "background role color" code that was here.
+     */
+
+    if (m_draw_text)
+    {
+        painter.drawText(box, m_top_left.m_flags, title);
+        title = qt(m_top_right.m_label);
+        box.setRect
+        (
+            m_top_right.m_x, m_top_right.m_y,
+            m_top_right.m_w, m_top_right.m_h
+        );
+        painter.drawText(box, m_top_right.m_flags, title);
+    }
+    if (loop()->recording())
+    {
+        int radius = usr().scale_size(s_radius_record) + 2;
+        int clx = m_top_right.m_x + m_top_right.m_w - radius - 2;
+        int cly = m_top_right.m_y + m_top_right.m_h;
+        int tlx = clx + usr().scale_size(2);
+        int tly = cly + radius - usr().scale_size(2);
+        QPen pen2(drum_paint());
+        QBrush brush(drum_paint(), Qt::SolidPattern);
+        painter.save();
+        painter.setPen(pen2);
+        painter.setBrush(brush);
+        painter.drawEllipse(clx, cly, radius, radius);
+        if (loop()->quantizing_or_tightening())
+        {
+            int fontsize = usr().scale_font_size(s_fontsize_record);
+            QFont font;
+            font.setPointSize(fontsize);
+            font.setBold(true);
+            painter.setPen(Qt::black);
+            painter.setFont(font);
+            if (loop()->quantizing())
+                painter.drawText(tlx, tly, "Q");
+            else if (loop()->tightening())
+                painter.drawText(tlx + 2, tly, "T");
+        }
+        painter.restore();
+    }
+    if (m_draw_text)
+    {
+        title = qt(m_bottom_left.m_label);
+        box.setRect
+        (
+            m_bottom_left.m_x, m_bottom_left.m_y,
+            m_bottom_left.m_w, m_bottom_left.m_h
+        );
+        painter.drawText(box, m_bottom_left.m_flags, title);
+
+        title = qt(m_bottom_right.m_label);
+        box.setRect
+        (
+            m_bottom_right.m_x, m_bottom_right.m_y,
+            m_bottom_right.m_w, m_bottom_right.m_h
+        );
+        painter.drawText(box, m_bottom_right.m_flags, title);
+    }
+
+    set_checked(loop()->armed());   /* gets hot-key toggle to show  */
+    if (loop()->armed())
+    {
+        title = loop()->get_queued() ? "Unqueued" : "Armed" ;
+    }
+    else if (loop()->get_queued())
+        title = "Queued";
+    else if (loop()->one_shot())
+        title = "One-shot";
+    else
+        title = "Muted";
+
+    if (m_draw_text)
+    {
+        // TODO: If vertically compressed, smaller font size needed
+
+        int line2y = 2 * usr().scale_font_size(6);
+        box.setRect
+        (
+            m_top_left.m_x, m_top_left.m_y + line2y,
+            m_top_left.m_w, m_top_left.m_h
+        );
+        painter.drawText(box, m_top_left.m_flags, title);
+    }
+    initialize_fingerprint();
+}
+
+/**
+ *  Draws the slot, minus its progress bar, onto the canvas of the live grid
+ *  (see qslivecanvas).  This is the same drawing as paintEvent(), but the
+ *  button itself is never shown, and the canvas caches the result until the
+ *  pattern or the grid changes.
+ */
+
+void
+qloopbutton::draw_slot (QPainter & painter)
+{
+    if (loop())
+    {
+        set_checked(loop()->armed());
+        draw_button(painter);
+        (void) initialize_text();
+        draw_labels(painter);
+        if (sm_draw_progress_box)
+            draw_progress_box(painter);
+
+        draw_thumbnail(painter);
+    }
+    else
+        qslotbutton::draw_slot(painter);
+}
+
+/**
+ *  Draws only the progress bar of the slot onto the canvas of the live grid,
+ *  over the cached drawing of the slot.
+ */
+
+void
+qloopbutton::draw_slot_progress (QPainter & painter)
+{
+    if (loop())
+    {
+        bool tiny = ! (loop()->is_playable() && loop()->armed());
+        draw_progress(painter, loop()->get_last_tick(), tiny);
+    }
+}
+
+/**
+ * \return
+ *      Returns the rectangle of the slot that the progress bar moves in,
+ *      padded by the thickness of the bar.
+ */
+
+QRect
+qloopbutton::progress_rect () const
+{
+    int pad = m_prog_thickness + 1;
+    return QRect
+    (
+        m_progress_box.x() - pad, m_progress_box.y() - pad,
+        m_progress_box.w() + 2 * pad, m_progress_box.h() + 2 * pad
+    );
+}
+
+/**
+ *  Draws the notes of the pattern from m_thumbnail, first redrawing the
+ *  thumbnail if the pattern was edited (its draw generation moved) or the
+ *  event box changed size.  This avoids walking all of the events of the
+ *  pattern on every repaint of the slot.  The thumbnail has a small margin
+ *  around the event box, since the notes at the edges spill over it.
+ */
+
+void
+qloopbutton::draw_thumbnail (QPainter & painter)
+{
+    const int margin = 2;
+    QRect box
+    (
+        m_event_box.x() - margin, m_event_box.y() - margin,
+        m_event_box.w() + 2 * margin, m_event_box.h() + 2 * margin
+    );
+    if (m_event_box.w() <= 0 || m_event_box.h() <= 0)
+        return;
+
+    unsigned g = loop()->draw_generation();
+    qreal ratio = devicePixelRatioF();
+    QSize pixsize = box.size() * ratio;
+    bool current = m_thumbnail_valid && g == m_thumbnail_generation &&
+        m_thumbnail.size() == pixsize;
+
+    if (! current)
+    {
+        if (g != m_thumbnail_generation)
+        {
+            m_fingerprint_inited = m_fingerprinted = false;
+            initialize_fingerprint();           /* the notes have changed   */
+        }
+        m_thumbnail = QPixmap(pixsize);
+        m_thumbnail.setDevicePixelRatio(ratio);
+        m_thumbnail.fill(Qt::transparent);
+
+        QPainter thumb(&m_thumbnail);
+        thumb.translate(-box.topLeft());
+        draw_pattern(thumb);
+        m_thumbnail_generation = g;
+        m_thumbnail_valid = true;
+    }
+    painter.drawPixmap(box.topLeft(), m_thumbnail);
+}
+
 /**
  *      Draws the progress box, progress bar, and and indicator for non-empty
  *      pattern slots.
@@ -536,6 +536,7 @@ qpatternfix::slot_reset ()
     track().set_beat_width(m_backup_width);             /* ditto            */
     track().apply_length(m_backup_measures);            /* simple overload  */
     track().events() = m_backup_events;                 /* restore events   */
+    track().publish_events();                           /* for playback     */
     m_measures = double(m_backup_measures);
     m_align_left = m_use_time_sig = false;
     m_save_note_length = true;
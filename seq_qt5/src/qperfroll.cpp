@@ -40,7 +40,6 @@
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPainter>
-#include <QTimer>
 
 #include "cfg/settings.hpp"             /* seq66::usr() config functions    */
 #include "play/performer.hpp"           /* seq66::performer class           */
@@ -49,7 +48,7 @@
 #include "qperfeditframe64.hpp"
 #include "qperfnames.hpp"
 #include "qperfroll.hpp"
-#include "qt5_helpers.hpp"              /* seq66::qt_timer()                */
+#include "qt5_helpers.hpp"              /* seq66::qt_refresh_connect()      */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -104,7 +103,6 @@ qperfroll::qperfroll
     ),
     m_parent_frame      (frame),                /* frame64() accessor       */
     m_perf_names        (seqnames),
-    m_timer             (nullptr),
     m_font              ("Monospace"),
     m_prog_thickness    (usr().progress_bar_thick() ? 2 : 1),
     m_trigger_transpose (0),
@@ -118,7 +116,10 @@ qperfroll::qperfroll
     m_last_tick         (0),
     m_box_select        (false),
     m_grow_direction    (false),
-    m_adding_pressed    (false)
+    m_adding_pressed    (false),
+    m_layers            (),
+    m_layers_key        (),
+    m_layers_rect       ()
 {
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::MinimumExpanding);
     setFocusPolicy(Qt::StrongFocus);
@@ -127,32 +128,55 @@ qperfroll::qperfroll
     m_font.setLetterSpacing(QFont::AbsoluteSpacing, 1);
     m_font.setBold(true);
     m_font.setPointSize(s_vfont_size_normal);
-    m_timer = qt_timer(this, "qsperfroll", 2, SLOT(conditional_update()));
+    (void) qt_refresh_connect(this, SLOT(conditional_update()));
 }
 
 /**
- *  This virtual destructor stops the timer.
+ *  This virtual destructor does nothing.  Qt breaks the connection to the
+ *  refresh driver.
  */
 
 qperfroll::~qperfroll ()
 {
-    m_timer->stop();
+    // no code
 }
 
 /**
- *  Calls update() if needed, and also implements follow-progress.
+ *  Called once per frame by the refresh driver.  Calls update() if this
+ *  view was marked dirty, or if the change generation of the performer
+ *  moved.  Otherwise, during playback, repaints only the strips under the
+ *  old and new positions of the progress bar.  Also implements
+ *  follow-progress.
  */
 
 void
 qperfroll::conditional_update ()
 {
-    if (perf().needs_update() || check_dirty())
+    bool changed = qbase::check_dirty();
+    if (generation_changed())
+        changed = true;
+
+    if (changed)
     {
         if (perf().follow_progress())
             follow_progress();              /* keep up with progress    */
 
+        m_layers_rect = QRect();            /* force a redraw of layers */
         update();
     }
+    else if (perf().is_running())
+    {
+        if (perf().follow_progress())
+            follow_progress();
+
+        int x = tix_to_pix(perf().get_tick());
+        if (x != progress_x())
+        {
+            int w = m_prog_thickness + 2;
+            update(progress_x() - w, 0, 2 * w, height());
+            update(x - w, 0, 2 * w, height());
+        }
+    }
 }
 
 /**
@@ -168,25 +192,31 @@ qperfroll::follow_progress ()
 }
 
 /**
- *  Draws and redraws the performance roll.
+ *  Draws and redraws the performance roll.  The grid and triggers are
+ *  drawn only if they changed or a new area is exposed; otherwise the cached
+ *  layers are blitted.
  */
 
 void
-qperfroll::paintEvent (QPaintEvent * /*qpep*/)
+qperfroll::paintEvent (QPaintEvent * qpep)
 {
+    QRect r = qpep->rect();
     QPainter painter(this);
-    QRect r(0, 0, width(), height());
     QBrush brush(Qt::white, Qt::NoBrush);
     QPen pen(fore_color());
-    pen.setStyle(Qt::SolidLine);
-    painter.setPen(pen);
-    painter.setBrush(brush);
-    painter.drawRect(0, 0, width(), height());
     if (! is_initialized())
         set_initialized();
 
-    draw_grid(painter, r);
-    draw_triggers(painter, r);
+    if (! layers_current(r))
+        draw_layers(r);
+
+    qreal ratio = devicePixelRatioF();
+    QRectF source
+    (
+        QPointF(r.topLeft() - m_layers_rect.topLeft()) * ratio,
+        QSizeF(r.size()) * ratio
+    );
+    painter.drawPixmap(QRectF(r), m_layers, source);
 
     /*
      * Draw selections, if applicable.  Currently, only one box can be selected.
@@ -218,8 +248,8 @@ qperfroll::paintEvent (QPaintEvent * /*qpep*/)
     }
 
 #if defined THIS_CODE_ADDS_VALUE
-    int xwidth = r.width();
-    int yheight = r.height() - 1;
+    int xwidth = width();
+    int yheight = height() - 1;
     pen.setStyle(Qt::SolidLine);                    // draw border
     pen.setColor(Qt::black);
     pen.setWidth(c_border_width);
@@ -228,14 +258,75 @@ qperfroll::paintEvent (QPaintEvent * /*qpep*/)
 #endif
 
     midipulse tick = perf().get_tick();         /* draw progress playhead   */
-    int progress_x = tix_to_pix(tick);          /* tick / scale_zoom()      */
+    old_progress_x(progress_x());
+    progress_x(tix_to_pix(tick));               /* tick / scale_zoom()      */
     pen.setColor(progress_color());
     pen.setStyle(Qt::SolidLine);
     if (usr().progress_bar_thick())
         pen.setWidth(c_pen_width);
 
     painter.setPen(pen);
-    painter.drawLine(progress_x, 1, progress_x, height() - 2);
+    painter.drawLine(progress_x(), 1, progress_x(), height() - 2);
+}
+
+/**
+ *  Checks that the cached layers still cover the exposed rectangle, and
+ *  were drawn with the current view settings and change generation.  A
+ *  pending set_dirty() also forces a redraw, in case update() is called
+ *  before conditional_update() sees it.
+ *
+ * \param r
+ *      The exposed rectangle of the paint event.
+ *
+ * \return
+ *      Returns true if m_layers can be blitted as is.
+ */
+
+bool
+qperfroll::layers_current (const QRect & r)
+{
+    std::vector<midipulse> key
+    {
+        width(), height(), zoom(), track_height(), scroll_offset(),
+        midipulse(perf().change_generation()), use_gradient() ? 1 : 0
+    };
+    bool result = ! is_dirty() && key == m_layers_key &&
+        m_layers_rect.contains(r);
+
+    if (! result)
+        m_layers_key = key;
+
+    return result;
+}
+
+/**
+ *  Draws the grid and the triggers into m_layers.  They are laid out
+ *  against the whole view, as before, but clipped to the exposed rectangle.
+ *
+ * \param r
+ *      The exposed rectangle of the paint event.
+ */
+
+void
+qperfroll::draw_layers (const QRect & r)
+{
+    QRect view(0, 0, width(), height());
+    qreal ratio = devicePixelRatioF();
+    m_layers = QPixmap(r.size() * ratio);
+    m_layers.setDevicePixelRatio(ratio);
+    m_layers_rect = r;
+
+    QPainter painter(&m_layers);
+    QBrush brush(Qt::white, Qt::NoBrush);
+    QPen pen(fore_color());
+    pen.setStyle(Qt::SolidLine);
+    painter.translate(-r.topLeft());
+    painter.setClipRect(r);
+    painter.setPen(pen);
+    painter.setBrush(brush);
+    painter.drawRect(view);
+    draw_grid(painter, view);
+    draw_triggers(painter, view);
 }
 
 bool
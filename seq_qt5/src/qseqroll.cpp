@@ -38,7 +38,6 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPen>
-#include <QTimer>
 
 #include "cfg/settings.hpp"             /* seq66::usr().key_height(), etc.  */
 #include "play/performer.hpp"           /* seq66::performer class           */
@@ -92,8 +91,9 @@ qseqroll::qseqroll
     m_font                  ("Monospace"),
     m_backseq_color         (backseq_paint()),
     m_seqkeys_wid           (seqkeys_wid),
-    m_timer                 (nullptr),
     m_progbar_width         (usr().progress_bar_thick() ? 2 : 1),
+    m_draw_generation       (s.draw_generation() - 1),  /* 1st check true */
+    m_backseq_generation    (0),
     m_scale                 (scales::off),
     m_pos                   (0),
     m_chord                 (0),
@@ -115,7 +115,14 @@ qseqroll::qseqroll
     m_keypadding_x          (c_keyboard_padding_x),
     m_v_zooming             (false),
     m_last_base_note        (-1),
-    m_link_wraparound       (usr().new_pattern_wraparound())
+    m_link_wraparound       (usr().new_pattern_wraparound()),
+    m_note_index            (),
+    m_backseq_index         (),
+    m_visible_notes         (),
+    m_layers                (),
+    m_layers_key            (),
+    m_layers_rect           (),
+    m_layers_valid          (false)
 {
     setAttribute(Qt::WA_StaticContents);
     setAttribute(Qt::WA_OpaquePaintEvent);          /* no erase on repaint  */
@@ -128,30 +135,53 @@ qseqroll::qseqroll
     m_font.setPointSize(6);                         /* 8 is too obtrusive   */
     set_snap(track().snap());
     show();
-    m_timer = qt_timer(this, "qseqroll", 1, SLOT(conditional_update()));
+    (void) qt_refresh_connect(this, SLOT(conditional_update()));
 }
 
 /**
- *  This virtual destructor stops the timer.
+ *  This virtual destructor does nothing.  Qt breaks the connection to the
+ *  refresh driver.
  */
 
 qseqroll::~qseqroll ()
 {
-    m_timer->stop();
+    // no code
 }
 
 /**
- *  In an effort to reduce CPU usage when simply idling, this function calls
- *  update() only if necessary.  See qseqbase::check_dirty().
+ *  Called once per frame by the refresh driver.  The whole view is repainted
+ *  only if it is dirty (see qseqbase::check_dirty()), or if the draw
+ *  generation of this pattern or of the background pattern moved (an edit,
+ *  recording, etc.).  Edits of other patterns do not repaint this roll.
+ *  Otherwise, during playback, only the strips under the old and new
+ *  positions of the progress bar are repainted, which is a blit of the
+ *  cached layers.
  *
- *  bool ok = track().playing();
+ *  While running, performer::needs_update() is always true, so then only
+ *  the dirty flag of the view itself is checked; the draw generations
+ *  cover the changes to the patterns.
  */
 
 void
 qseqroll::conditional_update ()
 {
-    bool ok = perf().needs_update() || check_dirty();
-    if (ok)
+    bool changed = perf().is_running() ? qbase::check_dirty() : check_dirty() ;
+    unsigned g = track().draw_generation();
+    if (g != m_draw_generation)
+    {
+        m_draw_generation = g;
+        changed = true;
+    }
+
+    const sequence * b = background_track();
+    unsigned bg = not_nullptr(b) ? b->draw_generation() : 0 ;
+    if (bg != m_backseq_generation)
+    {
+        m_backseq_generation = bg;
+        changed = true;
+    }
+
+    if (changed)
     {
 #if defined SEQ66_ALWAYS_VERIFY_AND_LINK
         if (track().recording())
@@ -162,6 +192,19 @@ qseqroll::conditional_update ()
 
         update();
     }
+    else if (perf().is_running())
+    {
+        if (progress_follow())
+            follow_progress();
+
+        int x = xoffset(track().get_tick());
+        if (x != progress_x())
+        {
+            int w = m_progbar_width + 2;
+            update(progress_x() - w, 0, 2 * w, height());
+            update(x - w, 0, 2 * w, height());
+        }
+    }
 }
 
 void
@@ -177,6 +220,7 @@ qseqroll::set_dirty ()
      *      frame64()->set_external_frame_title();
      */
 
+    m_layers_valid = false;
     qseqbase::set_dirty();
 }
 
@@ -327,6 +371,7 @@ qseqroll::set_background_sequence (bool state, int seq)
         {
             m_draw_background_seq = state;
             m_background_sequence = seq;
+            m_backseq_index.clear();
         }
         if (is_initialized())
             set_dirty();
@@ -361,7 +406,6 @@ void
 qseqroll::paintEvent (QPaintEvent * qpep)
 {
     QRect r = qpep->rect();
-    QRect view(0, 0, width(), height());
     QPainter painter(this);
     QBrush brush(blank_brush());    // QBrush brush(Qt::white, Qt::NoBrush);
     QPen pen(Qt::lightGray);
@@ -373,19 +417,20 @@ qseqroll::paintEvent (QPaintEvent * qpep)
     m_edit_mode = perf().edit_mode(track().seq_number());
 
     /*
-     * Draw the border and grid. See the banner notes about width and height.
-     * Doesn't seem to be needed: painter.drawRect(0, 0, ww, wh);
+     * Draw the border, grid, and events, but only if they have changed or a
+     * different area is exposed.  Otherwise, blit the cached layers.
      */
 
-    draw_grid(painter, view);
-    set_initialized();
+    if (! layers_current(r))
+        draw_layers(r);
 
-    /*
-     * Draw the events. This currently draws all of them.  Drawing all them
-     * only needs to be drawn once.
-     */
-
-    call_draw_notes(painter, view);
+    qreal ratio = devicePixelRatioF();
+    QRectF source
+    (
+        QPointF(r.topLeft() - m_layers_rect.topLeft()) * ratio,
+        QSizeF(r.size()) * ratio
+    );
+    painter.drawPixmap(QRectF(r), m_layers, source);
     pen.setWidth(c_pen_width);
 
     /*
@@ -469,6 +514,97 @@ qseqroll::paintEvent (QPaintEvent * qpep)
     }
 }
 
+/**
+ *  \return
+ *      Returns the background pattern, if it is to be drawn, and exists.
+ *      Otherwise, a null pointer is returned.
+ */
+
+sequence *
+qseqroll::background_track ()
+{
+    return m_draw_background_seq ?
+        perf().get_sequence(m_background_sequence).get() : nullptr ;
+}
+
+/**
+ *  Checks that the cached layers still cover the exposed rectangle, and
+ *  match the view settings and the notes of the pattern (and background
+ *  pattern).  A smaller rectangle, such as the strip under the progress bar,
+ *  is blitted from the layers of the larger one.
+ *  The note indices are refreshed as a side-effect, so that they are
+ *  current when draw_layers() needs them.
+ *
+ * \param r
+ *      The exposed rectangle of the paint event.
+ *
+ * \return
+ *      Returns true if m_layers can be blitted as is.
+ */
+
+bool
+qseqroll::layers_current (const QRect & r)
+{
+    bool changed = m_note_index.refresh(track());
+    sequence * b = background_track();
+    if (is_nullptr(b))
+        m_backseq_index.clear();
+    else if (m_backseq_index.refresh(*b))
+        changed = true;
+
+    std::vector<midipulse> key
+    {
+        width(), height(), zoom(), unit_height(), total_height(),
+        scroll_offset_x(), scroll_offset_v(), grid_snap(),
+        m_key, int(m_scale), int(m_edit_mode),
+        not_nullptr(b) ? m_background_sequence : seq::unassigned(),
+        not_nullptr(b) ? midipulse(b->draw_generation()) : 0,
+        track().get_length(), track().get_beats_per_bar(),
+        track().get_beat_width(), use_gradient() ? 1 : 0
+    };
+    bool result = m_layers_valid && ! changed && key == m_layers_key &&
+        m_layers_rect.contains(r);
+
+    if (! result)
+        m_layers_key = key;
+
+    return result;
+}
+
+/**
+ *  Draws the grid and the notes of the exposed rectangle into m_layers.  The
+ *  grid is laid out against the whole view, as before, but clipped to the
+ *  rectangle; the notes are looked up in the note indices for just the
+ *  ticks that the rectangle covers.  If the pattern was in the middle of an
+ *  action, the layers are not marked valid, so that the next paint tries
+ *  again.
+ *
+ * \param r
+ *      The exposed rectangle of the paint event.
+ */
+
+void
+qseqroll::draw_layers (const QRect & r)
+{
+    QRect view(0, 0, width(), height());
+    qreal ratio = devicePixelRatioF();
+    m_layers = QPixmap(r.size() * ratio);
+    m_layers.setDevicePixelRatio(ratio);
+    m_layers_rect = r;
+
+    QPainter painter(&m_layers);
+    QPen pen(Qt::lightGray);
+    pen.setStyle(Qt::SolidLine);
+    painter.translate(-r.topLeft());
+    painter.setClipRect(r);
+    painter.setPen(pen);
+    painter.setFont(m_font);
+    draw_grid(painter, view);
+    set_initialized();
+    call_draw_notes(painter, r);
+    m_layers_valid = m_note_index.valid();
+}
+
 void
 qseqroll::call_draw_notes (QPainter & painter, const QRect & view)
 {
@@ -679,25 +815,21 @@ qseqroll::draw_notes
     painter.setPen(pen);
     painter.setBrush(brush);
 
-    midipulse seqlength = track().get_length();
-    midipulse start_tick = pix_to_tix(r.x());
-    midipulse end_tick = start_tick + pix_to_tix(r.width());
-    sequence * b = perf().get_sequence(m_background_sequence).get();
-    sequence * s = background ? b : &track();
-    if (is_nullptr(s))
-        return;
+    const sequence::noteindex & nx = background ?
+        m_backseq_index : m_note_index ;
 
+    midipulse seqlength = track().get_length();
+    midipulse margin = pix_to_tix(unit_height() + m_keypadding_x) + 16;
+    midipulse start_tick = pix_to_tix(r.x()) - margin;
+    midipulse end_tick = pix_to_tix(r.x() + r.width()) + margin;
     int unitheight = unit_height();
     int unitdecr = unit_height() - 2;
     int noteheight = unitheight - 3;
-    s->draw_lock();
-    for (auto cev = s->cbegin(); ! s->cend(cev); ++cev)
+    nx.visible(start_tick, end_tick, m_visible_notes);
+    for (int index : m_visible_notes)
     {
-        sequence::note_info ni;
-        sequence::draw dt = s->get_next_note(ni, cev);
-        if (dt == sequence::draw::finish)
-            break;
-
+        const sequence::note_info & ni = nx.info(index);
+        sequence::draw dt = nx.kind(index);
         if (dt == sequence::draw::tempo)
         {
 #if defined SEQ66_SHOW_TEMPO_IN_PIANO_ROLL
@@ -714,180 +846,173 @@ qseqroll::draw_notes
             continue;
         }
 
-        bool start_in = ni.start() >= start_tick && ni.start() <= end_tick;
-        bool end_in = ni.finish() >= start_tick && ni.finish() <= end_tick;
         bool not_wrapped = ni.finish() >= ni.start();
-        bool linkedin = dt == sequence::draw::linked && end_in;
         bool bad = false;
-        if (start_in || linkedin)
+        int in_shift = 0;
+        int length_add = 0;
+        m_note_x = xoffset(ni.start());
+        m_note_y = total_height() - (ni.note() * unitheight) - unitdecr;
+        if (dt == sequence::draw::linked)
         {
-            int in_shift = 0;
-            int length_add = 0;
-            m_note_x = xoffset(ni.start());
-            m_note_y = total_height() - (ni.note() * unitheight) - unitdecr;
-            if (dt == sequence::draw::linked)
+            if (not_wrapped)
             {
-                if (not_wrapped)
-                {
-                    m_note_width = tix_to_pix(ni.finish() - ni.start());
-                    if (m_note_width < 1)
-                        m_note_width = 1;
-                }
-                else
-                    m_note_width = tix_to_pix(seqlength - ni.start());
+                m_note_width = tix_to_pix(ni.finish() - ni.start());
+                if (m_note_width < 1)
+                    m_note_width = 1;
             }
             else
-                m_note_width = tix_to_pix(16);
+                m_note_width = tix_to_pix(seqlength - ni.start());
+        }
+        else
+            m_note_width = tix_to_pix(16);
 
-            if (dt == sequence::draw::note_on)      /* means it's unlinked  */
-            {
-                in_shift = 0;
-                length_add = 2;
-                bad = true;
-                painter.setBrush(error_brush);
-            }
-            else if (dt == sequence::draw::note_off)
-            {
-                in_shift = -1;
-                length_add = 1;
-                bad = true;
-                painter.setBrush(error_brush);
-            }
-            if (background)                         /* draw background note */
+        if (dt == sequence::draw::note_on)      /* means it's unlinked  */
+        {
+            in_shift = 0;
+            length_add = 2;
+            bad = true;
+            painter.setBrush(error_brush);
+        }
+        else if (dt == sequence::draw::note_off)
+        {
+            in_shift = -1;
+            length_add = 1;
+            bad = true;
+            painter.setBrush(error_brush);
+        }
+        if (background)                         /* draw background note */
+        {
+            length_add = 1;
+            painter.setBrush(backseq_brush());
+        }
+        else
+        {
+            painter.setBrush(note_brush());
+        }
+        painter.drawRect(m_note_x, m_note_y, m_note_width, noteheight);
+        if (use_gradient())
+        {
+            if (background)
             {
                 length_add = 1;
                 painter.setBrush(backseq_brush());
+                painter.drawRect
+                (
+                    m_note_x, m_note_y, m_note_width, noteheight
+                );
             }
             else
             {
-                painter.setBrush(note_brush());
+                QLinearGradient grad
+                (
+                    m_note_x, m_note_y,
+                    m_note_x, m_note_y + noteheight
+                );
+                grad.setColorAt(0.05, fore_color());
+                grad.setColorAt(0.5,  note_in_color());
+                grad.setColorAt(0.95, fore_color());
+                painter.fillRect
+                (
+                    m_note_x + 1, m_note_y + 1, m_note_width - 1,
+                    noteheight - 1, grad
+                );
             }
-            painter.drawRect(m_note_x, m_note_y, m_note_width, noteheight);
+        }
+        if (m_link_wraparound && ! not_wrapped)
+        {
+            int len = tix_to_pix(ni.finish()) - m_note_off_margin;
             if (use_gradient())
             {
-                if (background)
-                {
-                    length_add = 1;
-                    painter.setBrush(backseq_brush());
-                    painter.drawRect
-                    (
-                        m_note_x, m_note_y, m_note_width, noteheight
-                    );
-                }
-                else
-                {
-                    QLinearGradient grad
-                    (
-                        m_note_x, m_note_y,
-                        m_note_x, m_note_y + noteheight
-                    );
-                    grad.setColorAt(0.05, fore_color());
-                    grad.setColorAt(0.5,  note_in_color());
-                    grad.setColorAt(0.95, fore_color());
-                    painter.fillRect
-                    (
-                        m_note_x + 1, m_note_y + 1, m_note_width - 1,
-                        noteheight - 1, grad
-                    );
-                }
+                QLinearGradient grad
+                (
+                    m_keypadding_x, m_note_y,
+                    m_keypadding_x, m_note_y + noteheight
+                );
+                grad.setColorAt(0.05, fore_color());
+                grad.setColorAt(0.5,  Qt::magenta);
+                grad.setColorAt(0.95, fore_color());
+                painter.fillRect
+                (
+                    m_keypadding_x, m_note_y,
+                    len + 1, noteheight + 1, grad
+                );
             }
-            if (m_link_wraparound && ! not_wrapped)
+            else
             {
-                int len = tix_to_pix(ni.finish()) - m_note_off_margin;
+                painter.setPen(error_pen);
+                painter.drawRect
+                (
+                    m_keypadding_x, m_note_y, len, noteheight
+                );
+                painter.setPen(pen);
+            }
+        }
+
+        /*
+         * Draw note highlight if there's room.  Orange note if selected,
+         * red if drum mode, otherwise plain white.
+         */
+
+        if (m_note_width > 3)
+        {
+            if (! background)
+            {
+                int x_shift = m_note_x + in_shift;
+                int h_minus = noteheight - 1;
                 if (use_gradient())
                 {
-                    QLinearGradient grad
-                    (
-                        m_keypadding_x, m_note_y,
-                        m_keypadding_x, m_note_y + noteheight
-                    );
-                    grad.setColorAt(0.05, fore_color());
-                    grad.setColorAt(0.5,  Qt::magenta);
-                    grad.setColorAt(0.95, fore_color());
-                    painter.fillRect
-                    (
-                        m_keypadding_x, m_note_y,
-                        len + 1, noteheight + 1, grad
-                    );
+                    if (ni.selected())
+                    {
+                        QLinearGradient grad
+                        (
+                            x_shift, m_note_y, m_note_x, m_note_y + h_minus
+                        );
+                        grad.setColorAt(0.01, fore_color());
+                        grad.setColorAt(0.5,  sel_color());
+                        grad.setColorAt(0.99, fore_color());
+                        painter.fillRect
+                        (
+                            x_shift, m_note_y,
+                            m_note_width + length_add - 1, h_minus, grad
+                        );
+                    }
                 }
                 else
                 {
-                    painter.setPen(error_pen);
-                    painter.drawRect
-                    (
-                        m_keypadding_x, m_note_y, len, noteheight
-                    );
-                    painter.setPen(pen);
-                }
-            }
+                    if (ni.selected())
+                        brush.setColor(sel_color());            /* "orange"  */
+                    else
+                        brush.setColor(note_in_color());        /* Qt::white */
 
-            /*
-             * Draw note highlight if there's room.  Orange note if selected,
-             * red if drum mode, otherwise plain white.
-             */
+                    if (bad)
+                        painter.setBrush(error_brush);
+                    else
+                        painter.setBrush(brush);
 
-            if (m_note_width > 3)
-            {
-                if (! background)
-                {
-                    int x_shift = m_note_x + in_shift;
-                    int h_minus = noteheight - 1;
-                    if (use_gradient())
+                    if (not_wrapped)                /* note highlight   */
                     {
-                        if (ni.selected())
-                        {
-                            QLinearGradient grad
-                            (
-                                x_shift, m_note_y, m_note_x, m_note_y + h_minus
-                            );
-                            grad.setColorAt(0.01, fore_color());
-                            grad.setColorAt(0.5,  sel_color());
-                            grad.setColorAt(0.99, fore_color());
-                            painter.fillRect
-                            (
-                                x_shift, m_note_y,
-                                m_note_width + length_add - 1, h_minus, grad
-                            );
-                        }
+                        painter.drawRect
+                        (
+                            x_shift, m_note_y,
+                            m_note_width + length_add - 1, h_minus
+                        );
                     }
                     else
                     {
-                        if (ni.selected())
-                            brush.setColor(sel_color());        /* "orange"  */
-                        else
-                            brush.setColor(note_in_color());    /* Qt::white */
-
-                        if (bad)
-                            painter.setBrush(error_brush);
-                        else
-                            painter.setBrush(brush);
-
-                        if (not_wrapped)                /* note highlight   */
-                        {
-                            painter.drawRect
-                            (
-                                x_shift, m_note_y,
-                                m_note_width + length_add - 1, h_minus
-                            );
-                        }
-                        else
-                        {
-                            int w = tix_to_pix(ni.finish()) + length_add - 3;
-                            painter.drawRect
-                            (
-                                x_shift, m_note_y, m_note_width, h_minus
-                            );
-                            painter.drawRect
-                            (
-                                m_keypadding_x, m_note_y, w, h_minus
-                            );
-                        }
+                        int w = tix_to_pix(ni.finish()) + length_add - 3;
+                        painter.drawRect
+                        (
+                            x_shift, m_note_y, m_note_width, h_minus
+                        );
+                        painter.drawRect
+                        (
+                            m_keypadding_x, m_note_y, w, h_minus
+                        );
                     }
                 }
             }
         }
     }
-    s->draw_unlock();
 }
 
 /*
@@ -966,21 +1091,18 @@ qseqroll::draw_drum_notes
     painter.setBrush(brush);
     m_edit_mode = perf().edit_mode(track().seq_number());
 
-    midipulse start_tick = pix_to_tix(r.x());
-    midipulse end_tick = start_tick + pix_to_tix(r.width());
-    sequence * b = perf().get_sequence(m_background_sequence).get();
-    sequence * s = background ? b : &track();
-    if (is_nullptr(s))
-        return;
+    const sequence::noteindex & nx = background ?
+        m_backseq_index : m_note_index ;
 
+    midipulse margin = pix_to_tix(unit_height() + m_keypadding_x);
+    midipulse start_tick = pix_to_tix(r.x()) - margin;
+    midipulse end_tick = pix_to_tix(r.x() + r.width()) + margin;
     int noteheight = unit_height();
-    for (auto cev = s->cbegin(); ! s->cend(cev); ++cev)
+    nx.visible(start_tick, end_tick, m_visible_notes);
+    for (int index : m_visible_notes)
     {
-        sequence::note_info ni;
-        sequence::draw dt = s->get_next_note(ni, cev);
-        if (dt == sequence::draw::finish)
-            break;
-
+        const sequence::note_info & ni = nx.info(index);
+        sequence::draw dt = nx.kind(index);
         if (dt == sequence::draw::tempo)
         {
 #if defined SEQ66_SHOW_TEMPO_IN_PIANO_ROLL
@@ -998,28 +1120,22 @@ qseqroll::draw_drum_notes
             continue;
         }
 
-        bool start_in = ni.start() >= start_tick && ni.start() <= end_tick;
-        bool end_in = ni.finish() >= start_tick && ni.finish() <= end_tick;
-        bool linkedin = dt == sequence::draw::linked && end_in;
-        if (start_in || linkedin)
-        {
-            m_note_x = xoffset(ni.start());
-            m_note_y = total_height() - ((ni.note() + 1) * noteheight);
+        m_note_x = xoffset(ni.start());
+        m_note_y = total_height() - ((ni.note() + 1) * noteheight);
 
-            /*
-             * Orange note if selected, red for drum mode.
-             */
+        /*
+         * Orange note if selected, red for drum mode.
+         */
 
-            if (ni.selected())
-                brush.setColor(sel_color());
-            else
-                brush.setColor(drum_paint());
+        if (ni.selected())
+            brush.setColor(sel_color());
+        else
+            brush.setColor(drum_paint());
 
-            pen.setColor(fore_color());
-            painter.setPen(pen);
-            painter.setBrush(brush);
-            draw_drum_note(painter, m_note_x, m_note_y);
-        }
+        pen.setColor(fore_color());
+        painter.setPen(pen);
+        painter.setBrush(brush);
+        draw_drum_note(painter, m_note_x, m_note_y);
     }
 }
 
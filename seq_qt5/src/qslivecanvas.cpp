@@ -0,0 +1,279 @@
+/*
+ *  This file is part of seq66.
+ *
+ *  seq66 is free software; you can redistribute it and/or modify it under the
+ *  terms of the GNU General Public License as published by the Free Software
+ *  Foundation; either version 2 of the License, or (at your option) any later
+ *  version.
+ *
+ *  seq66 is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with seq66; if not, write to the Free Software Foundation, Inc., 59 Temple
+ *  Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          qslivecanvas.cpp
+ *
+ *  This module defines the single widget that draws all of the slots of the
+ *  live grid.
+ *
+ * \library       seq66 application
+ * \author        agent
+ * \date          2026-10-16
+ * \updates       2026-10-16
+ * \license       GNU GPLv2 or above
+ *
+ *  A live grid of 8 x 8 busy patterns, as push-buttons, means 64 widgets
+ *  that each repaint their text, progress box, and notes on every frame.
+ *  Here the slots are drawn once into a pixmap, and each frame of playback
+ *  is one blit plus a line per slot.
+ */
+
+#include <algorithm>                    /* std::remove_if()                 */
+
+#include <QPainter>
+#include <QPaintEvent>
+
+#include "qslivecanvas.hpp"             /* seq66::qslivecanvas              */
+#include "qslotbutton.hpp"              /* seq66::qslotbutton drawing       */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq66
+{
+
+/**
+ *  Creates an empty canvas.  The slots are added by qslivegrid as it creates
+ *  their buttons.
+ *
+ * \param rows
+ *      The number of rows in the grid (set).
+ *
+ * \param columns
+ *      The number of columns in the grid (set).
+ *
+ * \param parent
+ *      The widget holding the grid layout.
+ */
+
+qslivecanvas::qslivecanvas (int rows, int columns, QWidget * parent) :
+    QWidget         (parent),
+    m_cells         (),
+    m_rows          (rows > 0 ? rows : 1),
+    m_columns       (columns > 0 ? columns : 1),
+    m_layers        (),
+    m_layers_valid  (false)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_OpaquePaintEvent);          /* we fill every pixel  */
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+/**
+ *  Changes the size of the grid, for when qslivegrid recreates its buttons
+ *  for a set of a different shape.
+ *
+ * \param rows
+ *      The number of rows in the grid (set).
+ *
+ * \param columns
+ *      The number of columns in the grid (set).
+ */
+
+void
+qslivecanvas::set_grid (int rows, int columns)
+{
+    m_rows = rows > 0 ? rows : 1;
+    m_columns = columns > 0 ? columns : 1;
+    layout_cells();
+    invalidate();
+}
+
+/**
+ *  Forgets the slots.  Must be called before qslivegrid deletes the
+ *  buttons.
+ */
+
+void
+qslivecanvas::clear ()
+{
+    m_cells.clear();
+    invalidate();
+}
+
+/**
+ *  Adds a slot.  The button is not shown; it only holds the state of the
+ *  slot and draws it.
+ */
+
+void
+qslivecanvas::add (qslotbutton * pb, int row, int column)
+{
+    if (not_nullptr(pb))
+    {
+        cell c;
+        c.c_button = pb;
+        c.c_row = row;
+        c.c_column = column;
+        m_cells.push_back(c);
+        layout_cells();
+        invalidate();
+    }
+}
+
+/**
+ *  Forgets one slot, when qslivegrid replaces its button.
+ */
+
+void
+qslivecanvas::remove (qslotbutton * pb)
+{
+    auto it = std::remove_if
+    (
+        m_cells.begin(), m_cells.end(),
+        [pb] (const cell & c) { return c.c_button == pb; }
+    );
+    if (it != m_cells.end())
+    {
+        m_cells.erase(it, m_cells.end());
+        invalidate();
+    }
+}
+
+/**
+ *  Forces the slots to be redrawn on the next paint, for a change in a
+ *  pattern, its status, or the set.
+ */
+
+void
+qslivecanvas::invalidate ()
+{
+    m_layers_valid = false;
+    update();
+}
+
+/**
+ *  Repaints only the progress boxes of the slots, which is a blit of the
+ *  cached slots plus the progress bars.
+ */
+
+void
+qslivecanvas::update_progress ()
+{
+    for (const auto & c : m_cells)
+    {
+        QRect r = c.c_button->progress_rect();
+        if (! r.isEmpty())
+            update(r.translated(c.c_rect.topLeft()));
+    }
+}
+
+/**
+ *  \return
+ *      Returns the bounding rectangle of the slots, relative to this canvas.
+ *      This is the area that the buttons would cover in the grid layout, and
+ *      is used for hit-testing the clicks.  Empty if there are no slots.
+ */
+
+QRect
+qslivecanvas::slots_rect () const
+{
+    QRect result;
+    for (const auto & c : m_cells)
+        result = result.united(c.c_rect);
+
+    return result;
+}
+
+/**
+ *  Centers each slot in its cell of the canvas, as the grid layout does for
+ *  the buttons.
+ */
+
+void
+qslivecanvas::layout_cells ()
+{
+    int cellw = width() / m_columns;
+    int cellh = height() / m_rows;
+    for (auto & c : m_cells)
+    {
+        int bw = c.c_button->width();
+        int bh = c.c_button->height();
+        int x = c.c_column * cellw + (cellw - bw) / 2;
+        int y = c.c_row * cellh + (cellh - bh) / 2;
+        c.c_rect = QRect(x, y, bw, bh);
+    }
+}
+
+/**
+ *  Draws every slot, without its progress bar, into m_layers.
+ */
+
+void
+qslivecanvas::draw_layers ()
+{
+    qreal ratio = devicePixelRatioF();
+    m_layers = QPixmap(size() * ratio);
+    m_layers.setDevicePixelRatio(ratio);
+    m_layers.fill(palette().color(backgroundRole()));
+
+    QPainter painter(&m_layers);
+    for (const auto & c : m_cells)
+    {
+        painter.resetTransform();
+        painter.translate(c.c_rect.topLeft());
+        c.c_button->draw_slot(painter);
+    }
+    m_layers_valid = true;
+}
+
+/**
+ *  Blits the cached slots for the exposed rectangle, and draws the progress
+ *  bars of the slots that it touches.
+ */
+
+void
+qslivecanvas::paintEvent (QPaintEvent * qpep)
+{
+    qreal ratio = devicePixelRatioF();
+    if (! m_layers_valid || m_layers.size() != size() * ratio)
+        draw_layers();
+
+    QRect r = qpep->rect();
+    QPainter painter(this);
+    QRectF source(QPointF(r.topLeft()) * ratio, QSizeF(r.size()) * ratio);
+    painter.drawPixmap(QRectF(r), m_layers, source);
+    for (const auto & c : m_cells)
+    {
+        if (c.c_rect.intersects(r))
+        {
+            painter.resetTransform();
+            painter.translate(c.c_rect.topLeft());
+            c.c_button->draw_slot_progress(painter);
+        }
+    }
+}
+
+void
+qslivecanvas::resizeEvent (QResizeEvent * qrep)
+{
+    layout_cells();
+    m_layers_valid = false;
+    QWidget::resizeEvent(qrep);
+}
+
+}           // namespace seq66
+
+/*
+ * qslivecanvas.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -70,7 +70,6 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QPaintEvent>
-#include <QTimer>
 
 #include "cfg/settings.hpp"             /* seq66::usr() config functions    */
 #include "ctrl/keystroke.hpp"           /* seq66::keystroke class           */
@@ -79,6 +78,7 @@
 #include "util/filefunctions.hpp"       /* seq66::get_full_path()           */
 #include "gui_palette_qt5.hpp"          /* seq66::gui_palette_qt5 class     */
 #include "qloopbutton.hpp"              /* seq66::qloopbutton (qslotbutton) */
+#include "qslivecanvas.hpp"             /* seq66::qslivecanvas, grid-canvas */
 #include "qslivegrid.hpp"               /* seq66::qslivegrid                */
 #include "qsmainwnd.hpp"                /* the true parent of this class    */
 #include "qt5_helpers.hpp"              /* seq66::qt_keystroke() etc.       */
@@ -148,10 +148,12 @@ qslivegrid::qslivegrid
     performer::callbacks    (p),
     ui                      (new Ui::qslivegrid),
     m_popup                 (nullptr),
-    m_timer                 (nullptr),
     m_msg_box               (nullptr),
+    m_perf_generation       (p.change_generation() - 1),
+    m_updates_paused        (false),
     m_redraw_buttons        (true),
     m_loop_buttons          (),
+    m_canvas                (nullptr),
     m_x_min                 (0),
     m_x_max                 (0),
     m_y_min                 (0),
@@ -246,7 +248,7 @@ qslivegrid::qslivegrid
         usr().progress_box_height()
     );
     perf().enregister(this);                                /* notification */
-    m_timer = qt_timer(this, "qslivegrid", 2, SLOT(conditional_update()));
+    (void) qt_refresh_connect(this, SLOT(conditional_update()));
 }
 
 /**
@@ -256,7 +258,7 @@ qslivegrid::qslivegrid
 
 qslivegrid::~qslivegrid()
 {
-    m_timer->stop();
+    m_updates_paused = true;
     clear_loop_buttons();               /* currently we use raw pointers    */
     perf().unregister(this);
     delete ui;
@@ -346,28 +348,50 @@ qslivegrid::set_playlist_name (const std::string & plname, bool modified)
 }
 
 /**
- *  In an effort to reduce CPU usage when simply idling, this function calls
- *  update() only if necessary.  See qlivebase::check_dirty(). All
- *  sequences are potentially checked.
- *
- *  Actually, we need a way to update only the loop slots in the grid layout,
- *  and only update the progress area.
+ *  Called once per frame by the refresh driver.  In an effort to reduce CPU
+ *  usage, the buttons are fully updated only if this grid was marked as
+ *  needing an update, or if the change generation of the performer moved
+ *  (a mute, a queue, an edit of a pattern, etc.).  Otherwise, during
+ *  playback, only the progress boxes of the buttons are repainted.
  */
 
 void
 qslivegrid::conditional_update ()
 {
-    if (m_loop_buttons.empty())
+    if (m_loop_buttons.empty() || m_updates_paused)
         return;
 
     sequence_key_check();
-    if (perf().needs_update() || check_needs_update())
+
+    bool changed = check_needs_update();
+    unsigned g = perf().change_generation();
+    if (g != m_perf_generation)
+    {
+        m_perf_generation = g;
+        changed = true;
+    }
+    if (changed)
     {
         show_grid_record_style();
         show_record_mode();
         show_grid_mode();
         update_state();
     }
+    else if (perf().is_running())
+    {
+        if (not_nullptr(m_canvas))
+        {
+            m_canvas->update_progress();
+        }
+        else
+        {
+            for (auto pb : m_loop_buttons)
+            {
+                if (not_nullptr(pb))
+                    pb->reupdate(false);        /* progress box only    */
+            }
+        }
+    }
 }
 
 /**
@@ -398,6 +422,21 @@ qslivegrid::create_loop_buttons ()
     for (int column = 0; column < columns(); ++column)
         ui->loopGridLayout->setColumnMinimumWidth(column, m_slot_w + spacing());
 
+    if (usr().grid_canvas())
+    {
+        if (is_nullptr(m_canvas))
+        {
+            m_canvas = new qslivecanvas(rows(), columns(), ui->frame);
+            m_canvas->show();
+        }
+        else
+        {
+            ui->loopGridLayout->removeWidget(m_canvas);     /* re-span it   */
+            m_canvas->set_grid(rows(), columns());
+        }
+        ui->loopGridLayout->addWidget(m_canvas, 0, 0, rows(), columns());
+    }
+
     int setsize = perf().screenset_size();
     int offset = seq_offset();
     for (int seqno = 0; seqno < setsize; ++seqno)
@@ -435,6 +474,9 @@ qslivegrid::create_loop_buttons ()
 void
 qslivegrid::clear_loop_buttons ()
 {
+    if (not_nullptr(m_canvas))
+        m_canvas->clear();                  /* before deleting the buttons  */
+
     if (! m_loop_buttons.empty())
     {
         int setsize = perf().screenset_size();
@@ -463,7 +505,8 @@ qslivegrid::measure_loop_buttons ()
         qslotbutton * pb = loop_button(seqno);
         if (not_nullptr(pb))
         {
-            QRect r = pb->geometry();
+            QRect r = pb->geometry();       /* relative to ui->frame    */
+            r.moveTopLeft(pb->mapTo(this, QPoint(0, 0)));
             if (m_slot_w == 0)
             {
                 m_slot_w = r.width();       /* all buttons same size    */
@@ -507,13 +550,33 @@ qslivegrid::measure_loop_buttons ()
 bool
 qslivegrid::get_slot_coordinate (int x, int y, int & row, int & column)
 {
-    bool result = m_x_max > 0;
+    if (not_nullptr(m_canvas))
+    {
+        /*
+         * The click is relative to this grid, but the slots are relative to
+         * the canvas, which the layout places in ui->frame.  Use the bounds
+         * of the slots, as measure_loop_buttons() does for the buttons, so
+         * that both modes hit-test the same way.
+         */
+
+        QRect r = m_canvas->slots_rect();
+        r.moveTopLeft(m_canvas->mapTo(this, r.topLeft()));
+        m_x_min = r.x();
+        m_x_max = r.x() + r.width();
+        m_y_min = r.y();
+        m_y_max = r.y() + r.height();
+    }
+
+    bool result = m_x_max > m_x_min && m_y_max > m_y_min;
     if (result)
     {
-        int xslotsize = (m_x_max - m_x_min) / columns();
-        int yslotsize = (m_y_max - m_y_min) / rows();
-        row = (y - m_y_min) / yslotsize;
-        column = (x - m_x_min) / xslotsize;
+        /*
+         * Scale rather than divide by a truncated slot size, which drifts
+         * by up to a pixel per slot and misplaces clicks near the far edge.
+         */
+
+        row = (y - m_y_min) * rows() / (m_y_max - m_y_min);
+        column = (x - m_x_min) * columns() / (m_x_max - m_x_min);
     }
     else
         row = column = 0;
@@ -549,11 +612,21 @@ qslivegrid::create_one_button (seq::number seqno)
         else
             result = new qslotbutton(this, seqno, snstring, hotkey);
 
-        ui->loopGridLayout->addWidget(result, row, column);
         result->setFixedSize(btnsize);
-        result->show();
-        result->setEnabled(enabled);
-        setup_button(result);
+        if (not_nullptr(m_canvas))
+        {
+            result->hide();                     /* drawn by the canvas      */
+            result->setEnabled(enabled);
+            setup_button(result);
+            m_canvas->add(result, row, column);
+        }
+        else
+        {
+            ui->loopGridLayout->addWidget(result, row, column);
+            result->show();
+            result->setEnabled(enabled);
+            setup_button(result);
+        }
     }
     return result;
 }
@@ -678,9 +751,16 @@ qslivegrid::delete_slot (int row, int column)
     bool result = not_nullptr(pb);
     if (result)
     {
-        QLayoutItem * item = ui->loopGridLayout->itemAtPosition(row, column);
-        if (not_nullptr(item))
-            ui->loopGridLayout->removeWidget(item->widget());
+        if (not_nullptr(m_canvas))              /* the canvas spans all     */
+        {
+            m_canvas->remove(pb);
+        }
+        else
+        {
+            QLayoutItem * item = ui->loopGridLayout->itemAtPosition(row, column);
+            if (not_nullptr(item))
+                ui->loopGridLayout->removeWidget(item->widget());
+        }
     }
     return result;
 }
@@ -772,6 +852,7 @@ qslivegrid::refresh_all_slots ()
             }
             ++offset;
         }
+        update_canvas();
     }
     return result;
 }
@@ -782,7 +863,8 @@ qslivegrid::modify_slot (qslotbutton * newslot, int row, int column)
     bool result = delete_slot(row, column);
     if (result)
     {
-        ui->loopGridLayout->addWidget(newslot, row, column);
+        if (is_nullptr(m_canvas))               /* else already added       */
+            ui->loopGridLayout->addWidget(newslot, row, column);
 
         int index = perf().grid_to_index(row, column);
         m_loop_buttons[index] = newslot;
@@ -791,26 +873,28 @@ qslivegrid::modify_slot (qslotbutton * newslot, int row, int column)
 }
 
 /**
- *  We have found we need to pause the timer when switching banks while
+ *  We have found we need to pause the updates when switching banks while
  *  playing, otherwise there is a high probability of a seqfault, due to
  *  updating the user-interface (which deletes and rebuilts the slot buttons).
+ *  The refresh driver is shared, so it is not stopped; conditional_update()
+ *  checks m_updates_paused instead.
  */
 
 void
 qslivegrid::update_bank (int bankid)
 {
-    m_timer->stop();
+    m_updates_paused = true;
     qslivebase::update_bank(bankid);
     (void) recreate_all_slots();        /* sets m_redraw_buttons to true    */
-    m_timer->start();
+    m_updates_paused = false;
 }
 
 void
 qslivegrid::update_bank ()
 {
-    m_timer->stop();
+    m_updates_paused = true;
     (void) recreate_all_slots();        /* sets m_redraw_buttons to true    */
-    m_timer->start();
+    m_updates_paused = false;
 }
 
 /**
@@ -853,6 +937,8 @@ qslivegrid::update_sequence (seq::number seqno, bool redo)
             qslotbutton * pb = button(row, column);
             if (not_nullptr(pb))
                 pb->reupdate(true);
+
+            update_canvas();
         }
     }
 }
@@ -1074,7 +1160,10 @@ qslivegrid::button_toggle_enabled (seq::number seqno)
         {
             seq::pointer s = pb->loop();
             if (s)
+            {
                 (void) pb->toggle_enabled();
+                update_canvas();
+            }
         }
     }
 }
@@ -1289,6 +1378,7 @@ qslivegrid::reupdate ()
         else
             break;
     }
+    update_canvas();
 }
 
 void
@@ -1308,6 +1398,19 @@ qslivegrid::update_state ()
                 pb->reupdate(false);
         }
     }
+    update_canvas();
+}
+
+/**
+ *  With the "grid-canvas" option, the buttons are not shown, so their
+ *  reupdate() calls do nothing; instead the canvas redraws them all.
+ */
+
+void
+qslivegrid::update_canvas ()
+{
+    if (not_nullptr(m_canvas))
+        m_canvas->invalidate();
 }
 
 void
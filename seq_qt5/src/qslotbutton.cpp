@@ -42,6 +42,8 @@
  */
 
 #include <QPainter>
+#include <QStyle>
+#include <QStyleOptionButton>
 
 #include "cfg/settings.hpp"             /* seq66::usr() config functions    */
 #include "qslotbutton.hpp"              /* seq66::qslotbutton base class    */
@@ -117,6 +119,35 @@ qslotbutton::setup ()
     setText(qt(snstring));
 }
 
+/**
+ *  Draws the bare button as QPushButton::paintEvent() does, but with the
+ *  given painter, so that the slot can be drawn on the canvas of the live
+ *  grid without the button being shown.  The painter must be translated to
+ *  the top-left corner of the slot.
+ */
+
+void
+qslotbutton::draw_button (QPainter & painter)
+{
+    QStyleOptionButton option;
+    initStyleOption(&option);
+    if (autoFillBackground())
+        painter.fillRect(rect(), palette().brush(backgroundRole()));
+
+    style()->drawControl(QStyle::CE_PushButton, &option, &painter, this);
+}
+
+/**
+ *  Draws the whole slot onto the canvas of the live grid.  An empty slot is
+ *  just a button with its slot number.
+ */
+
+void
+qslotbutton::draw_slot (QPainter & painter)
+{
+    draw_button(painter);
+}
+
 }           // namespace seq66
 
 /*
@@ -68,7 +68,6 @@
 #include <QMessageBox>                  /* QMessageBox                      */
 #include <QResizeEvent>                 /* QResizeEvent                     */
 #include <QScreen>                      /* Qscreen                          */
-#include <QTimer>                       /* QTimer                           */
 
 #undef USE_QDESKTOPSERVICES
 #if defined USE_QDESKTOPSERVICES
@@ -234,7 +233,6 @@ qsmainwnd::qsmainwnd
     m_playlist_frame        (nullptr),
     m_msg_error             (nullptr),
     m_msg_save_changes      (nullptr),
-    m_timer                 (nullptr),
     m_menu_recent           (nullptr),          /* QMenu *                  */
     m_recent_action_list    (),                 /* QList<QAction *>         */
     m_beat_ind              (nullptr),
@@ -892,7 +890,8 @@ qsmainwnd::qsmainwnd
     show_song_mode(m_song_mode);
     (void) refresh_captions();
     cb_perf().enregister(this);
-    m_timer = qt_timer(this, "qsmainwnd", 3, SLOT(conditional_update()));
+    (void) qt_refresh_connect(this, SLOT(deliver_notifications()));
+    (void) qt_refresh_connect(this, SLOT(conditional_update()));
 }
 
 /**
@@ -912,7 +911,6 @@ qsmainwnd::~qsmainwnd ()
      *      delete m_msg_save_changes;
      */
 
-    m_timer->stop();
     cb_perf().unregister(this);
     delete ui;
 }
@@ -1745,6 +1743,18 @@ qsmainwnd::remove_set_master ()
     }
 }
 
+/**
+ *  Delivers, once per frame of the refresh driver, the performer
+ *  notifications raised by the output and input threads, so that the
+ *  callbacks of all the windows run in the GUI thread.
+ */
+
+void
+qsmainwnd::deliver_notifications ()
+{
+    (void) cb_perf().deliver_notifications();
+}
+
 /**
  *  The debug statement shows us that the main-window size starts at
  *  920 x 680, goes to 800 x 480 (unscaled) briefly, and then back to
@@ -1756,7 +1766,7 @@ qsmainwnd::conditional_update ()
 {
     if (session_close())
     {
-        m_timer->stop();
+        (void) qt_refresh_disconnect(this, SLOT(conditional_update()));
         close();
         return;
     }
@@ -1768,7 +1778,11 @@ qsmainwnd::conditional_update ()
     b += std::to_string(active_screenset);
     b += " / ";
     b += std::to_string(cb_perf().screenset_count());
-    ui->entry_active_set->setText(qt(b));
+
+    QString activeset = qt(b);
+    if (ui->entry_active_set->text() != activeset)
+        ui->entry_active_set->setText(activeset);
+
     if (ui->button_keep_queue->isChecked() != cb_perf().is_keep_queue())
         ui->button_keep_queue->setChecked(cb_perf().is_keep_queue());
 
@@ -1810,11 +1824,12 @@ qsmainwnd::conditional_update ()
             long delta = cb_perf().delta_us();
             if (delta != 0)
             {
-                std::string dus = std::to_string(int(delta));
-                ui->txtUnderrun->setText(qt(dus));
+                QString dus = qt(std::to_string(int(delta)));
+                if (ui->txtUnderrun->text() != dus)
+                    ui->txtUnderrun->setText(dus);
             }
         }
-        else
+        else if (ui->txtUnderrun->text() != "-")
             ui->txtUnderrun->setText("-");
     }
     if (cb_perf().tap_bpm_timeout())
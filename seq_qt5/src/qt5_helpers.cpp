@@ -36,6 +36,8 @@
  *      -   qt().  Converts an std::sring to a QString.
  *      -   qt_timer(). Encapsulates creating and starting a timer, with a
  *          callback given by a Qt slot-name.
+ *      -   qt_refresh_connect(). Connects a slot to the one timer that
+ *          paces the repainting of the live views.
  *      -   enable_combobox_item(). Handles the appearance of a combo box.
  *      -   fill_combobox(). Fills a combo box from a combolist.
  *      -   create_menu_action(). Creates a menu action from text and an icon.
@@ -51,11 +53,13 @@
 #include <QComboBox>
 #include <QErrorMessage>
 #include <QFileDialog>                  /* prompt for full MIDI file's path */
+#include <QGuiApplication>              /* QGuiApplication::primaryScreen() */
 #include <QIcon>
 #include <QKeyEvent>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QScreen>                      /* QScreen::refreshRate()           */
 #include <QScrollBar>
 #include <QStandardItemModel>
 #include <QTimer>
@@ -303,6 +307,99 @@ qt_timer
     return result;
 }
 
+/**
+ *  Provides the one timer that drives the repainting of the live views (the
+ *  grid, the song editor, the pattern editor, and the main window).  Rather
+ *  than each view polling on its own timer, at its own phase, they all
+ *  check their change generations on the same tick, so that a frame is
+ *  painted at once, and the application wakes up once per frame instead of
+ *  once per view.
+ *
+ *  The interval is the "redraw rate" of the 'usr' file, rounded up to a
+ *  whole number of refresh periods of the primary screen, so that the
+ *  frames are paced to the display.  The timer is never stopped; a view
+ *  that wants no updates disconnects from it, or ignores the tick.
+ *
+ * \return
+ *      Returns the timer, created and started on the first call.  It is owned
+ *      by the application object.
+ */
+
+static QTimer *
+qt_refresh_driver ()
+{
+    static QTimer * s_driver = nullptr;
+    if (is_nullptr(s_driver))
+    {
+        s_driver = new QTimer(QCoreApplication::instance());
+        if (not_nullptr(s_driver))
+        {
+            int interval = usr().window_redraw_rate();
+            const QScreen * screen = QGuiApplication::primaryScreen();
+            if (not_nullptr(screen) && screen->refreshRate() > 1.0)
+            {
+                int frame = int(1000.0 / screen->refreshRate());
+                if (frame > 0)
+                    interval = frame * ((interval + frame - 1) / frame);
+            }
+            if (interval < 1)
+                interval = 1;
+
+            s_driver->setTimerType(Qt::PreciseTimer);
+            s_driver->setInterval(interval);
+            s_driver->start();
+        }
+        else
+            error_message("Could not create refresh driver");
+    }
+    return s_driver;
+}
+
+/**
+ *  Connects a slot to the refresh driver, to be called once per frame.  The
+ *  connection is broken by Qt when the object is destroyed.
+ *
+ * \param self
+ *      The object owning the slot, normally a view.
+ *
+ * \param slotname
+ *      The slot, given via the SLOT() macro, normally conditional_update().
+ *
+ * \return
+ *      Returns true if the connection was made.
+ */
+
+bool
+qt_refresh_connect (QObject * self, const char * slotname)
+{
+    bool result = false;
+    QTimer * driver = qt_refresh_driver();
+    if (not_nullptr(driver))
+    {
+        QMetaObject::Connection c =
+            QObject::connect(driver, SIGNAL(timeout()), self, slotname);
+
+        result = bool(c);
+        if (! result)
+            error_message("Refresh connection invalid");
+    }
+    return result;
+}
+
+/**
+ *  Stops calling a slot from the refresh driver, without waiting for the
+ *  object to be destroyed.
+ */
+
+bool
+qt_refresh_disconnect (QObject * self, const char * slotname)
+{
+    QTimer * driver = qt_refresh_driver();
+    return not_nullptr(driver) ?
+        QObject::disconnect(driver, SIGNAL(timeout()), self, slotname) :
+        false ;
+}
+
 /**
  *  Helper for handling enabled/disabled items in a combo-box
  */
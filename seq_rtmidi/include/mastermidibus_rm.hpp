@@ -111,6 +111,11 @@ protected:
         midi_master().api_flush();
     }
 
+    virtual void api_wake_input () override
+    {
+        midi_master().api_wake_input();
+    }
+
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port)
     {
         midi_master().api_port_start(masterbus, bus, port);
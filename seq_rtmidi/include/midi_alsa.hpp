@@ -37,6 +37,7 @@
 
 #include "seq66-config.h"
 #include "midi_api.hpp"
+#include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
 
 #if SEQ66_HAVE_LIBASOUND
 #include <alsa/asoundlib.h>
@@ -63,6 +64,23 @@ class midi_alsa : public midi_api
 
 private:
 
+    /**
+     *  Scheduled output.  When the 'rc' [alsa-output] lookahead-ms is
+     *  non-zero, each event is scheduled on the (running) ALSA queue, with
+     *  a relative real-time stamp, to be delivered by the kernel at its due
+     *  time.  The due time is calculated from an anchor, a (pulse,
+     *  microsecond) pair shared by all output ports, in the same
+     *  CLOCK_MONOTONIC domain as the performer's output thread.  See
+     *  lookahead_delay().
+     */
+
+    static long sm_lookahead_us;                /* 0 means direct output    */
+    static double sm_us_per_pulse;              /* from PPQN and BPM        */
+    static long sm_anchor_us;                   /* due time of anchor pulse */
+    static midipulse sm_anchor_pulse;           /* null until first event   */
+    static midipulse sm_last_pulse;             /* for tempo-change rebase  */
+    static recmutex sm_anchor_mutex;            /* output and GUI threads   */
+
     /**
      *  ALSA sequencer client handle.
      */
@@ -103,6 +121,14 @@ private:
 
     const std::string m_port_name;
 
+    /**
+     *  A MIDI encoder kept for the life of the port, instead of one created
+     *  and freed for every event played.  Used only for messages that
+     *  api_play() does not fill in directly.
+     */
+
+    snd_midi_event_t * m_encoder;
+
 public:
 
     /*
@@ -129,6 +155,15 @@ public:
         return m_dest_addr_port;
     }
 
+    static void lookahead_setup (int ms);
+    static void lookahead_tempo (int ppqn, midibpm bpm);
+    static void lookahead_reset ();
+
+    static bool scheduled ()
+    {
+        return sm_lookahead_us > 0;
+    }
+
 protected:
 
     virtual bool api_init_out () override;
@@ -170,6 +205,8 @@ protected:
 private:
 
     bool set_virtual_name (int portid, const std::string & portname);
+    void schedule (snd_seq_event_t & ev, midipulse tick);
+    static long lookahead_delay (midipulse p);
 
 };          // class midi_alsa
 
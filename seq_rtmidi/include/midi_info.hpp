@@ -278,6 +278,56 @@ public:
 
 };          // class midi_port_info
 
+/**
+ *  Provides a file descriptor that the input thread can poll() along with
+ *  any descriptors of the MIDI API.  It is signalled when input is queued
+ *  by a callback that has no descriptor of its own (JACK), and when the
+ *  input thread must wake up to exit.  On Linux it is an eventfd, elsewhere
+ *  it is a self-pipe.  The signal stays raised until cleared, so a signal
+ *  that arrives between a check of the queues and the wait is not lost.
+ */
+
+class midi_input_signal
+{
+
+private:
+
+    /**
+     *  The descriptor to poll.  For an eventfd, it is also the descriptor
+     *  that is written.
+     */
+
+    int m_read_fd;
+
+    /**
+     *  The descriptor written by signal().
+     */
+
+    int m_write_fd;
+
+public:
+
+    midi_input_signal ();
+    midi_input_signal (const midi_input_signal &) = delete;
+    midi_input_signal & operator = (const midi_input_signal &) = delete;
+    ~midi_input_signal ();
+
+    int fd () const
+    {
+        return m_read_fd;
+    }
+
+    bool valid () const
+    {
+        return m_read_fd >= 0;
+    }
+
+    void signal ();
+    void clear ();
+    bool wait (int ms);
+
+};          // class midi_input_signal
+
 /**
  *  The class for holding basic information on the MIDI input and output ports
  *  currently present in the system.
@@ -382,6 +432,13 @@ private:
 
     bool m_midi_port_refresh;
 
+    /**
+     *  Wakes the input thread when MIDI input is queued by a callback, or
+     *  when the application is exiting.  See api_poll_for_midi().
+     */
+
+    midi_input_signal m_input_signal;
+
 protected:
 
     /**
@@ -472,6 +529,21 @@ public:
         return m_midi_port_refresh;
     }
 
+    midi_input_signal & input_signal ()
+    {
+        return m_input_signal;
+    }
+
+    /**
+     *  Wakes up an input thread that is waiting in api_poll_for_midi().
+     *  Safe to call from any thread.
+     */
+
+    void api_wake_input ()
+    {
+        m_input_signal.signal();
+    }
+
     /**
      *  No need to override this one, though it is virtual.
      */
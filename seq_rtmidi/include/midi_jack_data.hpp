@@ -36,6 +36,7 @@
 #include "util/basic_macros.h"          /* nullptr and other macros         */
 #include "midi/midibytes.hpp"           /* seq66::midibyte, other aliases   */
 #include "rtmidi_types.hpp"             /* seq66::rtmidi_in_data class      */
+#include "util/automutex.hpp"           /* seq66::recmutex, automutex       */
 
 #if defined SEQ66_JACK_SUPPORT
 
@@ -54,6 +55,8 @@
 namespace seq66
 {
 
+class midi_input_signal;
+
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
  *  This guy needs a constructor taking parameters for an rtmidi_in_data
@@ -79,6 +82,34 @@ class midi_jack_data
     static double sm_jack_frame_factor;         /* frames per PPQN tick     */
     static bool sm_use_offset;                  /* requires JACK transport  */
 
+    /**
+     *  Lookahead rendering.  When enabled ('rc' jack-lookahead), each output
+     *  message is stamped with the JACK frame at which it is due, a fixed
+     *  number of frames in the future, and the output process callback
+     *  holds it until the cycle containing that frame.  The due frame is
+     *  calculated from an anchor, a (pulse, frame) pair shared by all
+     *  output ports so that they stay aligned.  The anchor is re-seated if
+     *  the performer and JACK drift too far apart, and re-based at each
+     *  tempo change.
+     */
+
+    static jack_nframes_t sm_lookahead_frames;  /* 0 disables the lookahead */
+    static jack_nframes_t sm_lookahead_rate;    /* frame rate at activation */
+    static double sm_pulses_per_second;         /* from PPQN and BPM        */
+    static double sm_frames_per_pulse;          /* from PPQN, BPM, and rate */
+    static jack_nframes_t sm_anchor_frame;      /* due frame of anchor tick */
+    static midipulse sm_anchor_pulse;           /* null until first message */
+    static midipulse sm_last_pulse;             /* for tempo-change rebase  */
+    static recmutex sm_anchor_mutex;            /* output and GUI threads   */
+
+    /**
+     *  The signal raised by the input process callback when it queues MIDI
+     *  input, so that the input thread can block instead of polling the
+     *  queues.  Owned by the midi_jack_info object, which sets it.
+     */
+
+    static midi_input_signal * sm_input_signal;
+
     /**
      *  Holds the JACK sequencer client pointer so that it can be used by the
      *  midibus objects.  This is actually an opaque pointer; there is no way
@@ -107,7 +138,7 @@ class midi_jack_data
      */
 
 #if defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
-    ring_buffer<midi_message> * m_jack_buffer;
+    midi_ring * m_jack_buffer;
 #else
     jack_ringbuffer_t * m_jack_buffmessage;
 #endif
@@ -133,7 +164,7 @@ class midi_jack_data
 
     /**
      *  Holds special data peculiar to the client and its MIDI input
-     *  processing. This data consists of the midi_queue message queue and a
+     *  processing. This data consists of the midi_ring message queue and a
      *  few boolean flags.
      */
 
@@ -168,6 +199,15 @@ public:
     );
 #endif
     static jack_nframes_t frame_estimate (midipulse p);
+    static void lookahead_setup
+    (
+        jack_nframes_t rate,
+        jack_nframes_t F,
+        int periods
+    );
+    static void lookahead_tempo (int ppqn, midibpm bpm);
+    static void lookahead_reset ();
+    static jack_nframes_t lookahead_frame (jack_nframes_t now, midipulse p);
     static void cycle_frame
     (
         midipulse p, jack_nframes_t & cycle, jack_nframes_t & offset
@@ -175,6 +215,16 @@ public:
     static double cycle (jack_nframes_t f, jack_nframes_t F);
     static double pulse_cycle (midipulse p, jack_nframes_t F);
 
+    static void input_signal (midi_input_signal * sig)
+    {
+        sm_input_signal = sig;
+    }
+
+    static midi_input_signal * input_signal ()
+    {
+        return sm_input_signal;
+    }
+
     static double frame (midipulse p)
     {
         return double(p) * frame_factor();
@@ -210,6 +260,11 @@ public:
         return sm_use_offset;
     }
 
+    static bool lookahead ()
+    {
+        return sm_lookahead_frames > 0;
+    }
+
     static jack_nframes_t cycle_frame_count ()
     {
         return sm_cycle_frame_count;
@@ -332,12 +387,12 @@ public:
         return not_nullptr(m_jack_buffer);
     }
 
-    ring_buffer<midi_message> * jack_buffer ()
+    midi_ring * jack_buffer ()
     {
         return m_jack_buffer;
     }
 
-    void jack_buffer (ring_buffer<midi_message> * rb)
+    void jack_buffer (midi_ring * rb)
     {
         m_jack_buffer = rb;
     }
@@ -307,6 +307,12 @@ public:
         return get_api_info()->api_poll_for_midi();
     }
 
+    void api_wake_input ()
+    {
+        if (not_nullptr(get_api_info()))
+            get_api_info()->api_wake_input();
+    }
+
     static rtmidi_api & selected_api ()
     {
         return sm_selected_api;
@@ -40,6 +40,7 @@
 
 #include "midi/event.hpp"                   /* seq66::event namespace       */
 #include "midi/midibytes.hpp"               /* seq66::midibyte alias        */
+#include "util/ring_buffer.hpp"             /* seq66::ring_buffer<> SPSC    */
 
 /**
  * This was the version of the RtMidi library from which this reimplementation
@@ -63,6 +64,20 @@ namespace seq66
 
 const int c_default_queue_size  = 100;
 
+/**
+ *  The number of bytes stored inline in a midi_message or a midi_ring slot.
+ *  Every channel message and every real-time message fits.  Longer
+ *  messages (SysEx) are stored elsewhere.
+ */
+
+const int c_midi_message_inline = 3;
+
+/**
+ *  Default size of the midi_ring spill area for SysEx bytes.
+ */
+
+const int c_default_spill_size  = 8192;
+
 /**
  *    MIDI API specifier arguments.  These items used to be nested in
  *    the rtmidi class, but that only worked when RtMidi.cpp/h were
@@ -131,6 +146,10 @@ api_to_int (rtmidi_api api)
  *      -#  Event: Access the status and data bytes as a unit to pass them
  *          to the JACK engine for transmitting.
  *
+ *  Messages of up to c_midi_message_inline bytes are stored inline, so that
+ *  creating, copying, and pushing them never touches the heap.  Only a
+ *  longer message (SysEx) moves its bytes to a vector.
+ *
  *  Please note that the ALSA module in seq66's rtmidi infrastructure
  *  uses the seq66::event rather than the seq66::midi_message object.
  *  For the moment, we will translate between them until we have the
@@ -143,7 +162,7 @@ class midi_message
 public:
 
     /**
-     *  Holds the data of the MIDI message.  Callers should use
+     *  Holds the data of a long MIDI message.  Callers should use
      *  midi_message::container rather than using the vector directly.
      *  Bytes are added by the push() function, and are safely accessed
      *  (with bounds-checking) by operator [].
@@ -171,11 +190,24 @@ private:
 #endif
 
     /**
-     *  Holds the event status and data bytes.
+     *  Holds the event status and data bytes of a short message.
+     */
+
+    midibyte m_inline[c_midi_message_inline];
+
+    /**
+     *  Holds the bytes of a message longer than c_midi_message_inline.
+     *  Unused (and not necessarily empty) otherwise.
      */
 
     container m_bytes;
 
+    /**
+     *  The number of bytes in the message.
+     */
+
+    int m_count;
+
     /**
      *  Holds the timestamp of the MIDI message. Non-zero only in the JACK
      *  implementation at present.  It can also hold a JACK frame number. The
@@ -195,23 +227,23 @@ public:
     midibyte & operator [] (std::size_t i)
     {
         static midibyte s_zero = 0;
-        return (i < m_bytes.size()) ? m_bytes[i] : s_zero ;
+        return (i < std::size_t(m_count)) ? bytes()[i] : s_zero ;
     }
 
     const midibyte & operator [] (std::size_t i) const
     {
         static midibyte s_zero = 0;
-        return (i < m_bytes.size()) ? m_bytes[i] : s_zero ;
+        return (i < std::size_t(m_count)) ? event_bytes()[i] : s_zero ;
     }
 
     const char * buffer () const                // was "array"
     {
-        return reinterpret_cast<const char *>(&m_bytes[0]);
+        return reinterpret_cast<const char *>(event_bytes());
     }
 
     const midibyte * event_bytes () const       // bypasses timestamp
     {
-        return m_bytes.data();
+        return is_inline() ? &m_inline[0] : m_bytes.data() ;
     }
 
 #if defined SEQ66_PLATFORM_DEBUG
@@ -228,14 +260,22 @@ public:
 
     int event_count () const                    // was "count"
     {
-        return int(m_bytes.size());
+        return m_count;
+    }
+
+    bool is_inline () const
+    {
+        return m_count <= c_midi_message_inline;
     }
 
-    void push (midibyte b)
+    void clear ()
     {
-        m_bytes.push_back(b);
+        m_count = 0;
     }
 
+    void push (midibyte b);
+    void assign (const midibyte * mbs, std::size_t sz);
+
     midipulse timestamp () const
     {
         return m_timestamp;
@@ -248,18 +288,23 @@ public:
 
     midibyte status () const
     {
-        return event_count() > 0 ? m_bytes[0] : 0 ;
+        return event_count() > 0 ? event_bytes()[0] : 0 ;
     }
 
     bool is_sysex () const
     {
-        return m_bytes.size() > 0 ? event::is_sysex_msg(m_bytes[0]) : false ;
+        return event_count() > 0 ? event::is_sysex_msg(status()) : false ;
     }
 
     std::string to_string () const;
 
 private:
 
+    midibyte * bytes ()
+    {
+        return is_inline() ? &m_inline[0] : m_bytes.data() ;
+    }
+
 };          // class midi_message
 
 /**
@@ -276,54 +321,103 @@ using rtmidi_callback_t = void (*)
 );
 
 /**
- *  Provides a queue of midi_message structures.  This entity used to be a
- *  plain structure nested in the midi_in_api class.  We made it a class to
- *  encapsulate some common operations to save a burden on the callers.
+ *  Provides a wait-free single-producer/single-consumer queue of MIDI
+ *  messages, safe to use from a JACK process callback on either side.  It
+ *  replaces both the old midi_queue (input) and the ring_buffer of
+ *  midi_message objects (output), which copied a std::vector for every
+ *  message.
+ *
+ *  Each message occupies a fixed-size slot holding the timestamp, the byte
+ *  count, and up to c_midi_message_inline bytes.  A longer message (SysEx)
+ *  puts its bytes in a separate, preallocated spill ring; the producer
+ *  writes the spill bytes before publishing the slot, and the consumer
+ *  skips them when popping the slot, so the two rings stay in step.
+ *  Nothing is allocated after construction.
  */
 
-class midi_queue
+class midi_ring
 {
 
 private:
 
-    unsigned m_front;
-    unsigned m_back;
-    unsigned m_size;
-    unsigned m_ring_size;
-    midi_message * m_ring;
+    /**
+     *  One message.  Trivially copyable, so a push is a few stores.
+     */
+
+    struct slot
+    {
+        midipulse m_timestamp;
+        int m_count;
+        midibyte m_bytes[c_midi_message_inline];
+    };
+
+    ring_buffer<slot> m_slots;
+    ring_buffer<midibyte> m_spill;
 
 public:
 
-    midi_queue ();
-    ~midi_queue ();
+    midi_ring
+    (
+        std::size_t slotcount = c_default_queue_size,
+        std::size_t spillsize = c_default_spill_size
+    );
 
     bool empty () const
     {
-        return m_size == 0;
+        return m_slots.empty();
     }
 
     int count () const
     {
-        return int(m_size);
+        return m_slots.count();
+    }
+
+    int count_max () const
+    {
+        return m_slots.count_max();
+    }
+
+    int buffer_size () const
+    {
+        return m_slots.buffer_size();
+    }
+
+    int dropped () const
+    {
+        return m_slots.dropped() + m_spill.dropped();
+    }
+
+    /*
+     *  Producer side.
+     */
+
+    bool push (const midibyte * mbs, std::size_t sz, midipulse ts);
+
+    bool push (const midi_message & msg)
+    {
+        return push(msg.event_bytes(), msg.event_count(), msg.timestamp());
     }
 
-    bool full () const
+    /*
+     *  Consumer side.  The front_*() functions are valid only if the ring
+     *  is not empty().
+     */
+
+    midipulse front_timestamp () const
     {
-        return m_size == m_ring_size;
+        return m_slots.front().m_timestamp;
     }
 
-    const midi_message & front () const
+    std::size_t front_count () const
     {
-        return m_ring[m_front];
+        return std::size_t(m_slots.front().m_count);
     }
 
-    bool add (const midi_message & mmsg);
-    void pop ();
-    midi_message pop_front ();
-    void allocate (unsigned queuesize = c_default_queue_size);
-    void deallocate ();
+    std::size_t front_bytes (midibyte * dest, std::size_t destsz) const;
+    void pop_front ();
+    bool pop_front (midi_message & msg);
 
-};          // class midi_queue
+};          // class midi_ring
 
 /**
  *  The rtmidi_in_data structure is used to pass private class data to the
@@ -338,10 +432,11 @@ private:
 
     /**
      *  Provides a queue of MIDI messages. Used when not using a JACK callback
-     *  for MIDI input.
+     *  for MIDI input.  Filled by the JACK process callback, emptied by the
+     *  input thread.
      */
 
-    midi_queue m_queue;
+    midi_ring m_queue;
 
     /**
      *  A one-time flag that starts out true and is falsified when the first
@@ -361,12 +456,12 @@ public:
 
     rtmidi_in_data ();
 
-    const midi_queue & queue () const
+    const midi_ring & queue () const
     {
         return m_queue;
     }
 
-    midi_queue & queue ()
+    midi_ring & queue ()
     {
         return m_queue;
     }
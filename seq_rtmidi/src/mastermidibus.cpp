@@ -242,26 +242,32 @@ mastermidibus::activate ()
 }
 
 /**
- *  Initiate a poll() on the existing poll descriptors.  This is a
- *  primitive poll, which exits when some data is obtained, or sleeps a
- *  millisecond in note data is obtained.
+ *  Waits for MIDI input.  The input thread blocks here, in the kernel, until
+ *  input arrives or midi_info::api_wake_input() is called, instead of
+ *  sleeping and polling.
  *
- *  For JACK polling, call the base-class implementation:
+ *  For JACK, the input is queued per port by the process callback, which
+ *  then raises the input signal.  So we first check the port queues:
  *
- *      -   mastermidibase::api_poll_for_midi()
+ *      -   mastermidibase::m_inbus_array.poll_for_midi()
  *      -   busarray::poll_for_midi()
  *      -   businfo::poll_for_midi()
  *      -   midibus::poll_for_midi() [midibase::poll_for_midi()]
  *      -   midibase::api_poll_for_midi(), a virtual function overridden
  *          for JACK (and ALSA).
  *
+ *  If they are empty, we wait on the signal via midi_jack_info ::
+ *  api_poll_for_midi(), then check the queues again.  The signal stays
+ *  raised until the wait clears it, so input queued between the check and
+ *  the wait is not missed.
+ *
  *  Otherwise, the call sequence is:
  *
  *      -   rtmidi_info::api_poll_for_midi()
  *      -   rtmidi_info::get_api_info()->api_poll_for_midi()
  *      -   midi_alsa_info::api_poll_for_midi()
- *      -   poll() on the ALSA descriptors; a return > 0 means that number of
- *          events are ready
+ *      -   poll() on the ALSA descriptors plus the input signal; a return
+ *          > 0 means that number of events are ready
  *
  *  Because of some reasons long forgotten, the ALSA "rtmidi" framework here
  *  handles MIDI via the midi_alsa_info object.
@@ -275,7 +281,15 @@ mastermidibus::api_poll_for_midi ()
 {
 #if defined SEQ66_USE_JACK_POLLING_FLAG
     if (m_use_jack_polling)                             /* --jack-midi set  */
-        return mastermidibase::api_poll_for_midi();     /* inbus-array poll */
+    {
+        int result = m_inbus_array.poll_for_midi();     /* inbus-array poll */
+        if (result == 0)
+        {
+            (void) midi_master().api_poll_for_midi();   /* wait for signal  */
+            result = m_inbus_array.poll_for_midi();
+        }
+        return result;
+    }
     else
         return midi_master().api_poll_for_midi();       /* ALSA poll        */
 #else
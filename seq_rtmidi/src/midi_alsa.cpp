@@ -114,6 +114,7 @@
 #include "midibus_rm.hpp"               /* seq66::midibus for rtmidi        */
 #include "midi_alsa.hpp"                /* seq66::midi_alsa for ALSA        */
 #include "midi_info.hpp"                /* seq66::midi_info                 */
+#include "os/timing.hpp"                /* seq66::microtime()               */
 
 /*
  *  Do not document a namespace; it breaks Doxygen.
@@ -128,6 +129,30 @@ namespace seq66
  * --------------------------------------------------------------------------
  */
 
+/**
+ *  Static members for scheduled (lookahead) output.  See lookahead_delay().
+ */
+
+long midi_alsa::sm_lookahead_us             = 0;        /* direct output    */
+double midi_alsa::sm_us_per_pulse           = 0.0;
+long midi_alsa::sm_anchor_us                = 0;
+midipulse midi_alsa::sm_anchor_pulse        = c_null_midipulse;
+midipulse midi_alsa::sm_last_pulse          = c_null_midipulse;
+recmutex midi_alsa::sm_anchor_mutex;
+
+/**
+ *  Defines the size of the MIDI event buffer, which should be large enough to
+ *  accomodate the largest MIDI message to be encoded.
+ *  A local define for visibility.  Also provided, but not yet used, is a size
+ *  for SysEx events, which we don't handle, but want to note here.  Inspired
+ *  by Qtractor code. Also in Qtractor, the same snd_midi_event_t object is
+ *  used over and over, rather than being recreated/destroyed for every
+ *  event-play by snd_midi_event_new() and snd_midi_event_free().
+ */
+
+static const size_t s_event_size_max =  10;
+static const size_t s_sysex_size_max = 512; /* Hydrogen uses 32 for input!  */
+
 /**
  *  Provides a constructor with client number, port number, ALSA sequencer
  *  support, name of client, name of port, etc., mostly contained within an
@@ -170,19 +195,23 @@ midi_alsa::midi_alsa (midibus & parentbus, midi_info & masterinfo) :
     m_dest_addr_client  (parentbus.bus_id()),
     m_dest_addr_port    (parentbus.port_id()),
     m_local_addr_client (snd_seq_client_id(m_seq)),     /* our client ID    */
-    m_local_addr_port   (-1)
+    m_local_addr_port   (-1),
+    m_encoder           (nullptr)
 {
     set_client_id(m_local_addr_client);
     set_name(SEQ66_CLIENT_NAME, bus_name(), port_name());
+    if (snd_midi_event_new(s_event_size_max, &m_encoder) < 0)
+        m_encoder = nullptr;                            /* just in case     */
 }
 
 /**
- *  A rote empty virtual destructor.
+ *  Frees the MIDI encoder.
  */
 
 midi_alsa::~midi_alsa ()
 {
-    // empty body
+    if (not_nullptr(m_encoder))
+        snd_midi_event_free(m_encoder);
 }
 
 /**
@@ -472,23 +501,70 @@ midi_alsa::api_connect ()
 }
 
 /**
- *  Defines the size of the MIDI event buffer, which should be large enough to
- *  accomodate the largest MIDI message to be encoded.
- *  A local define for visibility.  Also provided, but not yet used, is a size
- *  for SysEx events, which we don't handle, but want to note here.  Inspired
- *  by Qtractor code. Also in Qtractor, the same snd_midi_event_t object is
- *  used over and over, rather than being recreated/destroyed for every
- *  event-play by snd_midi_event_new() and snd_midi_event_free().
+ *  Fills in an ALSA sequencer event from the bytes of a channel message,
+ *  without going through a snd_midi_event_t parser.
+ *
+ * \return
+ *      Returns false if the status is not a channel message.
  */
 
-static const size_t s_event_size_max =  10;
-static const size_t s_sysex_size_max = 512; /* Hydrogen uses 32 for input!  */
+static bool
+fill_channel_event
+(
+    snd_seq_event_t & ev,
+    midibyte status,
+    midibyte d0,
+    midibyte d1
+)
+{
+    int channel = int(status & EVENT_GET_CHAN_MASK);
+    switch (status & EVENT_GET_STATUS_MASK)
+    {
+    case EVENT_NOTE_OFF:
+        snd_seq_ev_set_noteoff(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_NOTE_ON:
+        snd_seq_ev_set_noteon(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_AFTERTOUCH:
+        snd_seq_ev_set_keypress(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_CONTROL_CHANGE:
+        snd_seq_ev_set_controller(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_PROGRAM_CHANGE:
+        snd_seq_ev_set_pgmchange(&ev, channel, d0);
+        break;
+
+    case EVENT_CHANNEL_PRESSURE:
+        snd_seq_ev_set_chanpress(&ev, channel, d0);
+        break;
+
+    case EVENT_PITCH_WHEEL:
+        snd_seq_ev_set_pitchbend
+        (
+            &ev, channel, ((int(d1) << 7) | int(d0)) - 8192
+        );
+        break;
+
+    default:
+        return false;
+    }
+    return true;
+}
 
 /**
  *  This play() function takes a native event, encodes it to an ALSA MIDI
  *  sequencer event, sets the broadcasting to the subscribers, sets the
- *  direct-passing mode to send the event without queueing, and puts it in the
- *  queue.
+ *  direct-passing mode to send the event without queueing (or schedules
+ *  it on the ALSA queue), and puts it in the queue.
+ *
+ *  Channel messages are filled in directly; anything else goes through the
+ *  port's reusable encoder.  No heap allocation is done here.
  *
  * \threadsafe
  *
@@ -507,27 +583,143 @@ midi_alsa::api_play (const event * e24, midibyte channel)
 {
     if (parent_bus().port_enabled())
     {
-        snd_midi_event_t * midi_ev;                         /* MIDI parser  */
-        int rc = snd_midi_event_new(s_event_size_max, &midi_ev);
-        if (rc == 0)
+        snd_seq_event_t ev;                                 /* event memory */
+        midibyte buffer[4];                                 /* temp data    */
+        buffer[0] = e24->get_status(channel);               /* status+chan  */
+        e24->get_data(buffer[1], buffer[2]);                /* set the data */
+        snd_seq_ev_clear(&ev);                              /* clear event  */
+        if (! fill_channel_event(ev, buffer[0], buffer[1], buffer[2]))
         {
-            snd_seq_event_t ev;                             /* event memory */
-            midibyte buffer[4];                             /* temp data    */
-            buffer[0] = e24->get_status(channel);           /* status+chan  */
-            e24->get_data(buffer[1], buffer[2]);            /* set the data */
-            snd_seq_ev_clear(&ev);                          /* clear event  */
-            snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* 3 raw bytes  */
-            snd_midi_event_free(midi_ev);                   /* free parser  */
-            snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source   */
-            snd_seq_ev_set_subs(&ev);                       /* subscriber   */
-            snd_seq_ev_set_direct(&ev);                     /* immediate    */
-            snd_seq_event_output(m_seq, &ev);               /* pump to que  */
+            if (is_nullptr(m_encoder))
+            {
+                errprint("ALSA out-of-memory error");
+                return;
+            }
+            snd_midi_event_reset_encode(m_encoder);
+            snd_midi_event_encode(m_encoder, buffer, 3, &ev);
         }
-        else
+        snd_seq_ev_set_source(&ev, m_local_addr_port);      /* set source   */
+        snd_seq_ev_set_subs(&ev);                           /* subscriber   */
+        schedule(ev, e24->timestamp());                     /* or immediate */
+        snd_seq_event_output(m_seq, &ev);                   /* pump to que  */
+    }
+}
+
+/**
+ *  Sets the event to be delivered directly, or, if scheduled output is
+ *  enabled, schedules it on the ALSA queue at the due time of the tick.
+ *  The stamp is relative to the current queue time, so we never need to
+ *  query the queue.
+ */
+
+void
+midi_alsa::schedule (snd_seq_event_t & ev, midipulse tick)
+{
+    if (scheduled())
+    {
+        long us = lookahead_delay(tick);
+        snd_seq_real_time_t rt;
+        rt.tv_sec = unsigned(us / 1000000);
+        rt.tv_nsec = unsigned((us % 1000000) * 1000);
+        snd_seq_ev_schedule_real(&ev, parent_bus().queue_number(), 1, &rt);
+    }
+    else
+        snd_seq_ev_set_direct(&ev);
+}
+
+/**
+ *  Enables scheduled output, if the lookahead is not 0.  Called by
+ *  midi_alsa_info, which also starts the ALSA queue.
+ *
+ * \param ms
+ *      The lookahead, in milliseconds.
+ */
+
+void
+midi_alsa::lookahead_setup (int ms)
+{
+    automutex locker(sm_anchor_mutex);
+    sm_lookahead_us = ms > 0 ? long(ms) * 1000 : 0 ;
+    sm_anchor_pulse = c_null_midipulse;
+}
+
+/**
+ *  Updates the microseconds-per-pulse factor for a new PPQN or BPM.  If
+ *  playback is in progress, the anchor is first moved to the last pulse
+ *  sent, so that the events already scheduled and those to come stay
+ *  contiguous.
+ */
+
+void
+midi_alsa::lookahead_tempo (int ppqn, midibpm bpm)
+{
+    automutex locker(sm_anchor_mutex);
+    double uspp = (ppqn > 0 && bpm > 0.0) ? 60000000.0 / (ppqn * bpm) : 0.0 ;
+    if (uspp != sm_us_per_pulse)
+    {
+        if (! is_null_midipulse(sm_anchor_pulse))
+        {
+            double dt = double(sm_last_pulse - sm_anchor_pulse) *
+                sm_us_per_pulse;
+
+            sm_anchor_us += long(dt + 0.5);
+            sm_anchor_pulse = sm_last_pulse;
+        }
+        sm_us_per_pulse = uspp;
+    }
+}
+
+/**
+ *  Drops the anchor, so that the next event played establishes a new one.
+ *  Called at start, stop, and continue.
+ */
+
+void
+midi_alsa::lookahead_reset ()
+{
+    automutex locker(sm_anchor_mutex);
+    sm_anchor_pulse = c_null_midipulse;
+}
+
+/**
+ *  Calculates how far in the future an event is due.  The first event
+ *  after a reset sets the anchor: its pulse is due one lookahead from now.
+ *  Later pulses are due at the anchor time plus their distance from the
+ *  anchor pulse.  This preserves the exact spacing of the events, no matter
+ *  how the performer batched them.  If the delay would be negative (the
+ *  performer fell behind) or more than twice the lookahead (a relocation,
+ *  or a stale timestamp), the anchor is re-seated at this pulse.  Since
+ *  the anchor and the performer both run on CLOCK_MONOTONIC, there is no
+ *  drift to correct.
+ *
+ * \param p
+ *      The pulse at which the event is due.
+ *
+ * \return
+ *      Returns the delay in microseconds, relative to now.
+ */
+
+long
+midi_alsa::lookahead_delay (midipulse p)
+{
+    automutex locker(sm_anchor_mutex);
+    long now = microtime();
+    if (is_null_midipulse(p) || sm_us_per_pulse <= 0.0)
+        return sm_lookahead_us;
+
+    if (! is_null_midipulse(sm_anchor_pulse))
+    {
+        double dt = double(p - sm_anchor_pulse) * sm_us_per_pulse;
+        long delay = sm_anchor_us + long(dt + 0.5) - now;
+        if (delay >= 0 && delay <= 2 * sm_lookahead_us)
         {
-            errprint("ALSA out-of-memory error");
+            sm_last_pulse = p;
+            return delay;
         }
     }
+    sm_anchor_pulse = sm_last_pulse = p;
+    sm_anchor_us = now + sm_lookahead_us;
+    return sm_lookahead_us;
 }
 
 /**
@@ -656,6 +848,8 @@ midi_alsa::api_continue_from (midipulse /* tick */, midipulse beats)
 {
     if (parent_bus().port_enabled())
     {
+        lookahead_reset();
+
         snd_seq_event_t ev;
         snd_seq_ev_clear(&ev);                          /* clear event      */
         ev.type = SND_SEQ_EVENT_CONTINUE;
@@ -690,6 +884,8 @@ midi_alsa::api_start ()
 {
     if (parent_bus().port_enabled())
     {
+        lookahead_reset();
+
         snd_seq_event_t ev;
         snd_seq_ev_clear(&ev);                          /* memsets it to 0  */
         ev.type = SND_SEQ_EVENT_START;
@@ -703,7 +899,9 @@ midi_alsa::api_start ()
 }
 
 /**
- *  Stop the MIDI buss.
+ *  Stop the MIDI buss.  If output is scheduled, the events not yet
+ *  delivered are removed, except for Note Offs, so that nothing starts
+ *  sounding after the stop.
  */
 
 void
@@ -711,6 +909,22 @@ midi_alsa::api_stop ()
 {
     if (parent_bus().port_enabled())
     {
+        if (scheduled())
+        {
+            snd_seq_remove_events_t * remove;
+            snd_seq_remove_events_alloca(&remove);
+            snd_seq_remove_events_set_condition
+            (
+                remove, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_IGNORE_OFF
+            );
+            snd_seq_remove_events_set_queue
+            (
+                remove, parent_bus().queue_number()
+            );
+            snd_seq_remove_events(m_seq, remove);
+            lookahead_reset();
+        }
+
         snd_seq_event_t ev;
         snd_seq_ev_clear(&ev);                          /* memsets it to 0  */
         ev.type = SND_SEQ_EVENT_STOP;
@@ -730,11 +944,12 @@ midi_alsa::api_stop ()
  * \threadsafe
  *
  * \param tick
- *      Provides the starting tick, unused in the ALSA implementation.
+ *      Provides the tick of the clock, used only to schedule it along with
+ *      the notes when ALSA scheduled output is enabled.
  */
 
 void
-midi_alsa::api_clock (midipulse /*tick*/)
+midi_alsa::api_clock (midipulse tick)
 {
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
@@ -744,7 +959,7 @@ midi_alsa::api_clock (midipulse /*tick*/)
     snd_seq_ev_set_priority(&ev, 1);
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it's immediate       */
+    schedule(ev, tick);                             /* in step with notes   */
     snd_seq_event_output(m_seq, &ev);               /* pump it into queue   */
 }
 
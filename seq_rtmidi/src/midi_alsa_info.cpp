@@ -78,6 +78,7 @@
 #include "cfg/settings.hpp"             /* seq66::rc() configuration object */
 #include "midi/event.hpp"               /* seq66::event and other tokens    */
 #include "midi/midibus_common.hpp"      /* from the libseq66 sub-project    */
+#include "midi_alsa.hpp"                /* seq66::midi_alsa lookahead       */
 #include "midi_alsa_info.hpp"           /* seq66::midi_alsa_info            */
 #include "util/basic_macros.hpp"        /* C++ version of easy macros       */
 
@@ -96,11 +97,13 @@ namespace seq66
  *  -   SND_SEQ_NONBLOCK        Non-blocking mode.
  *
  *  We did reduce the polling timeout from 1000 milliseconds (in Seq24) to 100
- *  milliseconds, and now, after testing, 10 milliseconds, and removed the
- *  additional 100 microsecond wait.
+ *  milliseconds, and then, after testing, 10 milliseconds, and removed the
+ *  additional 100 microsecond wait.  Now that the poll also includes the
+ *  input signal, which wakes the input thread at exit, the timeout is only a
+ *  safety net; input latency does not depend on it.
  */
 
-static const int c_poll_wait_ms     = 10;
+static const int c_poll_wait_ms     = 250;
 static const int c_open_block_mode  = SND_SEQ_NONBLOCK;
 
 /*
@@ -162,6 +165,23 @@ midi_alsa_info::midi_alsa_info
         snd_seq_set_client_name(m_alsa_seq, rc().app_client_name().c_str());
         global_queue(snd_seq_alloc_queue(m_alsa_seq));
         get_poll_descriptors();
+
+        /*
+         * Scheduled output needs a running queue; its events are stamped
+         * relative to the current queue time.
+         */
+
+        if (rc().alsa_lookahead() > 0)
+        {
+            int q = global_queue();
+            if (snd_seq_start_queue(m_alsa_seq, q, nullptr) >= 0)
+            {
+                (void) snd_seq_drain_output(m_alsa_seq);
+                midi_alsa::lookahead_setup(rc().alsa_lookahead());
+            }
+            else
+                m_error_string = "ALSA queue start failed";
+        }
     }
 }
 
@@ -192,6 +212,11 @@ midi_alsa_info::~midi_alsa_info ()
  *  before creating all the MIDI busses?  If not, we'll put them in a separate
  *  function to call later.
  *
+ *  One more descriptor is allocated at the end of the array, for the input
+ *  signal (see midi_info::api_wake_input()).  It is not counted in
+ *  m_num_poll_descriptors.  If the signal could not be created, its
+ *  descriptor is -1, which poll() ignores.
+ *
  *  This function is called in the constructor and in api_port_start().
  */
 
@@ -201,9 +226,14 @@ midi_alsa_info::get_poll_descriptors ()
     m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
     if (m_num_poll_descriptors > 0)
     {
-        m_poll_descriptors = new (std::nothrow) pollfd[m_num_poll_descriptors];
+        int count = m_num_poll_descriptors + 1;
+        m_poll_descriptors = new (std::nothrow) pollfd[count];
         if (not_nullptr(m_poll_descriptors))
         {
+            struct pollfd & wake = m_poll_descriptors[m_num_poll_descriptors];
+            wake.fd = input_signal().fd();
+            wake.events = POLLIN;
+            wake.revents = 0;
             snd_seq_poll_descriptors                /* get input descriptors */
             (
                 m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
@@ -413,6 +443,7 @@ midi_alsa_info::api_set_ppqn (int p)
         snd_seq_queue_tempo_set_ppq(tempo, p);
         snd_seq_set_queue_tempo(m_alsa_seq, queue, tempo);
     }
+    midi_alsa::lookahead_tempo(ppqn(), bpm());
 }
 
 /**
@@ -442,24 +473,40 @@ midi_alsa_info::api_set_beats_per_minute (midibpm b)
         snd_seq_queue_tempo_set_tempo(tempo, unsigned(tempo_us_from_bpm(b)));
         snd_seq_set_queue_tempo(m_alsa_seq, queue, tempo);
     }
+    midi_alsa::lookahead_tempo(ppqn(), bpm());
 }
 
 /**
- *  Polls for any ALSA MIDI information using a timeout value of 10
- *  milliseconds.
+ *  Blocks until ALSA MIDI input is ready, the input signal is raised, or
+ *  the timeout (c_poll_wait_ms) expires.  The input thread thus sleeps in
+ *  the kernel, and wakes as soon as an event arrives.
  *
  * \return
  *      Returns the result of the call to poll() on the global ALSA poll
- *      descriptors.
+ *      descriptors, not counting the input signal.
  */
 
 int
 midi_alsa_info::api_poll_for_midi ()
 {
-    int result = poll
-    (
-        m_poll_descriptors, m_num_poll_descriptors, c_poll_wait_ms
-    );
+    int result = 0;
+    if (not_nullptr(m_poll_descriptors))
+    {
+        struct pollfd & wake = m_poll_descriptors[m_num_poll_descriptors];
+        wake.revents = 0;
+        result = poll
+        (
+            m_poll_descriptors, m_num_poll_descriptors + 1, c_poll_wait_ms
+        );
+        if (result > 0 && wake.revents != 0)
+        {
+            input_signal().clear();
+            --result;                               /* not a MIDI event     */
+        }
+    }
+    else
+        (void) input_signal().wait(c_poll_wait_ms);
+
     return result;
 }
 
@@ -48,10 +48,21 @@
  */
 
 #include <sstream>                      /* std::ostringstream               */
+#include <fcntl.h>                      /* ::fcntl(), O_NONBLOCK            */
+#include <poll.h>                       /* ::poll(), struct pollfd          */
+#include <unistd.h>                     /* ::read(), ::write(), ::pipe()    */
+
+#include "seq66_platform_macros.h"      /* detecting Linux vs others        */
+
+#if defined SEQ66_PLATFORM_LINUX
+#include <sys/eventfd.h>                /* ::eventfd()                      */
+#endif
+
 
 #include "cfg/settings.hpp"             /* access to rc() configuration     */
 #include "midi/midibus.hpp"             /* select portmidi/rtmidi headers   */
 #include "midi_info.hpp"                /* seq66::midi_info etc.            */
+#include "os/timing.hpp"                /* seq66::microsleep()              */
 
 #if defined SEQ66_MIDI_PORT_REFRESH_BROKEN
 #include "midi_ports.hpp"                /* seq66::midi_ports classes       */
@@ -234,6 +245,115 @@ midi_port_info::get_port_index (int client, int port)
  * class midi_info
  */
 
+/*
+ * class midi_input_signal
+ */
+
+/**
+ *  Creates the descriptor(s).  If that fails, the signal is not valid, and
+ *  wait() just sleeps for the timeout, as the input thread used to do.
+ */
+
+midi_input_signal::midi_input_signal () :
+    m_read_fd   (-1),
+    m_write_fd  (-1)
+{
+#if defined SEQ66_PLATFORM_LINUX
+    m_read_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_write_fd = m_read_fd;
+#else
+    int fds[2];
+    if (::pipe(fds) == 0)
+    {
+        for (int f : fds)
+        {
+            (void) ::fcntl(f, F_SETFL, ::fcntl(f, F_GETFL) | O_NONBLOCK);
+            (void) ::fcntl(f, F_SETFD, FD_CLOEXEC);
+        }
+        m_read_fd = fds[0];
+        m_write_fd = fds[1];
+    }
+#endif
+}
+
+midi_input_signal::~midi_input_signal ()
+{
+    if (m_write_fd >= 0 && m_write_fd != m_read_fd)
+        (void) ::close(m_write_fd);
+
+    if (m_read_fd >= 0)
+        (void) ::close(m_read_fd);
+}
+
+/**
+ *  Raises the signal.  This is a single non-blocking write(), so it can be
+ *  called from the JACK process callback.  If the signal is already raised,
+ *  the write can fail with EAGAIN, which is fine.
+ */
+
+void
+midi_input_signal::signal ()
+{
+    if (m_write_fd >= 0)
+    {
+#if defined SEQ66_PLATFORM_LINUX
+        uint64_t one = 1;
+        (void) ::write(m_write_fd, &one, sizeof one);
+#else
+        char one = 1;
+        (void) ::write(m_write_fd, &one, sizeof one);
+#endif
+    }
+}
+
+/**
+ *  Lowers the signal by draining the descriptor.
+ */
+
+void
+midi_input_signal::clear ()
+{
+    if (m_read_fd >= 0)
+    {
+        char buffer[64];
+        while (::read(m_read_fd, buffer, sizeof buffer) > 0)
+        {
+            // drain it
+        }
+    }
+}
+
+/**
+ *  Waits until the signal is raised, or until the timeout expires, then
+ *  clears the signal.
+ *
+ * \param ms
+ *      The timeout in milliseconds.
+ *
+ * \return
+ *      Returns true if the signal was raised.
+ */
+
+bool
+midi_input_signal::wait (int ms)
+{
+    bool result = false;
+    if (valid())
+    {
+        struct pollfd pfd;
+        pfd.fd = m_read_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        result = ::poll(&pfd, 1, ms) > 0;
+        if (result)
+            clear();
+    }
+    else
+        (void) microsleep(ms * 1000);
+
+    return result;
+}
+
 #if defined SEQ66_MIDI_PORT_REFRESH_BROKEN
 midi_ports midi_info::m_previous_input;
 midi_ports midi_info::m_previous_output;
@@ -254,6 +374,7 @@ midi_info::midi_info (const std::string & appname, int ppqn, midibpm bpm) :
     m_ppqn              (ppqn),
     m_bpm               (bpm),
     m_midi_port_refresh (false),
+    m_input_signal      (),
     m_error_string      ()
 {
     // No code
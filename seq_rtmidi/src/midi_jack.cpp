@@ -319,14 +319,13 @@ jack_process_rtmidi_input (jack_nframes_t framect, void * arg)
             }
             jackdata->jack_lasttime(jtime);
 
-            midi_message message(delta_jtime);      /* issue #100           */
-            size_t eventsize = jmevent.size;
-            for (size_t i = 0; i < eventsize; ++i)
-                message.push(jmevent.buffer[i]);
-
             if (! rtindata->continue_sysex())
             {
-                if (! rtindata->queue().add(message))
+                bool ok = rtindata->queue().push            /* issue #100   */
+                (
+                    jmevent.buffer, jmevent.size, midipulse(delta_jtime)
+                );
+                if (! ok)
                 {
                     async_safe_strprint("~");
                     overflow = true;
@@ -345,6 +344,9 @@ jack_process_rtmidi_input (jack_nframes_t framect, void * arg)
             async_safe_errprint(errmsg);
         }
     }
+    if (evcount > 0 && not_nullptr(midi_jack_data::input_signal()))
+        midi_jack_data::input_signal()->signal();   /* wake input thread    */
+
     if (overflow)
     {
         async_safe_errprint(" Message overflow ");
@@ -356,15 +358,11 @@ jack_process_rtmidi_input (jack_nframes_t framect, void * arg)
 #if defined SEQ66_PLATFORM_DEBUG_TMI
 
 static void
-message_time (bool sent, const midi_message & msg)
+message_time (bool sent, midipulse ts)
 {
     const char * tag = sent ? "Sent" : "Rcvd" ;
     unsigned jtime = unsigned(::jack_get_time() / 1000);        /* rough ms */
-    printf
-    (
-        "%s #%u (0x%2x) at %u ms\n",
-        tag, msg.msg_number(), msg.status(), jtime
-    );
+    printf("%s ts %ld at %u ms\n", tag, long(ts), jtime);
 }
 
 #endif
@@ -411,26 +409,36 @@ jack_get_event_data
 )
 {
     jack_nframes_t result = UINT32_MAX;
-    ring_buffer<midi_message> * buffmsg = jackdata->jack_buffer();
-    int count = int(buffmsg->read_space());
-    bool process = count > 0;
+    midi_ring * buffmsg = jackdata->jack_buffer();
+    bool process = ! buffmsg->empty();
     if (process)
     {
         static bool s_use_offset = midi_jack_data::use_offset();
-        const midi_message & msg = buffmsg->front();
+        midipulse ts = buffmsg->front_timestamp();
 
 #if defined SEQ66_PLATFORM_DEBUG_TMI
-        static unsigned s_last_msg_number = 0;
-        unsigned msgno = msg.msg_number();
-        if (msgno < s_last_msg_number)
-            async_safe_errprint("ring_buffer wraparound?");
-
-        s_last_msg_number = msgno;
-        message_time(false, msg);
+        message_time(false, ts);
 #endif
 
-        midipulse ts = msg.timestamp();
-        if (s_use_offset)
+        if (midi_jack_data::lookahead())
+        {
+            /*
+             * The timestamp is the due frame.  If it falls beyond this
+             * cycle, leave the message (and all after it) for a later one.
+             * A late message goes out at the start of the cycle.  JACK
+             * requires offsets in non-decreasing order.
+             */
+
+            jack_nframes_t due = jack_nframes_t(ts);
+            int32_t ahead = int32_t(due - cycle_start);
+            if (ahead >= int32_t(framect))
+                return result;                      /* not yet due          */
+
+            result = ahead > 0 ? jack_nframes_t(ahead) : 0 ;
+            if (result < lastvalue)
+                result = lastvalue;
+        }
+        else if (s_use_offset)
         {
 #if defined USE_FULL_TTYMIDI_METHOD
 
@@ -462,29 +470,17 @@ jack_get_event_data
         else
             result = 0;
 
-        if (process)
-        {
-            size_t datasz = size_t(msg.event_count());
-            if (datasz <= destsz)
-            {
-                memcpy(dest, msg.event_bytes(), datasz);
-                destsz = datasz;
-            }
-            buffmsg->pop_front();
-        }
-        else
-        {
-#if defined SEQ66_PLATFORM_DEBUG
-            char value[c_async_safe_utoa_size];
-            char text[c_async_safe_utoa_size + 32];
-            std::strcpy(text, "Event ");
-            async_safe_utoa(value, msg.msg_number());
-            std::strcat(text, value);
-            std::strcat(text, " belayed");
-            async_safe_errprint(text);
-#endif
-            result = UINT32_MAX;
-        }
+        /*
+         * A message too large for the destination is dropped rather than
+         * left to block the ring.
+         */
+
+        std::size_t datasz = buffmsg->front_bytes
+        (
+            reinterpret_cast<midibyte *>(dest), destsz
+        );
+        destsz = datasz;
+        buffmsg->pop_front();
     }
     return result;
 }
@@ -923,7 +919,7 @@ midi_jack::~midi_jack ()
 #if defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
     if (not_nullptr(jack_data().jack_buffer()))
     {
-        ring_buffer<midi_message> * rb = jack_data().jack_buffer();
+        midi_ring * rb = jack_data().jack_buffer();
         if (rb->dropped() > 0 || rb->count_max() > (rb->buffer_size() / 2))
         {
             char tmp[64];
@@ -1285,26 +1281,27 @@ midi_jack::send_message (const midi_message & message)
 {
 #if defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
 
-    ring_buffer<midi_message> * rb = jack_data().jack_buffer();
+    midi_ring * rb = jack_data().jack_buffer();
+    midipulse ts = message.timestamp();
 
 #if defined SEQ66_ENCODE_JACK_FRAME_TIME
-    midi_message & ncmessage = const_cast<midi_message &>(message);
-    ncmessage.timestamp(midipulse(::jack_frame_time(jack_data().jack_client())));
+    ts = midipulse(::jack_frame_time(jack_data().jack_client()));
+#else
+    if (midi_jack_data::lookahead())
+    {
+        jack_nframes_t now = ::jack_frame_time(jack_data().jack_client());
+        ts = midipulse(midi_jack_data::lookahead_frame(now, ts));
+    }                                               /* pulse --> due frame  */
 #endif
 
 #if defined SEQ66_PLATFORM_DEBUG
-    bool result = rb->push_back(message);
-    if (result)
-    {
-        size_t space = size_t(rb->read_space());
-        result = space > 0 && space < c_jack_ringbuffer_size;
-    }
+    bool result = rb->push(message.event_bytes(), message.event_count(), ts);
     if (! result)
         printf("send_message() failed\n");
 
     return result;
 #else
-    return rb->push_back(message);
+    return rb->push(message.event_bytes(), message.event_count(), ts);
 #endif
 
 #else   // ! defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
@@ -1405,6 +1402,8 @@ midi_jack::api_continue_from (midipulse tick, midipulse /*beats*/)
     if (::jack_transport_locate(client_handle(), jack_frame) != 0)
         (void) info_message("JACK Continue failed");
 
+    midi_jack_data::lookahead_reset();
+
     /*
      * New code to work like the ALSA version, needs testing.  Related to
      * issue #67.  However, the ALSA version sends Continue, flushes, and
@@ -1426,6 +1425,7 @@ void
 midi_jack::api_start ()
 {
     ::jack_transport_start(client_handle());
+    midi_jack_data::lookahead_reset();
     send_byte(0, EVENT_MIDI_START);             /* is tick 0 always good    */
 }
 
@@ -1440,6 +1440,7 @@ midi_jack::api_stop ()
 {
     ::jack_transport_stop(client_handle());
     send_byte(0, EVENT_MIDI_STOP);              /* do we need real tick?    */
+    midi_jack_data::lookahead_reset();
 }
 
 /**
@@ -1786,8 +1787,7 @@ midi_jack::create_ringbuffer (size_t rbsize)
     if (result)
     {
 #if defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
-        ring_buffer<midi_message> * rb =
-            new (std::nothrow) ring_buffer<midi_message>(rbsize);
+        midi_ring * rb = new (std::nothrow) midi_ring(rbsize);
 
         result = not_nullptr(rb);
         if (result)
@@ -1844,6 +1844,9 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
 /**
  *  Checks the rtmidi_in_data queue for the number of items in the queue.
  *
+ *  No longer sleeps; the input thread waits on the input signal instead.
+ *  See mastermidibus::api_poll_for_midi().
+ *
  * \return
  *      Returns the value of rtindata->queue().count(), unless the caller is
  *      using an rtmidi callback function, in which case 0 is always returned.
@@ -1853,7 +1856,6 @@ int
 midi_in_jack::api_poll_for_midi ()
 {
     rtmidi_in_data * rtindata = jack_data().jack_rtmidiin();
-    (void) microsleep(std_sleep_us());
     return rtindata->queue().count();
 }
 
@@ -1887,7 +1889,8 @@ midi_in_jack::api_get_midi_event (event * inev)
     bool result = ! rtindata->queue().empty();
     if (result)
     {
-        midi_message mm = rtindata->queue().pop_front();
+        midi_message mm;
+        (void) rtindata->queue().pop_front(mm);
         result = inev->set_midi_event
         (
             mm.timestamp(), mm.event_bytes(), mm.event_count()
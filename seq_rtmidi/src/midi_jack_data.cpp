@@ -30,7 +30,7 @@
  *  GitHub issue #165: enabled a build and run with no JACK support.
  */
 
-#include <cmath>                        /* std::trunc(double) functions     */
+#include <cmath>                        /* std::trunc(), std::llround()     */
 
 #include "midi_jack_data.hpp"           /* seq66::midi_jack_data class      */
 #include "cfg/settings.hpp"             /* seq66::rc() config accessor      */
@@ -60,6 +60,37 @@ double midi_jack_data::sm_jack_beats_per_minute     = 1.0;  /* 120.0        */
 double midi_jack_data::sm_jack_frame_factor         = 0.0;
 bool midi_jack_data::sm_use_offset                  = false;
 
+/**
+ *  Static members for the lookahead rendering of JACK output.  See
+ *  lookahead_frame().
+ */
+
+jack_nframes_t midi_jack_data::sm_lookahead_frames  = 0;    /* disabled     */
+jack_nframes_t midi_jack_data::sm_lookahead_rate    = 0;
+double midi_jack_data::sm_pulses_per_second         = 0.0;
+double midi_jack_data::sm_frames_per_pulse          = 0.0;
+jack_nframes_t midi_jack_data::sm_anchor_frame      = 0;
+midipulse midi_jack_data::sm_anchor_pulse           = c_null_midipulse;
+midipulse midi_jack_data::sm_last_pulse             = c_null_midipulse;
+recmutex midi_jack_data::sm_anchor_mutex;
+midi_input_signal * midi_jack_data::sm_input_signal = nullptr;
+
+/**
+ *  The performer emits the events of a pattern in batches, a few
+ *  milliseconds of ticks at a time, so a lookahead shorter than that would
+ *  make events late in any case.  We enforce this minimum window (seconds).
+ */
+
+static const double c_lookahead_minimum = 0.008;
+
+/**
+ *  The anchor frame is slewed by the deviation of the slack from its ideal
+ *  value divided by this number, so that the slow drift between the system
+ *  clock and the audio clock is absorbed without audible steps.
+ */
+
+static const int32_t c_lookahead_slew = 256;
+
 /**
  * \ctor midi_jack_data
  */
@@ -68,7 +99,7 @@ midi_jack_data::midi_jack_data () :
     m_jack_client           (nullptr),
     m_jack_port             (nullptr),
 #if defined SEQ66_USE_MIDI_MESSAGE_RINGBUFFER
-    m_jack_buffer           (nullptr),      /* ring_buffer<midi_message>    */
+    m_jack_buffer           (nullptr),      /* midi_ring                    */
 #else
     m_jack_buffmessage      (nullptr),
 #endif
@@ -325,6 +356,137 @@ midi_jack_data::frame_estimate (midipulse p)
     return jack_nframes_t(temp);
 }
 
+/**
+ *  Sets up the lookahead window once the JACK client is active.
+ *
+ * \param rate
+ *      The JACK sample rate.
+ *
+ * \param F
+ *      The JACK period, the number of frames per process cycle.
+ *
+ * \param periods
+ *      The number of periods to look ahead, from the 'rc' file.  If 0, the
+ *      lookahead is disabled and the old frame-offset estimates are used.
+ */
+
+void
+midi_jack_data::lookahead_setup
+(
+    jack_nframes_t rate,
+    jack_nframes_t F,
+    int periods
+)
+{
+    automutex locker(sm_anchor_mutex);
+    sm_lookahead_rate = rate;
+    if (periods > 0 && rate > 0 && F > 0)
+    {
+        jack_nframes_t frames = jack_nframes_t(periods) * F;
+        jack_nframes_t minimum = jack_nframes_t(rate * c_lookahead_minimum);
+        sm_lookahead_frames = frames > minimum ? frames : minimum ;
+    }
+    else
+        sm_lookahead_frames = 0;
+
+    if (sm_pulses_per_second > 0.0)
+        sm_frames_per_pulse = double(rate) / sm_pulses_per_second;
+
+    sm_anchor_pulse = c_null_midipulse;
+}
+
+/**
+ *  Updates the frames-per-pulse factor for a new PPQN or BPM.  If playback
+ *  is in progress, the anchor is first moved to the last pulse sent, so
+ *  that the events already queued and those to come stay contiguous.
+ */
+
+void
+midi_jack_data::lookahead_tempo (int ppqn, midibpm bpm)
+{
+    automutex locker(sm_anchor_mutex);
+    double pps = (ppqn > 0 && bpm > 0.0) ? double(ppqn) * bpm / 60.0 : 0.0 ;
+    if (pps != sm_pulses_per_second)
+    {
+        if (! is_null_midipulse(sm_anchor_pulse))
+        {
+            double df = double(sm_last_pulse - sm_anchor_pulse) *
+                sm_frames_per_pulse;
+
+            sm_anchor_frame += jack_nframes_t(std::llround(df));
+            sm_anchor_pulse = sm_last_pulse;
+        }
+        sm_pulses_per_second = pps;
+        sm_frames_per_pulse = pps > 0.0 ?
+            double(sm_lookahead_rate) / pps : 0.0 ;
+    }
+}
+
+/**
+ *  Drops the anchor, so that the next message sent establishes a new one.
+ *  Called at start, stop, and continue.
+ */
+
+void
+midi_jack_data::lookahead_reset ()
+{
+    automutex locker(sm_anchor_mutex);
+    sm_anchor_pulse = c_null_midipulse;
+}
+
+/**
+ *  Calculates the JACK frame at which a message is due.  The first message
+ *  after a reset sets the anchor: its pulse is due one lookahead window
+ *  from now.  Later pulses are due at the anchor frame plus their distance
+ *  from the anchor pulse, converted to frames.  This preserves the exact
+ *  spacing of the events, no matter how they were batched by the
+ *  performer.
+ *
+ *  The slack (due frame minus now) should stay near the lookahead window.
+ *  If it goes negative (the performer fell behind) or exceeds twice the
+ *  window (a relocation or a stale timestamp), the anchor is re-seated at
+ *  this pulse.  Small, slow deviations are slewed out.
+ *
+ *  Frame numbers wrap around at 2^32, so all comparisons are done on
+ *  signed differences.
+ *
+ * \param now
+ *      The current estimated frame, from jack_frame_time().
+ *
+ * \param p
+ *      The pulse at which the message is due.
+ *
+ * \return
+ *      Returns the due frame.
+ */
+
+jack_nframes_t
+midi_jack_data::lookahead_frame (jack_nframes_t now, midipulse p)
+{
+    automutex locker(sm_anchor_mutex);
+    jack_nframes_t result = now + sm_lookahead_frames;
+    if (is_null_midipulse(p) || sm_frames_per_pulse <= 0.0)
+        return result;
+
+    if (! is_null_midipulse(sm_anchor_pulse))
+    {
+        double df = double(p - sm_anchor_pulse) * sm_frames_per_pulse;
+        jack_nframes_t due = sm_anchor_frame + jack_nframes_t(std::llround(df));
+        int32_t slack = int32_t(due - now);
+        int32_t window = int32_t(sm_lookahead_frames);
+        if (slack >= 0 && slack <= 2 * window)
+        {
+            int32_t error = slack - window;
+            sm_anchor_frame -= jack_nframes_t(error / c_lookahead_slew);
+            sm_last_pulse = p;
+            return due;
+        }
+    }
+    sm_anchor_pulse = sm_last_pulse = p;
+    sm_anchor_frame = result;
+    return result;
+}
+
 void
 midi_jack_data::cycle_frame
 (
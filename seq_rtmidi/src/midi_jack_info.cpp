@@ -69,6 +69,14 @@ extern int jack_process_rtmidi_input (jack_nframes_t nframes, void * arg);
 extern int jack_process_rtmidi_output (jack_nframes_t nframes, void * arg);
 extern void jack_shutdown_callback (void * arg);
 
+/**
+ *  The longest time api_poll_for_midi() waits for the input signal.  The
+ *  process callback raises the signal as soon as input is queued, and the
+ *  performer raises it at exit, so this is only a safety net.
+ */
+
+static const int c_jack_poll_wait_ms = 250;
+
 #if defined SEQ66_JACK_PORT_CONNECT_CALLBACK
 
 extern void jack_port_connect_callback
@@ -150,6 +158,7 @@ midi_jack_info::midi_jack_info
     m_jack_sample_rate      (0)
 {
     silence_jack_info();
+    midi_jack_data::input_signal(&input_signal());  /* for input callback   */
     m_jack_client = connect();
     if (not_nullptr(m_jack_client))                 /* created by connect() */
     {
@@ -167,6 +176,7 @@ midi_jack_info::midi_jack_info
 midi_jack_info::~midi_jack_info ()
 {
     disconnect();
+    midi_jack_data::input_signal(nullptr);          /* no more callbacks    */
 }
 
 /**
@@ -817,6 +827,17 @@ midi_jack_info::api_connect ()
                     error_message("JACK set buffer size failed");
             }
             m_jack_sample_rate = jack_get_sample_rate(client_handle());
+            midi_jack_data::lookahead_setup
+            (
+                m_jack_sample_rate,
+                ::jack_get_buffer_size(client_handle()),
+                rc().jack_lookahead()
+            );
+            if (midi_jack_data::lookahead())
+            {
+                int periods = rc().jack_lookahead();
+                status_message("JACK lookahead", std::to_string(periods));
+            }
         }
     }
     if (result && rc().jack_auto_connect())         /* issue #60        */
@@ -851,6 +872,7 @@ void
 midi_jack_info::api_set_ppqn (int p)
 {
     midi_info::api_set_ppqn(p);
+    midi_jack_data::lookahead_tempo(ppqn(), bpm());
 }
 
 /**
@@ -866,6 +888,7 @@ void
 midi_jack_info::api_set_beats_per_minute (midibpm b)
 {
     midi_info::api_set_beats_per_minute(b);
+    midi_jack_data::lookahead_tempo(ppqn(), bpm());
 
     // Need JACK specific tempo-setting here if applicable.
 }
@@ -906,13 +929,19 @@ midi_jack_info::api_port_start
 }
 
 /**
- *  We might be able to eliminate this function.
+ *  JACK input is queued per port, so this function cannot count it.
+ *  Instead, it waits for the input process callback (or an exit request) to
+ *  raise the input signal, and the caller then checks the port queues.
+ *  See mastermidibus::api_poll_for_midi().
+ *
+ * \return
+ *      Always returns 0.
  */
 
 int
 midi_jack_info::api_poll_for_midi ()
 {
-    (void) microsleep(std_sleep_us());
+    (void) input_signal().wait(c_jack_poll_wait_ms);
     return 0;
 }
 
@@ -63,7 +63,9 @@ midi_message::midi_message (midipulse ts) :
 #if defined SEQ66_PLATFORM_DEBUG
     m_msg_number    (sm_msg_number++),
 #endif
+    m_inline        (),
     m_bytes         (),
+    m_count         (0),
     m_timestamp     (ts)
 {
     // No code
@@ -84,11 +86,52 @@ midi_message::midi_message (const midibyte * mbs, std::size_t sz) :
 #if defined SEQ66_PLATFORM_DEBUG
     m_msg_number    (sm_msg_number++),
 #endif
+    m_inline        (),
     m_bytes         (),
+    m_count         (0),
     m_timestamp     (0)
 {
-    for (std::size_t i = 0; i < sz; ++i)
-        m_bytes.push_back(*mbs++);
+    assign(mbs, sz);
+}
+
+/**
+ *  Appends a byte.  The bytes stay inline until the message outgrows the
+ *  inline array; then they all move to the vector.
+ */
+
+void
+midi_message::push (midibyte b)
+{
+    if (m_count < c_midi_message_inline)
+    {
+        m_inline[m_count] = b;
+    }
+    else
+    {
+        if (m_count == c_midi_message_inline)
+            m_bytes.assign(&m_inline[0], &m_inline[c_midi_message_inline]);
+
+        m_bytes.push_back(b);
+    }
+    ++m_count;
+}
+
+/**
+ *  Replaces the bytes of the message.
+ */
+
+void
+midi_message::assign (const midibyte * mbs, std::size_t sz)
+{
+    if (sz <= std::size_t(c_midi_message_inline))
+    {
+        for (std::size_t i = 0; i < sz; ++i)
+            m_inline[i] = mbs[i];
+    }
+    else
+        m_bytes.assign(mbs, mbs + sz);
+
+    m_count = int(sz);
 }
 
 /**
@@ -120,143 +163,151 @@ midi_message::to_string () const
         if (i == 0)
         {
             char temp[8];
-            snprintf(temp, sizeof temp, "0x%2x", m_bytes[i]);
+            snprintf(temp, sizeof temp, "0x%2x", event_bytes()[i]);
             result += temp;
         }
         else
-            result += std::to_string(m_bytes[i]);
+            result += std::to_string(event_bytes()[i]);
     }
     return result;
 }
 
 /*
- * class midi_queue
+ * class midi_ring
  */
 
 /**
- *  Default constructor.
- */
-
-midi_queue::midi_queue () :
-    m_front     (0),
-    m_back      (0),
-    m_size      (0),
-    m_ring_size (0),
-    m_ring      (nullptr)
-{
-    allocate();
-}
-
-/**
- *  Destructor.
- */
-
-midi_queue::~midi_queue ()
-{
-    deallocate();
-}
-
-/**
+ *  Constructs the slot ring and the spill ring.  All of the memory is
+ *  allocated here.
+ *
+ * \param slotcount
+ *      The number of messages the ring can hold.  Rounded up to a power of
+ *      two.
  *
- *  This would be better off as a constructor operation.  But one step at a
- *  time.
+ * \param spillsize
+ *      The number of bytes of long messages the ring can hold.  A SysEx
+ *      message larger than this is dropped.
  */
 
-void
-midi_queue::allocate (unsigned queuesize)
+midi_ring::midi_ring (std::size_t slotcount, std::size_t spillsize) :
+    m_slots     (slotcount),
+    m_spill     (spillsize)
 {
-    deallocate();
-    if (queuesize > 0 && is_nullptr(m_ring))
-    {
-        m_ring = new(std::nothrow) midi_message[queuesize];
-        if (not_nullptr(m_ring))
-            m_ring_size = queuesize;
-    }
+    // No code
 }
 
 /**
+ *  Pushes a message, producer side.  A short message goes entirely into
+ *  its slot.  A long one first writes its bytes into the spill ring, which
+ *  is safe because the consumer does not look at them until the slot is
+ *  published.  We check for a free slot first, so that we never leave
+ *  orphaned spill bytes.
  *
- *  This would be better off as a destructor operation.  But one step at a
- *  time.
+ * \return
+ *      Returns false if there was no room; the message is dropped.
  */
 
-void
-midi_queue::deallocate ()
+bool
+midi_ring::push (const midibyte * mbs, std::size_t sz, midipulse ts)
 {
-    if (not_nullptr(m_ring))
+    if (m_slots.write_space() == 0)
+        return m_slots.push_back(slot());               /* counts the drop  */
+
+    slot s;
+    s.m_timestamp = ts;
+    s.m_count = int(sz);
+    if (sz <= std::size_t(c_midi_message_inline))
     {
-        delete [] m_ring;
-        m_ring = nullptr;
+        for (std::size_t i = 0; i < sz; ++i)
+            s.m_bytes[i] = mbs[i];
     }
+    else if (! m_spill.write_block(mbs, sz))
+        return false;
+
+    return m_slots.push_back(s);
 }
 
 /**
+ *  Copies the bytes of the front message, consumer side.
  *
- *  As long as we haven't reached our queue size limit, push the message.
+ * \return
+ *      Returns the number of bytes copied, or 0 if the message does not
+ *      fit in the destination.
  */
 
-bool
-midi_queue::add (const midi_message & mmsg)
+std::size_t
+midi_ring::front_bytes (midibyte * dest, std::size_t destsz) const
 {
-    bool result = ! full();
-    if (result)
-    {
-        m_ring[m_back++] = mmsg;
-        if (m_back == m_ring_size)
-            m_back = 0;
+    const slot & s = m_slots.front();
+    std::size_t sz = std::size_t(s.m_count);
+    if (sz > destsz)
+        return 0;
 
-        ++m_size;
-    }
-    else
+    if (sz <= std::size_t(c_midi_message_inline))
     {
-        /*
-         * errprintfunc("message queue limit reached");
-         */
+        for (std::size_t i = 0; i < sz; ++i)
+            dest[i] = s.m_bytes[i];
+
+        return sz;
     }
-    return result;
+    return m_spill.read_block(dest, sz);
 }
 
 /**
- *  Pops, so to speak, the front message out of the queue, effectively
- *  throwing it away.  One useful call sequence is:
- *
-\verbatim
-    midi_message latest = queue.front();
-    queue.pop();
-\endverbatim
- *
- *  An alternative is to use the pop_front() function instead.
+ *  Removes the front message, and its spill bytes if any.  Consumer side.
  */
 
 void
-midi_queue::pop ()
+midi_ring::pop_front ()
 {
-    --m_size;
-    ++m_front;
-    if (m_front == m_ring_size)
-        m_front = 0;
+    if (! m_slots.empty())
+    {
+        std::size_t sz = front_count();
+        if (sz > std::size_t(c_midi_message_inline))
+            m_spill.read_skip(sz);
+
+        m_slots.pop_front();
+    }
 }
 
 /**
- *  Pops a copy of the front message.   Could be a little inefficient, since a
- *  couple of copies are made, and we cannot use return-code optimization.
- *
- *  Perhaps at some point we could use move semantics?
+ *  Pops the front message into a midi_message, consumer side.  This can
+ *  allocate for a long message, so it is meant for the input thread, not a
+ *  process callback.
  *
  * \return
- *      Returns a copy of the message that was in front before the popping.
- *      If the queue is empty, an empty (all zeros) message is returned.
- *      Can be checked with the midi_message::empty() function.
+ *      Returns false if the ring was empty.
  */
 
-midi_message
-midi_queue::pop_front ()
+bool
+midi_ring::pop_front (midi_message & msg)
 {
-    midi_message result;
-    if (m_size != 0)
+    bool result = ! m_slots.empty();
+    if (result)
     {
-        result = m_ring[m_front];
-        pop();
+        const slot & s = m_slots.front();
+        std::size_t sz = std::size_t(s.m_count);
+        msg.timestamp(s.m_timestamp);
+        if (sz <= std::size_t(c_midi_message_inline))
+        {
+            msg.assign(&s.m_bytes[0], sz);
+        }
+        else
+        {
+            msg.clear();
+            for (std::size_t i = 0; i < sz; )
+            {
+                midibyte chunk[64];
+                std::size_t n = sz - i < sizeof chunk ? sz - i : sizeof chunk ;
+                (void) m_spill.read_block(chunk, n);
+                m_spill.read_skip(n);
+                for (std::size_t j = 0; j < n; ++j)
+                    msg.push(chunk[j]);
+
+                i += n;
+            }
+        }
+        m_slots.pop_front();
     }
     return result;
 }